@@ -2,13 +2,25 @@
 headers=(
 	'jukebox/Mixer/MixerImpl.h'
 	'jukebox/Mixer/Mixer.h'
+	'jukebox/Util/SampleConversion.h'
+	'jukebox/Util/ByteSource.h'
+	'jukebox/Util/FileSystem.h'
 	'jukebox/Decoders/DecoderImpl.h'
 	'jukebox/Decoders/Decoder.h'
 	'jukebox/Decoders/MIDIConfigurator.h'
 	'jukebox/FileFormats/SoundFileImpl.h'
 	'jukebox/FileFormats/SoundFile.h'
+	'jukebox/FileFormats/Playlist.h'
+	'jukebox/FileFormats/MediaScanner.h'
+	'jukebox/Util/Biquad.h'
+	'jukebox/Util/Halfband.h'
+	'jukebox/Util/Dynamics.h'
+	'jukebox/Util/AudioClock.h'
+	'jukebox/Util/EventScheduler.h'
 	'jukebox/Sound/SoundImpl.h'
 	'jukebox/Sound/Sound.h'
+	'jukebox/Sound/LoadBatch.h'
+	'jukebox/Sound/PCMDiskCache.h'
 	'jukebox/Sound/Factory.h'
 	'jukebox/Mixer/Factory.h'
 )
@@ -42,10 +54,14 @@ echo '/*
 #ifndef _LIBJUKEBOX_H
 #define _LIBJUKEBOX_H
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <istream>
 #include <functional>
+#include <future>
 #include <map>
 #include <mutex>
 #include <vector>
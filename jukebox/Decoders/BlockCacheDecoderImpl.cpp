@@ -0,0 +1,78 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <cstring>
+#include "BlockCacheDecoderImpl.h"
+#include "jukebox/FileFormats/SoundFileImpl.h"
+
+namespace jukebox {
+
+BlockCacheDecoderImpl::BlockCacheDecoderImpl(
+		SoundFileImpl& fileImpl,
+		BlockCache &cache,
+		DecoderImpl *decoder) :
+	DecoderImpl(fileImpl),
+	cache(cache),
+	decoder(decoder),
+	blockSize(blockFrames * fileImpl.getNumChannels() * (fileImpl.getBitsPerSample() >> 3)) {
+}
+
+int BlockCacheDecoderImpl::getSamples(char* buf, int pos, int len) {
+	if (cache.getCapacity() == 0)
+		return decoder->getSamples(buf, pos, len);
+
+	int done = 0;
+	while (done < len) {
+		auto index = (pos + done) / blockSize;
+		auto block = cache.get(index);
+		if (!block)
+			block = decode(index);
+
+		int offset = pos + done - index * blockSize;
+		if (offset >= (int)block->size())
+			break;
+
+		auto n = std::min(len - done, (int)block->size() - offset);
+		memcpy(buf + done, block->data() + offset, n);
+		done += n;
+		if (offset + n == (int)block->size() && (int)block->size() < blockSize)
+			break; // end of the stream
+	}
+	return done;
+}
+
+BlockCache::Block BlockCacheDecoderImpl::decode(int index) {
+	int pos = index * blockSize;
+	int len = std::max(0, std::min(blockSize, fileImpl.getDataSize() - pos));
+	std::vector<char> data(len);
+
+	int got = 0;
+	while (got < len) {
+		auto n = decoder->getSamples(data.data() + got, pos + got, len - got);
+		if (n <= 0)
+			break;
+		got += n;
+	}
+	data.resize(got);
+
+	auto block = std::make_shared<const std::vector<char>>(std::move(data));
+	if (got == len) // a short read may be an I/O error, don't keep it
+		cache.put(index, block);
+	return block;
+}
+
+} /* namespace jukebox */
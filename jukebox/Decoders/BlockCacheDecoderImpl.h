@@ -0,0 +1,49 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef JUKEBOX_DECODERS_BLOCKCACHEDECODERIMPL_H_
+#define JUKEBOX_DECODERS_BLOCKCACHEDECODERIMPL_H_
+
+#include <memory>
+#include "DecoderImpl.h"
+#include "jukebox/Util/BlockCache.h"
+
+namespace jukebox {
+
+/* Serves reads from the file's cache of decoded blocks, decoding the
+ * missing ones whole (with its own decoder), so random access and
+ * scrubbing over regions already decoded by any decoder of the file
+ * neither seek nor decode again.
+ */
+class BlockCacheDecoderImpl: public DecoderImpl {
+public:
+	BlockCacheDecoderImpl(SoundFileImpl &fileImpl, BlockCache &cache, DecoderImpl *decoder); // takes ownership
+	virtual ~BlockCacheDecoderImpl() = default;
+	int getSamples(char *buf, int pos, int len) override;
+
+	static constexpr int blockFrames = 4096;
+private:
+	BlockCache &cache;
+	std::unique_ptr<DecoderImpl> decoder;
+	int blockSize; // in bytes
+
+	BlockCache::Block decode(int index);
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_DECODERS_BLOCKCACHEDECODERIMPL_H_ */
@@ -14,9 +14,14 @@
  */
 
 #include <cmath>
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <vector>
 #include "Decoder.h"
 #include "jukebox/FileFormats/SoundFile.h"
 #include "jukebox/FileFormats/SoundFileImpl.h"
+#include "jukebox/Util/WorkerPool.h"
 
 namespace jukebox {
 
@@ -59,6 +64,73 @@ int Decoder::getSamples(char* buf, int pos, int len) {
 	return impl->getSamples(buf, pos, len);
 }
 
+/* Segments are whole multiples of the 4096 frame chunks each decoder
+ * reads, starting at pos, so every decode request is the one a serial
+ * reader using that chunk size (e.g. FileWriterSoundImpl) would make.
+ * This thread decodes the first segment with this decoder.
+ */
+int Decoder::getSamplesParallel(char *buf, int pos, int len) {
+	auto &pool = WorkerPool::getInstance();
+	int chunk = 4096 * impl->getBlockSize();
+
+	if (len % impl->getBlockSize() != 0)
+		throw std::runtime_error("invalid buffer size, should be block aligned.");
+
+	if (pos >= impl->getDataSize())
+		return -1;
+
+	len = std::min(len, impl->getDataSize() - pos);
+	auto decode = [chunk](DecoderImpl &decoder, char *buf, int pos, int len) {
+		int done = 0;
+		while (done < len) {
+			auto n = decoder.getSamples(buf + done, pos + done, std::min(chunk, len - done));
+			if (n <= 0)
+				break;
+			done += n;
+		}
+		return done;
+	};
+
+	int numChunks = (len + chunk - 1) / chunk;
+	int numSegments = std::min<int>(pool.size() + 1, numChunks);
+	// a worker waiting for the pool could deadlock it, it decodes alone
+	if (decorators > 0 || !soundFileImpl->exactSeek() || numSegments < 2 || WorkerPool::onWorker())
+		return decode(*impl, buf, pos, len);
+
+	int segmentSize = (numChunks + numSegments - 1) / numSegments * chunk;
+
+	std::vector<std::future<int>> segments;
+	for (int offset = segmentSize; offset < len; offset += segmentSize) {
+		auto size = std::min(segmentSize, len - offset);
+		segments.push_back(pool.submit([this, decode, buf, pos, offset, size]() {
+			std::unique_ptr<DecoderImpl> decoder(soundFileImpl->makeDecoder());
+			return decode(*decoder, buf + offset, pos + offset, size);
+		}));
+	}
+
+	int done = 0;
+	std::exception_ptr error;
+	try {
+		done = decode(*impl, buf, pos, segmentSize);
+	} catch (...) {
+		error = std::current_exception();
+	}
+	for (auto &segment : segments)
+		segment.wait(); // they write into buf
+	if (error)
+		std::rethrow_exception(error);
+
+	bool complete = done == segmentSize;
+	for (auto &segment : segments) {
+		auto n = segment.get();
+		if (complete) {
+			done += n;
+			complete = n == std::min(segmentSize, len - (done - n));
+		}
+	}
+	return done; // up to the first short segment, like a serial decode
+}
+
 short Decoder::getNumChannels() const {
 	return impl->getNumChannels();
 }
@@ -71,6 +143,10 @@ short Decoder::getBitsPerSample() const {
 	return impl->getBitsPerSample();
 }
 
+SampleFormat Decoder::getSampleFormat() const {
+	return impl->getSampleFormat();
+}
+
 int Decoder::getDataSize() const {
 	return impl->getDataSize();
 }
@@ -81,14 +157,33 @@ int Decoder::silenceLevel() const {
 
 Decoder &Decoder::peel() {
 	auto dec = impl->peel();
-	if (dec != nullptr)
+	if (dec != nullptr) {
 		impl.reset(dec);
+		++revision;
+		--decorators;
+	}
 	return *this;
 }
 
+int Decoder::getRevision() const {
+	return revision;
+}
+
+bool Decoder::decorated() const {
+	return decorators > 0;
+}
+
 int Decoder::getBlockSize() const {
 	return impl->getBlockSize();
 }
 
+size_t Decoder::getLoopStart() const {
+	return soundFileImpl->getLoopStart();
+}
+
+size_t Decoder::getLoopEnd() const {
+	return soundFileImpl->getLoopEnd();
+}
+
 }
 
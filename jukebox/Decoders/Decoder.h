@@ -31,11 +31,21 @@ public:
 	Decoder(Decoder &&) = default;
 	Decoder &operator=(Decoder &&) = default;
 	int getSamples(char *buf, int pos, int len);
+	/* same as getSamples(), for long ranges: when there are no decorators
+	 * and the file seeks exactly, segments are decoded concurrently, each
+	 * by its own decoder, on the shared worker pool. Called from a pool
+	 * worker (e.g. a loadFileAsync() callback or a LoadBatch job) it
+	 * decodes serially, as waiting for the pool there could deadlock it.
+	 */
+	int getSamplesParallel(char *buf, int pos, int len);
 	short getNumChannels() const;
 	int getSampleRate() const;
 	short getBitsPerSample() const;
+	SampleFormat getSampleFormat() const;
 	int getDataSize() const;
 	int getBlockSize() const;
+	size_t getLoopStart() const;
+	size_t getLoopEnd() const;
 	const std::string &getFilename() const;
 	double getDuration() const;
 	int silenceLevel() const;
@@ -44,10 +54,14 @@ public:
 	template<typename T, typename ...Params> // T's base class must derive from DecoderImpl
 	Decoder &wrap(Params&&... params) { // decorates current decoder
 		impl.reset(new T(impl.release(), std::forward<Params>(params)...));
+		++revision;
+		++decorators;
         return *this;
 	}
 
 	Decoder &peel();
+	int getRevision() const; // changes whenever the decorators do
+	bool decorated() const;
 private:
 	Decoder(std::shared_ptr<SoundFileImpl> soundFileImpl);
 	Decoder(const Decoder &) = delete;
@@ -55,6 +69,8 @@ private:
 
 	std::shared_ptr<SoundFileImpl> soundFileImpl;
 	std::unique_ptr<DecoderImpl> impl;
+	int revision = 0;
+	int decorators = 0;
 };
 
 } /* namespace socks */
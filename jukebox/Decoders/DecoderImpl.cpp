@@ -39,6 +39,10 @@ short DecoderImpl::getBitsPerSample() const {
 	return fileImpl.getBitsPerSample();
 }
 
+SampleFormat DecoderImpl::getSampleFormat() const {
+	return fileImpl.getSampleFormat();
+}
+
 int DecoderImpl::getDataSize() const {
 	return fileImpl.getDataSize();
 }
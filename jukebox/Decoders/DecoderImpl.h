@@ -16,6 +16,8 @@
 #ifndef JUKEBOX_DECODERS_DECODERIMPL_H_
 #define JUKEBOX_DECODERS_DECODERIMPL_H_
 
+#include "jukebox/Util/SampleConversion.h"
+
 namespace jukebox {
 
 class SoundFileImpl;
@@ -29,6 +31,7 @@ public:
 	virtual short getNumChannels() const;
 	virtual int getSampleRate() const;
 	virtual short getBitsPerSample() const;
+	virtual SampleFormat getSampleFormat() const;
 	virtual int getDataSize() const;
 	virtual int silenceLevel() const;
 	SoundFileImpl &getFileImpl() const;
@@ -0,0 +1,189 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "ConvolutionImpl.h"
+#include "jukebox/Decoders/Decoder.h"
+
+namespace jukebox {
+
+constexpr size_t ConvolutionImpl::partitionSize;
+
+// acc += a*b
+static void multiplyAdd(const std::complex<float> *a, const std::complex<float> *b, std::complex<float> *acc, size_t n) {
+	auto x = reinterpret_cast<const float *>(a);
+	auto y = reinterpret_cast<const float *>(b);
+	auto z = reinterpret_cast<float *>(acc);
+
+	for (size_t i = 0; i < 2*n; i += 2) {
+		z[i] += x[i]*y[i] - x[i + 1]*y[i + 1];
+		z[i + 1] += x[i]*y[i + 1] + x[i + 1]*y[i];
+	}
+}
+
+ConvolutionImpl::ConvolutionImpl(DecoderImpl *impl, SoundFile impulseResponse, float wet) :
+		DecoderImplDecorator(impl->getFileImpl(), impl),
+		wet(std::max(0.0f, std::min(wet, 1.0f))),
+		fft(2*partitionSize),
+		numBins(partitionSize + 1),
+		numPartitions(0),
+		channels(getNumChannels()),
+		output(2*partitionSize),
+		spectrum(numBins) {
+
+	loadImpulseResponse(impulseResponse);
+
+	for (size_t i = 0; i < channels.size(); ++i) {
+		auto &channel = channels[i];
+		channel.irSpectra = irSpectra[i % irSpectra.size()].data();
+		channel.inputSpectra.resize(numPartitions*numBins);
+		channel.tail.resize(numBins);
+		channel.window.resize(2*partitionSize);
+	}
+}
+
+void ConvolutionImpl::loadImpulseResponse(SoundFile &impulseResponse) {
+	Decoder decoder(impulseResponse);
+
+	if (decoder.getSampleRate() != getSampleRate())
+		throw std::runtime_error("impulse response sample rate doesn't match the sound's.");
+
+	std::vector<char> pcm(decoder.getDataSize());
+	int pos = 0, len, chunk = 4096*decoder.getBlockSize();
+	while (pos < (int)pcm.size() && (len = decoder.getSamples(pcm.data() + pos, pos, std::min<int>(chunk, pcm.size() - pos))) > 0)
+		pos += len;
+
+	size_t irChannels = decoder.getNumChannels();
+	size_t count = pos/sampleSize(decoder.getSampleFormat());
+	size_t frames = count/irChannels;
+	std::vector<float> ir(count);
+	convertSamples(pcm.data(), decoder.getSampleFormat(), ir.data(), SampleFormat::F32, count);
+
+	// scale to unit energy (on the loudest channel), so a single
+	// impulse passes the signal through unchanged.
+	double energy = 0;
+	for (size_t c = 0; c < irChannels; ++c) {
+		double e = 0;
+		for (size_t i = c; i < count; i += irChannels)
+			e += (double)ir[i]*ir[i];
+		energy = std::max(energy, e);
+	}
+	float scale = energy > 0 ? 1.0/std::sqrt(energy) : 0;
+
+	numPartitions = std::max((size_t)1, (frames + partitionSize - 1)/partitionSize);
+	irSpectra.resize(irChannels);
+	std::vector<float> block(2*partitionSize);
+	for (size_t c = 0; c < irChannels; ++c) {
+		irSpectra[c].resize(numPartitions*numBins);
+		for (size_t p = 0; p < numPartitions; ++p) {
+			std::fill(block.begin(), block.end(), 0);
+			for (size_t i = 0; i < partitionSize && p*partitionSize + i < frames; ++i)
+				block[i] = ir[(p*partitionSize + i)*irChannels + c]*scale;
+			fft.forward(block.data(), irSpectra[c].data() + p*numBins);
+		}
+	}
+}
+
+/*
+ * the spectrum of the current block (with whatever is missing of it
+ * still zeroed) goes to its slot in the ring, so once the block is
+ * complete it's already in place for the next blocks' tails.
+ */
+void ConvolutionImpl::convolve(size_t frames) {
+	auto numChannels = channels.size();
+
+	for (size_t offset = 0; offset < frames;) {
+		auto n = std::min(partitionSize - fill, frames - offset);
+
+		for (size_t c = 0; c < numChannels; ++c) {
+			auto &channel = channels[c];
+			float *in = channel.window.data() + partitionSize + fill;
+			float *sample = samples.data() + offset*numChannels + c;
+
+			for (size_t i = 0; i < n; ++i)
+				in[i] = sample[i*numChannels];
+
+			auto inputSpectrum = channel.inputSpectra.data() + current*numBins;
+			fft.forward(channel.window.data(), inputSpectrum);
+			std::copy(channel.tail.begin(), channel.tail.end(), spectrum.begin());
+			multiplyAdd(inputSpectrum, channel.irSpectra, spectrum.data(), numBins);
+			fft.inverse(spectrum.data(), output.data());
+
+			const float *out = output.data() + partitionSize + fill;
+			for (size_t i = 0; i < n; ++i)
+				sample[i*numChannels] += (out[i] - sample[i*numChannels])*wet;
+		}
+
+		offset += n;
+		fill += n;
+		if (fill == partitionSize)
+			nextBlock();
+	}
+}
+
+void ConvolutionImpl::nextBlock() {
+	fill = 0;
+	current = (current + 1) % numPartitions;
+
+	for (auto &channel: channels) {
+		auto &window = channel.window;
+		std::copy(window.begin() + partitionSize, window.end(), window.begin());
+		std::fill(window.begin() + partitionSize, window.end(), 0);
+
+		// previous blocks' spectra times the IR partitions they're aligned with
+		std::fill(channel.tail.begin(), channel.tail.end(), 0);
+		for (size_t p = 1; p < numPartitions; ++p) {
+			auto slot = (current + numPartitions - p) % numPartitions;
+			multiplyAdd(
+				channel.inputSpectra.data() + slot*numBins,
+				channel.irSpectra + p*numBins,
+				channel.tail.data(), numBins);
+		}
+	}
+}
+
+void ConvolutionImpl::clear() {
+	fill = current = 0;
+	for (auto &channel: channels) {
+		std::fill(channel.inputSpectra.begin(), channel.inputSpectra.end(), 0);
+		std::fill(channel.tail.begin(), channel.tail.end(), 0);
+		std::fill(channel.window.begin(), channel.window.end(), 0);
+	}
+}
+
+int ConvolutionImpl::getSamples(char *buf, int pos, int len) {
+	auto ret = impl->getSamples(buf, pos, len);
+
+	if (pos == 0) // start over when playing begins
+		clear();
+
+	if (ret > 0) {
+		auto format = getSampleFormat();
+		size_t count = ret/sampleSize(format);
+
+		samples.resize(count);
+		convertSamples(buf, format, samples.data(), SampleFormat::F32, count);
+		convolve(count/channels.size());
+		convertSamples(samples.data(), SampleFormat::F32, buf, format, count);
+	}
+
+	return ret;
+}
+
+} /* namespace jukebox */
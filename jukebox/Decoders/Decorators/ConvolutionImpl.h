@@ -0,0 +1,72 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef JUKEBOX_DECODERS_DECORATORS_CONVOLUTIONIMPL_H_
+#define JUKEBOX_DECODERS_DECORATORS_CONVOLUTIONIMPL_H_
+
+#include <complex>
+#include <vector>
+#include "DecoderImplDecorator.h"
+#include "jukebox/FileFormats/SoundFile.h"
+#include "jukebox/Util/FFT.h"
+
+namespace jukebox {
+
+/*
+ * Convolution with an impulse response (e.g. a recorded room), using
+ * uniformly partitioned overlap-save FFT convolution: the IR is split in
+ * blocks of partitionSize frames and each block of input costs one FFT,
+ * one inverse FFT and a spectral multiply-add per partition, no matter
+ * how long the IR is. There's no added latency, a partially filled block
+ * is convolved with what's available of it.
+ *
+ * The IR must have the sound's sample rate; a mono IR is applied to every
+ * channel, otherwise channel n uses IR channel n (modulo the IR's channels).
+ * wet is the fraction of the convolved signal in the output (0.0 - 1.0).
+ */
+class ConvolutionImpl: public DecoderImplDecorator {
+public:
+	ConvolutionImpl(DecoderImpl *impl, SoundFile impulseResponse, float wet);
+	virtual ~ConvolutionImpl() = default;
+	int getSamples(char *buf, int pos, int len) override;
+
+	static constexpr size_t partitionSize = 512;
+private:
+	struct Channel {
+		const std::complex<float> *irSpectra; // numPartitions spectra of this channel's IR
+		std::vector<std::complex<float> > inputSpectra; // ring of the last numPartitions input spectra
+		std::vector<std::complex<float> > tail; // contribution of the previous blocks to the current one
+		std::vector<float> window; // [previous block | current block]
+	};
+
+	float wet;
+	FFT fft;
+	size_t numBins, numPartitions;
+	size_t fill = 0, current = 0; // frames in the current block, its slot in inputSpectra
+	std::vector<std::vector<std::complex<float> > > irSpectra;
+	std::vector<Channel> channels;
+	std::vector<float> samples, output;
+	std::vector<std::complex<float> > spectrum;
+
+	void loadImpulseResponse(SoundFile &impulseResponse);
+	void convolve(size_t frames);
+	void nextBlock();
+	void clear();
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_DECODERS_DECORATORS_CONVOLUTIONIMPL_H_ */
@@ -29,6 +29,10 @@ short DecoderImplDecorator::getBitsPerSample() const {
 	return impl->getBitsPerSample();
 }
 
+SampleFormat DecoderImplDecorator::getSampleFormat() const {
+	return impl->getSampleFormat();
+}
+
 int DecoderImplDecorator::getDataSize() const {
 	return impl->getDataSize();
 }
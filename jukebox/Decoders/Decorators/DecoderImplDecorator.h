@@ -21,6 +21,7 @@ public:
 	short getNumChannels() const override;
 	int getSampleRate() const override;
 	short getBitsPerSample() const override;
+	SampleFormat getSampleFormat() const override;
 	int getDataSize() const override;
 	int silenceLevel() const override;
 	DecoderImpl *peel() override;
@@ -13,43 +13,140 @@
     along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <limits>
+#include <algorithm>
 #include <cmath>
+#include <stdexcept>
 #include "DistortionImpl.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JUKEBOX_DISTORTION_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace jukebox {
 
-std::unordered_map<int, decltype(DistortionImpl::distortion)> DistortionImpl::distortionFunc = {
-	{ 8, DistortionImpl::_distortion<uint8_t>},
-	{16, DistortionImpl::_distortion<int16_t>},
-	{32, DistortionImpl::_distortion<int32_t>}
-};
+namespace {
+
+/* [7/6] Pade approximant of tanh: exact to float precision for |x| < 1,
+ * within 1e-4 of it up to |x| = clipAt, where it reaches 1.0 and is
+ * clipped from there on.
+ */
+constexpr float clipAt = 4.97f;
+
+/* once band limited by the downsampling filter, a heavily clipped
+ * waveform overshoots full scale (up to 4/pi, when only the fundamental
+ * of a square wave is left); clipping that when converting back would
+ * alias all over again. Only oversampling needs it, 1x keeps the level
+ * of tanh(gain*x)/tanh(gain).
+ */
+constexpr float oversamplingHeadroom = 0.785f; // pi/4, about -2dB
+
+inline float fastTanh(float x) {
+	x = std::max(-clipAt, std::min(x, clipAt));
+	float x2 = x*x;
+	float num = x*(135135.0f + x2*(17325.0f + x2*(378.0f + x2)));
+	float den = 135135.0f + x2*(62370.0f + x2*(3150.0f + x2*28.0f));
+	return std::max(-1.0f, std::min(num/den, 1.0f));
+}
 
-DistortionImpl::DistortionImpl(DecoderImpl* impl, float gain) :
+#ifdef JUKEBOX_DISTORTION_SSE2
+inline __m128 fastTanh(__m128 x) {
+	auto one = _mm_set1_ps(1.0f), clip = _mm_set1_ps(clipAt);
+	x = _mm_max_ps(_mm_sub_ps(_mm_setzero_ps(), clip), _mm_min_ps(x, clip));
+	auto x2 = _mm_mul_ps(x, x);
+	auto num = _mm_add_ps(_mm_set1_ps(378.0f), x2);
+	num = _mm_add_ps(_mm_set1_ps(17325.0f), _mm_mul_ps(x2, num));
+	num = _mm_add_ps(_mm_set1_ps(135135.0f), _mm_mul_ps(x2, num));
+	num = _mm_mul_ps(x, num);
+	auto den = _mm_add_ps(_mm_set1_ps(3150.0f), _mm_mul_ps(x2, _mm_set1_ps(28.0f)));
+	den = _mm_add_ps(_mm_set1_ps(62370.0f), _mm_mul_ps(x2, den));
+	den = _mm_add_ps(_mm_set1_ps(135135.0f), _mm_mul_ps(x2, den));
+	auto y = _mm_div_ps(num, den);
+	return _mm_max_ps(_mm_sub_ps(_mm_setzero_ps(), one), _mm_min_ps(y, one));
+}
+#endif
+
+}
+
+DistortionImpl::DistortionImpl(DecoderImpl* impl, float gain, int oversampling) :
 	DecoderImplDecorator(impl->getFileImpl(), impl),
-	gain(gain) {
+	gain(gain != 0 ? gain : 1e-4f), // tanh(g*x)/tanh(g) -> x as g -> 0
+	scale((oversampling > 1 ? oversamplingHeadroom : 1.0f)/std::tanh(this->gain)), // constant, divide once
+	oversampling(oversampling) {
+
+	if (oversampling != 1 && oversampling != 2 && oversampling != 4)
+		throw std::runtime_error("distortion oversampling must be 1, 2 or 4.");
 
-	distortion = distortionFunc[impl->getBitsPerSample()];
+	// the 2x to 4x stage only has to keep the first one's band clean
+	std::vector<Halfband> stages(1);
+	if (oversampling == 4)
+		stages.emplace_back(Halfband::Response::wide);
+	filters.resize(getNumChannels(), oversampling > 1 ? stages : std::vector<Halfband>());
 }
 
-int DistortionImpl::getSamples(char* buf, int pos, int len) {
-	auto ret = impl->getSamples(buf, pos, len);
-	distortion(buf, len, impl->silenceLevel(), gain);
-	return ret;
+void DistortionImpl::shape(float *buf, size_t count) {
+	size_t i = 0;
+
+#ifdef JUKEBOX_DISTORTION_SSE2
+	auto g = _mm_set1_ps(gain), s = _mm_set1_ps(scale);
+	for (; i + 4 <= count; i += 4)
+		_mm_storeu_ps(buf + i, _mm_mul_ps(fastTanh(_mm_mul_ps(_mm_loadu_ps(buf + i), g)), s));
+#endif
+
+	for (; i < count; ++i)
+		buf[i] = fastTanh(buf[i]*gain)*scale;
+}
+
+// each channel goes up one 2x stage at a time, is shaped, and comes back down
+void DistortionImpl::shapeOversampled(size_t frames) {
+	auto numChannels = filters.size();
+
+	channel.resize(frames);
+	upsampled.resize(2*frames);
+	upsampled4x.resize(oversampling == 4 ? 4*frames : 0);
+
+	for (size_t c = 0; c < numChannels; ++c) {
+		auto &stages = filters[c];
+
+		for (size_t i = 0; i < frames; ++i)
+			channel[i] = samples[i*numChannels + c];
+
+		stages[0].upsample(channel.data(), upsampled.data(), frames);
+		if (stages.size() > 1) {
+			stages[1].upsample(upsampled.data(), upsampled4x.data(), 2*frames);
+			shape(upsampled4x.data(), 4*frames);
+			stages[1].downsample(upsampled4x.data(), upsampled.data(), 2*frames);
+		} else
+			shape(upsampled.data(), 2*frames);
+		stages[0].downsample(upsampled.data(), channel.data(), frames);
+
+		for (size_t i = 0; i < frames; ++i)
+			samples[i*numChannels + c] = channel[i];
+	}
 }
 
-template<class T>
-inline void DistortionImpl::_distortion(void* buf, int len, int offset, float gain) {
-	auto beginIt = reinterpret_cast<T *>(buf);
-	auto endIt = beginIt + len/(sizeof(T));
+int DistortionImpl::getSamples(char* buf, int pos, int len) {
+	auto ret = impl->getSamples(buf, pos, len);
 
-	for (auto sample = beginIt; sample != endIt; ++sample) {
-		float signedSample = (float)(*sample - offset) / (float)std::numeric_limits<T>::max();
+	if (pos == 0)
+		for (auto &stages: filters)
+			for (auto &stage: stages)
+				stage.reset();
 
-		signedSample = std::tanh(gain*signedSample)/std::tanh(gain);
+	if (ret > 0) {
+		auto format = getSampleFormat();
+		size_t count = ret/sampleSize(format);
 
-		*sample = (signedSample * (float)std::numeric_limits<T>::max()) + offset;
+		samples.resize(count);
+		convertSamples(buf, format, samples.data(), SampleFormat::F32, count);
+		if (oversampling > 1)
+			shapeOversampled(count/filters.size());
+		else
+			shape(samples.data(), count);
+		convertSamples(samples.data(), SampleFormat::F32, buf, format, count);
 	}
+
+	return ret;
 }
 
 } /* namespace jukebox */
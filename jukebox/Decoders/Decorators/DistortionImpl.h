@@ -17,25 +17,34 @@
 #define JUKEBOX_DECODERS_DECORATORS_DISTORTIONIMPL_H_
 
 #include <memory>
-#include <functional>
-#include <unordered_map>
+#include <vector>
 #include "../DecoderImpl.h"
 #include "DecoderImplDecorator.h"
+#include "jukebox/Util/Halfband.h"
 
 namespace jukebox {
 
+/*
+ * tanh(gain*x)/tanh(gain) waveshaper. oversampling (1, 2 or 4) runs the
+ * shaper at a multiple of the sample rate, with halfband filters around
+ * it, so the harmonics of high gains don't alias back into the audible
+ * band. Oversampled output is about 2dB quieter than 1x: once band
+ * limited, a heavily clipped waveform overshoots full scale (up to 4/pi)
+ * and is scaled by pi/4 so converting it back doesn't clip.
+ */
 class DistortionImpl: public DecoderImplDecorator {
 public:
-	DistortionImpl(DecoderImpl *impl, float gain);
+	DistortionImpl(DecoderImpl *impl, float gain, int oversampling = 1);
 	virtual ~DistortionImpl() = default;
 	int getSamples(char* buf, int pos, int len) override;
 private:
-	float gain;
-	std::function<void(void *, int, int, float)> distortion;
-	static std::unordered_map<int, decltype(distortion)> distortionFunc;
+	float gain, scale;
+	int oversampling;
+	std::vector<std::vector<Halfband> > filters; // [channel][stage]
+	std::vector<float> samples, channel, upsampled, upsampled4x;
 
-	template<class T>
-	static void _distortion(void *buf, int len, int offset, float gain);
+	void shape(float *buf, size_t count);
+	void shapeOversampled(size_t frames);
 };
 
 } /* namespace jukebox */
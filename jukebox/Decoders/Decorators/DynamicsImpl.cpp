@@ -0,0 +1,62 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+
+#include "DynamicsImpl.h"
+
+namespace jukebox {
+
+DynamicsImpl::DynamicsImpl(DecoderImpl *impl, const Dynamics::Settings &settings) :
+		DecoderImplDecorator(impl->getFileImpl(), impl),
+		dynamics(getSampleRate(), getNumChannels(), settings) {
+}
+
+int DynamicsImpl::getSamples(char *buf, int pos, int len) {
+	int latency = dynamics.getLatency()*getBlockSize();
+
+	if (pos != next) {
+		dynamics.reset();
+		preRoll.resize(latency);
+		auto n = std::max(0, impl->getSamples(preRoll.data(), pos, latency));
+		std::fill(preRoll.begin() + n, preRoll.end(), silenceLevel());
+		process(preRoll.data(), latency);
+	}
+
+	// the input runs 'latency' bytes ahead, what it lacks at the end is flushed as silence
+	auto ret = impl->getSamples(buf, pos + latency, len);
+	auto end = ret < len ? std::min(pos + latency + std::max(ret, 0), getDataSize()) : pos + latency + ret;
+	auto out = std::min(len, end - pos);
+	if (out <= 0)
+		return ret;
+
+	std::fill(buf + std::max(ret, 0), buf + out, silenceLevel());
+	process(buf, out);
+	next = pos + out;
+	return out;
+}
+
+void DynamicsImpl::process(char *buf, int len) {
+	auto format = getSampleFormat();
+	size_t count = len/sampleSize(format);
+
+	samples.resize(count);
+	convertSamples(buf, format, samples.data(), SampleFormat::F32, count);
+	dynamics.process(samples.data(), count/getNumChannels());
+	convertSamples(samples.data(), SampleFormat::F32, buf, format, count);
+}
+
+} /* namespace jukebox */
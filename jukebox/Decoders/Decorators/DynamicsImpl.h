@@ -0,0 +1,50 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef JUKEBOX_DECODERS_DECORATORS_DYNAMICSIMPL_H_
+#define JUKEBOX_DECODERS_DECORATORS_DYNAMICSIMPL_H_
+
+#include <vector>
+#include "DecoderImplDecorator.h"
+#include "jukebox/Util/Dynamics.h"
+
+namespace jukebox {
+
+/*
+ * Compressor + lookahead limiter (see Dynamics). The limiter's lookahead
+ * delays its output, so the decoder below is read that far ahead of pos:
+ * the output stays aligned with the position (events, stopAt, loops),
+ * and the delay line is flushed with silence past the end of the data.
+ * A read that doesn't follow the previous one (a seek, a loop wrap)
+ * starts over, pre-rolling the lookahead from the new position.
+ */
+class DynamicsImpl: public DecoderImplDecorator {
+public:
+	DynamicsImpl(DecoderImpl *impl, const Dynamics::Settings &settings);
+	virtual ~DynamicsImpl() = default;
+	int getSamples(char *buf, int pos, int len) override;
+private:
+	Dynamics dynamics;
+	std::vector<float> samples;
+	std::vector<char> preRoll;
+	int next = -1; // pos following the last read
+
+	void process(char *buf, int len);
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_DECODERS_DECORATORS_DYNAMICSIMPL_H_ */
@@ -14,18 +14,23 @@
  */
 
 #include "FadeImpl.h"
+#include "jukebox/Util/SampleTypes.h"
 
 namespace jukebox {
 
-std::unordered_map<short, decltype(FadeImpl::fadeIn)> FadeImpl::fadeInFunc = {
-		{ 8, &FadeImpl::_fadeIn<uint8_t>},
-		{16, &FadeImpl::_fadeIn<int16_t>},
-		{32, &FadeImpl::_fadeIn<int32_t>},
+std::unordered_map<SampleFormat, decltype(FadeImpl::fadeIn)> FadeImpl::fadeInFunc = {
+		{SampleFormat::U8,  &FadeImpl::_fadeIn<uint8_t>},
+		{SampleFormat::S16, &FadeImpl::_fadeIn<int16_t>},
+		{SampleFormat::S24, &FadeImpl::_fadeIn<Int24>},
+		{SampleFormat::S32, &FadeImpl::_fadeIn<int32_t>},
+		{SampleFormat::F32, &FadeImpl::_fadeIn<float>},
 };
-std::unordered_map<short, decltype(FadeImpl::fadeOut)> FadeImpl::fadeOutFunc = {
-		{ 8, &FadeImpl::_fadeOut<uint8_t>},
-		{16, &FadeImpl::_fadeOut<int16_t>},
-		{32, &FadeImpl::_fadeOut<int32_t>},
+std::unordered_map<SampleFormat, decltype(FadeImpl::fadeOut)> FadeImpl::fadeOutFunc = {
+		{SampleFormat::U8,  &FadeImpl::_fadeOut<uint8_t>},
+		{SampleFormat::S16, &FadeImpl::_fadeOut<int16_t>},
+		{SampleFormat::S24, &FadeImpl::_fadeOut<Int24>},
+		{SampleFormat::S32, &FadeImpl::_fadeOut<int32_t>},
+		{SampleFormat::F32, &FadeImpl::_fadeOut<float>},
 };
 
 
@@ -82,8 +87,8 @@ FadeImpl::FadeImpl(
 				(getBitsPerSample() >> 3)*
 				fadeOutSecs, getDataSize());
 
-	fadeIn = fadeInFunc[getBitsPerSample()];
-	fadeOut = fadeOutFunc[getBitsPerSample()];
+	fadeIn = fadeInFunc[getSampleFormat()];
+	fadeOut = fadeOutFunc[getSampleFormat()];
 }
 
 int jukebox::FadeImpl::getSamples(char* buf, int pos, int len) {
@@ -35,8 +35,8 @@ private:
 	int fadeInEndPos, fadeOutStartPos;
 	std::function<void(FadeImpl&, void *, int, int)> fadeIn;
 	std::function<void(FadeImpl&, void *, int, int)> fadeOut;
-	static std::unordered_map<short, decltype(fadeIn)> fadeInFunc;
-	static std::unordered_map<short, decltype(fadeOut)> fadeOutFunc;
+	static std::unordered_map<SampleFormat, decltype(fadeIn)> fadeInFunc;
+	static std::unordered_map<SampleFormat, decltype(fadeOut)> fadeOutFunc;
 
 	template<typename T>
 	static void _fadeIn(FadeImpl &self, void* buf, int pos, int len);
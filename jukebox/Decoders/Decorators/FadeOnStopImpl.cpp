@@ -14,6 +14,7 @@
  */
 
 #include "FadeOnStopImpl.h"
+#include "jukebox/Util/SampleTypes.h"
 
 #include "jukebox/FileFormats/SoundFileImpl.h"
 
@@ -38,10 +39,12 @@ void FadeOnStopImpl::_fadeOut(FadeOnStopImpl& self, void *buf, int pos, int len)
 	});
 };
 
-std::unordered_map<short, decltype(FadeOnStopImpl::fadeOut)> FadeOnStopImpl::fadeOutFunc = {
-		{8 , &FadeOnStopImpl::_fadeOut<uint8_t>},
-		{16, &FadeOnStopImpl::_fadeOut<int16_t>},
-		{32, &FadeOnStopImpl::_fadeOut<int32_t>}
+std::unordered_map<SampleFormat, decltype(FadeOnStopImpl::fadeOut)> FadeOnStopImpl::fadeOutFunc = {
+		{SampleFormat::U8 , &FadeOnStopImpl::_fadeOut<uint8_t>},
+		{SampleFormat::S16, &FadeOnStopImpl::_fadeOut<int16_t>},
+		{SampleFormat::S24, &FadeOnStopImpl::_fadeOut<Int24>},
+		{SampleFormat::S32, &FadeOnStopImpl::_fadeOut<int32_t>},
+		{SampleFormat::F32, &FadeOnStopImpl::_fadeOut<float>}
 };
 
 FadeOnStopImpl::FadeOnStopImpl(DecoderImpl *impl, int fadeOutSecs, int fadeOutStartPos) :
@@ -55,7 +58,7 @@ FadeOnStopImpl::FadeOnStopImpl(DecoderImpl *impl, int fadeOutSecs, int fadeOutSt
 			(getBitsPerSample() >> 3)*
 			fadeOutSecs)),
 		fade(fadeOutStopPos < impl->getDataSize()), // do not fade at all if fading goes beyond EOF
-		fadeOut(fadeOutFunc[getBitsPerSample()]) {
+		fadeOut(fadeOutFunc[getSampleFormat()]) {
 }
 
 int FadeOnStopImpl::getDataSize() const {
@@ -36,7 +36,7 @@ private:
 	int fadeOutSecs, fadeOutStartPos, fadeOutStopPos;
 	bool fade = false;
 	std::function<void(FadeOnStopImpl&, void *, int, int)> fadeOut;
-	static std::unordered_map<short, decltype(fadeOut)> fadeOutFunc;
+	static std::unordered_map<SampleFormat, decltype(fadeOut)> fadeOutFunc;
 
 	template<typename T>
 	static void _fadeOut(FadeOnStopImpl& self, void *buf, int pos, int len);
@@ -0,0 +1,213 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+
+#include "FilterImpl.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JUKEBOX_FILTER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace jukebox {
+
+namespace {
+
+constexpr size_t lanes = 4; // channels filtered together
+constexpr size_t stateSize = 2*lanes; // z1 and z2, per band and group of channels
+
+#ifdef JUKEBOX_FILTER_SSE2
+
+inline __m128 loadFrame(const float *frame, size_t channels) {
+	switch (channels) {
+	case 1: return _mm_load_ss(frame);
+	case 2: return _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double *>(frame)));
+	case 4: return _mm_loadu_ps(frame);
+	default:
+		float tmp[lanes] = {0};
+		std::copy(frame, frame + channels, tmp);
+		return _mm_loadu_ps(tmp);
+	}
+}
+
+inline void storeFrame(float *frame, __m128 v, size_t channels) {
+	switch (channels) {
+	case 1: _mm_store_ss(frame, v); break;
+	case 2: _mm_store_sd(reinterpret_cast<double *>(frame), _mm_castps_pd(v)); break;
+	case 4: _mm_storeu_ps(frame, v); break;
+	default:
+		float tmp[lanes];
+		_mm_storeu_ps(tmp, v);
+		std::copy(tmp, tmp + channels, frame);
+	}
+}
+
+/*
+ * one band over the whole block, for up to 4 (interleaved) channels;
+ * coefficients and state stay in registers.
+ */
+template<bool ramp>
+void filterBand(float *buf, size_t frames, size_t stride, size_t channels,
+		const Biquad &from, const Biquad &to, float *z) {
+	auto b0 = _mm_set1_ps(from.b0), b1 = _mm_set1_ps(from.b1), b2 = _mm_set1_ps(from.b2);
+	auto a1 = _mm_set1_ps(from.a1), a2 = _mm_set1_ps(from.a2);
+	auto z1 = _mm_loadu_ps(z), z2 = _mm_loadu_ps(z + lanes);
+	__m128 db0, db1, db2, da1, da2;
+
+	if (ramp) {
+		float step = 1.0f/frames;
+		db0 = _mm_set1_ps((to.b0 - from.b0)*step);
+		db1 = _mm_set1_ps((to.b1 - from.b1)*step);
+		db2 = _mm_set1_ps((to.b2 - from.b2)*step);
+		da1 = _mm_set1_ps((to.a1 - from.a1)*step);
+		da2 = _mm_set1_ps((to.a2 - from.a2)*step);
+	}
+
+	for (size_t i = 0; i < frames; ++i, buf += stride) {
+		if (ramp) {
+			b0 = _mm_add_ps(b0, db0); b1 = _mm_add_ps(b1, db1); b2 = _mm_add_ps(b2, db2);
+			a1 = _mm_add_ps(a1, da1); a2 = _mm_add_ps(a2, da2);
+		}
+		auto x = loadFrame(buf, channels);
+		auto y = _mm_add_ps(_mm_mul_ps(b0, x), z1);
+		z1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, x), _mm_mul_ps(a1, y)), z2);
+		z2 = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+		storeFrame(buf, y, channels);
+	}
+
+	_mm_storeu_ps(z, z1);
+	_mm_storeu_ps(z + lanes, z2);
+}
+
+#else
+
+template<bool ramp>
+void filterBand(float *buf, size_t frames, size_t stride, size_t channels,
+		const Biquad &from, const Biquad &to, float *z) {
+	float step = ramp ? 1.0f/frames : 0;
+
+	for (size_t c = 0; c < channels; ++c) {
+		float b0 = from.b0, b1 = from.b1, b2 = from.b2, a1 = from.a1, a2 = from.a2;
+		float z1 = z[c], z2 = z[lanes + c];
+		float *sample = buf + c;
+
+		for (size_t i = 0; i < frames; ++i, sample += stride) {
+			if (ramp) {
+				b0 += (to.b0 - from.b0)*step; b1 += (to.b1 - from.b1)*step; b2 += (to.b2 - from.b2)*step;
+				a1 += (to.a1 - from.a1)*step; a2 += (to.a2 - from.a2)*step;
+			}
+			float x = *sample;
+			float y = b0*x + z1;
+			z1 = b1*x - a1*y + z2;
+			z2 = b2*x - a2*y;
+			*sample = y;
+		}
+		z[c] = z1;
+		z[lanes + c] = z2;
+	}
+}
+
+#endif
+
+}
+
+FilterImpl::FilterImpl(DecoderImpl *impl, std::shared_ptr<FilterBank> bank) :
+		DecoderImplDecorator(impl->getFileImpl(), impl),
+		bank(bank),
+		version(bank->getVersion() - 1) {
+
+	update();
+	current = target; // nothing to ramp from yet
+}
+
+/*
+ * new bands start out as pass-through (the default Biquad) and are
+ * ramped in like any other change.
+ */
+bool FilterImpl::update() {
+	auto v = bank->getVersion();
+	if (v == version)
+		return false;
+
+	version = v;
+	auto bands = bank->getBands();
+	target.resize(bands.size());
+	for (size_t i = 0; i < bands.size(); ++i)
+		target[i] = Biquad::design(bands[i].type, bands[i].frequency,
+			bands[i].q, bands[i].gainDb, getSampleRate());
+
+	size_t groups = (getNumChannels() + lanes - 1)/lanes;
+	current.resize(target.size());
+	state.resize(target.size()*groups*stateSize, 0);
+	return true;
+}
+
+void FilterImpl::filter(size_t frames, bool ramp) {
+	size_t numChannels = getNumChannels();
+	float *z = state.data();
+
+#ifdef JUKEBOX_FILTER_SSE2
+	auto csr = _mm_getcsr();
+	_mm_setcsr(csr | 0x8040); // flush denormals to zero, decaying IIR tails would produce them
+#endif
+
+	for (size_t group = 0; group < numChannels; group += lanes) {
+		auto channels = std::min(lanes, numChannels - group);
+		for (size_t band = 0; band < target.size(); ++band, z += stateSize) {
+			if (ramp)
+				filterBand<true>(samples.data() + group, frames, numChannels, channels, current[band], target[band], z);
+			else
+				filterBand<false>(samples.data() + group, frames, numChannels, channels, current[band], target[band], z);
+		}
+	}
+
+#ifdef JUKEBOX_FILTER_SSE2
+	_mm_setcsr(csr);
+#endif
+
+	current = target;
+}
+
+void FilterImpl::clear() {
+	std::fill(state.begin(), state.end(), 0);
+}
+
+int FilterImpl::getSamples(char *buf, int pos, int len) {
+	auto ret = impl->getSamples(buf, pos, len);
+	if (ret <= 0)
+		return ret; // a bank change waits for a block to ramp across
+
+	if (pos != next) // a seek or loop wrap, the state belongs to other samples
+		clear();
+	next = pos + ret;
+
+	auto ramp = update();
+
+	if (!target.empty()) {
+		auto format = getSampleFormat();
+		size_t count = ret/sampleSize(format);
+
+		samples.resize(count);
+		convertSamples(buf, format, samples.data(), SampleFormat::F32, count);
+		filter(count/getNumChannels(), ramp);
+		convertSamples(samples.data(), SampleFormat::F32, buf, format, count);
+	}
+
+	return ret;
+}
+
+} /* namespace jukebox */
@@ -0,0 +1,54 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef JUKEBOX_DECODERS_DECORATORS_FILTERIMPL_H_
+#define JUKEBOX_DECODERS_DECORATORS_FILTERIMPL_H_
+
+#include <memory>
+#include <vector>
+#include "DecoderImplDecorator.h"
+#include "jukebox/Util/Biquad.h"
+
+namespace jukebox {
+
+/*
+ * Cascade of biquads (one per FilterBank band), in transposed direct
+ * form II. Up to 4 channels are filtered at once, one per SSE lane, so a
+ * stereo voice costs the same as a mono one. When the bank changes, the
+ * coefficients are ramped to the new ones across the next block. The
+ * state is cleared whenever a read doesn't follow the previous one.
+ */
+class FilterImpl: public DecoderImplDecorator {
+public:
+	FilterImpl(DecoderImpl *impl, std::shared_ptr<FilterBank> bank);
+	virtual ~FilterImpl() = default;
+	int getSamples(char *buf, int pos, int len) override;
+private:
+	std::shared_ptr<FilterBank> bank;
+	unsigned version;
+	std::vector<Biquad> current, target; // one per band
+	std::vector<float> state; // z1 and z2 of each band, 4 channels at a time
+	std::vector<float> samples;
+	int next = -1; // pos following the last read
+
+	bool update();
+	void filter(size_t frames, bool ramp);
+	void clear();
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_DECODERS_DECORATORS_FILTERIMPL_H_ */
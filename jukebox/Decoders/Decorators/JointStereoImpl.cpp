@@ -14,20 +14,23 @@
  */
 
 #include "JointStereoImpl.h"
+#include "jukebox/Util/SampleTypes.h"
 
 namespace jukebox {
 
-std::unordered_map<int, decltype(JointStereoImpl::mixChannels)>
+std::unordered_map<SampleFormat, decltype(JointStereoImpl::mixChannels)>
 JointStereoImpl::mixChannelsFunc = {
-			{8, JointStereoImpl::_mixChannels<uint8_t>},
-			{16, JointStereoImpl::_mixChannels<int16_t>},
-			{32, JointStereoImpl::_mixChannels<int32_t>}
+			{SampleFormat::U8, JointStereoImpl::_mixChannels<uint8_t>},
+			{SampleFormat::S16, JointStereoImpl::_mixChannels<int16_t>},
+			{SampleFormat::S24, JointStereoImpl::_mixChannels<Int24>},
+			{SampleFormat::S32, JointStereoImpl::_mixChannels<int32_t>},
+			{SampleFormat::F32, JointStereoImpl::_mixChannels<float>}
 	};
 
 JointStereoImpl::JointStereoImpl(DecoderImpl *impl) :
 		DecoderImplDecorator(impl->getFileImpl(), impl) {
 
-	mixChannels = mixChannelsFunc[impl->getBitsPerSample()];
+	mixChannels = mixChannelsFunc[impl->getSampleFormat()];
 }
 
 template <typename T>
@@ -39,7 +42,7 @@ void JointStereoImpl::_mixChannels(void *input, void *output, int len) {
 	for (auto it = beginIt; it != endIt; it += 2, ++outp) {
 		auto left = it;
 		auto right = ++left;
-		double mix = ((int64_t)*left + (int64_t)*right);
+		double mix = ((double)*left + (double)*right);
 		*outp =  mix / 2;
 	}
 }
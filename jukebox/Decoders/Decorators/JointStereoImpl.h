@@ -32,7 +32,7 @@ public:
 	int getBlockSize() const override;
 private:
 	std::function<void(void *, void *, int)> mixChannels;
-	static std::unordered_map<int, decltype(mixChannels)> mixChannelsFunc;
+	static std::unordered_map<SampleFormat, decltype(mixChannels)> mixChannelsFunc;
 
 	template <typename T>
 	static void _mixChannels(void *input, void *output, int len);
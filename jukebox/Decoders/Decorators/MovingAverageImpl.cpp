@@ -16,26 +16,31 @@
 #include <iostream>
 #include <algorithm>
 #include "MovingAverageImpl.h"
+#include "jukebox/Util/SampleTypes.h"
 
 namespace jukebox {
 
-std::vector<std::unordered_map<int, decltype(MovingAverageImpl::movingAverage)>> MovingAverageImpl::movingAverageFunc = {
+std::vector<std::unordered_map<SampleFormat, decltype(MovingAverageImpl::movingAverage)>> MovingAverageImpl::movingAverageFunc = {
 	{
-		{8,  &MovingAverageImpl::_movingAverageMono<uint8_t>},
-		{16, &MovingAverageImpl::_movingAverageMono<int16_t>},
-		{32, &MovingAverageImpl::_movingAverageMono<int32_t>}
+		{SampleFormat::U8,  &MovingAverageImpl::_movingAverageMono<uint8_t>},
+		{SampleFormat::S16, &MovingAverageImpl::_movingAverageMono<int16_t>},
+		{SampleFormat::S24, &MovingAverageImpl::_movingAverageMono<Int24>},
+		{SampleFormat::S32, &MovingAverageImpl::_movingAverageMono<int32_t>},
+		{SampleFormat::F32, &MovingAverageImpl::_movingAverageMono<float>}
 	},
 	{
-		{8,  &MovingAverageImpl::_movingAverageStereo<uint8_t>},
-		{16, &MovingAverageImpl::_movingAverageStereo<int16_t>},
-		{32, &MovingAverageImpl::_movingAverageStereo<int32_t>}
+		{SampleFormat::U8,  &MovingAverageImpl::_movingAverageStereo<uint8_t>},
+		{SampleFormat::S16, &MovingAverageImpl::_movingAverageStereo<int16_t>},
+		{SampleFormat::S24, &MovingAverageImpl::_movingAverageStereo<Int24>},
+		{SampleFormat::S32, &MovingAverageImpl::_movingAverageStereo<int32_t>},
+		{SampleFormat::F32, &MovingAverageImpl::_movingAverageStereo<float>}
 	}
 };
 
 MovingAverageImpl::MovingAverageImpl(DecoderImpl *impl, float windowLength) :
 			DecoderImplDecorator(impl->getFileImpl(), impl),
 			n_samples(std::max((int)(windowLength * impl->getSampleRate()), 1)),
-			movingAverage(movingAverageFunc[impl->getNumChannels() - 1][impl->getBitsPerSample()]) {
+			movingAverage(movingAverageFunc[impl->getNumChannels() - 1][impl->getSampleFormat()]) {
 }
 
 template<typename T>
@@ -33,7 +33,7 @@ private:
 	double avg[2] = {0, 0}; // left & right channels
 
 	std::function<void(MovingAverageImpl &, void *, int)> movingAverage;
-	static std::vector<std::unordered_map<int, decltype(movingAverage)>> movingAverageFunc;
+	static std::vector<std::unordered_map<SampleFormat, decltype(movingAverage)>> movingAverageFunc;
 
 	template<typename T>
 	static void _movingAverageMono(MovingAverageImpl &, void *buf, int len);
@@ -14,80 +14,136 @@
  */
 
 #include "ReverbImpl.h"
-
-#include <iostream>
+#include "jukebox/Util/SampleTypes.h"
 
 namespace jukebox {
 
-std::unordered_map<short, decltype(ReverbImpl::reverb)> ReverbImpl::reverbFunc = {
-		{ 8, ReverbImpl::_reverb<uint8_t>},
-		{16, ReverbImpl::_reverb<int16_t>},
-		{32, ReverbImpl::_reverb<int32_t>}
+static constexpr size_t maxBlockFrames = 1024;
+static constexpr float stereoSpread = 23.0/44100.0; // seconds, from Freeverb
+static constexpr float maxDecay = 0.98; // keeps the network stable
+
+std::unordered_map<SampleFormat, decltype(ReverbImpl::reverb)> ReverbImpl::reverbFunc = {
+		{SampleFormat::U8,  ReverbImpl::_reverb<uint8_t>},
+		{SampleFormat::S16, ReverbImpl::_reverb<int16_t>},
+		{SampleFormat::S24, ReverbImpl::_reverb<Int24>},
+		{SampleFormat::S32, ReverbImpl::_reverb<int32_t>},
+		{SampleFormat::F32, ReverbImpl::_reverb<float>}
 };
 
 template<typename T>
 void ReverbImpl::_reverb(ReverbImpl &self, void *buf, int pos, int len) {
-	T *beginIt = reinterpret_cast<T *>(buf);
-	T *endIt = beginIt + (len/sizeof(T));
+	T *samples = reinterpret_cast<T *>(buf);
+	auto numChannels = self.delayLines.size();
+	size_t frames = (len/sizeof(T)) / numChannels;
 	auto offset = self.silenceLevel();
+	float *input = self.input.data();
 
-	for (auto sample = beginIt; sample != endIt; ++sample) {
-		float signedSample = *sample - offset;
-
-		float delaySum = 0;
+	for (size_t start = 0; start < frames; start += self.blockFrames) {
+		auto count = std::min(self.blockFrames, frames - start);
+		T *block = samples + start*numChannels;
 
-		for (size_t i = 0; i < self.numDelays; ++i)
-			delaySum += self.delayBuffer[i][self.bufPos[i]]; // sum all delay lines
+		for (size_t channel = 0; channel < numChannels; ++channel) {
+			for (size_t i = 0; i < count; ++i) // deinterleave
+				input[i] = (float)block[i*numChannels + channel] - offset;
 
-		signedSample =
-			(signedSample + (delaySum*self.decay)) / // add attenuated echos
-			((float)1.0 + (float)(self.numDelays)*self.decay); // weighted average
+			self.process(input, count, self.delayLines[channel]);
 
-		*sample = signedSample + offset;
-
-		for (size_t i = 0; i < self.numDelays; ++i) {
-			self.delayBuffer[i][self.bufPos[i]] = signedSample; // save the echo for the next time round
-			self.bufPos[i] = (self.bufPos[i] + 1) % self.delayBuffer[i].size(); // circular echo/delay buffer
+			for (size_t i = 0; i < count; ++i)
+				block[i*numChannels + channel] = input[i] + offset;
 		}
 	}
 };
 
+/*
+ * frames <= shortest delay line, so what is read from a line during the
+ * block was written before it started, and the echos of the whole block
+ * can be summed before any line is written. A line's output is read and
+ * its new input written at the same place, in place.
+ */
+void ReverbImpl::process(float *samples, size_t frames, std::vector<DelayLine> &lines) {
+	float *sum = delaySum.data();
+	float feedback = decay; // a local, the stores below can't alias it
+	float gain = 1.0f/(1.0f + decay); // dry and mean echo, weighted
+	float wet = decay/(float)numDelays;
+	float coupling = numDelays > 1 ? 2.0f/(float)numDelays : 0; // Householder, I - coupling
+
+	std::fill(sum, sum + frames, 0.0f);
+	for (auto &line: lines) { // sum all delay lines
+		auto first = std::min(frames, line.buffer.size() - line.pos);
+		const float *echo = line.buffer.data() + line.pos;
+
+		for (size_t i = 0; i < first; ++i)
+			sum[i] += echo[i];
+		echo = line.buffer.data();
+		for (size_t i = first; i < frames; ++i)
+			sum[i] += echo[i - first];
+	}
+
+	for (auto &line: lines) { // feed the mixed echos back with the input
+		auto first = std::min(frames, line.buffer.size() - line.pos);
+		float *echo = line.buffer.data() + line.pos;
+
+		for (size_t i = 0; i < first; ++i)
+			echo[i] = samples[i] + (echo[i] - coupling*sum[i])*feedback;
+		echo = line.buffer.data();
+		for (size_t i = first; i < frames; ++i)
+			echo[i - first] = samples[i] + (echo[i - first] - coupling*sum[i])*feedback;
+		line.pos += frames;
+		if (line.pos >= line.buffer.size())
+			line.pos -= line.buffer.size();
+	}
+
+	for (size_t i = 0; i < frames; ++i) // add attenuated echos
+		samples[i] = (samples[i] + sum[i]*wet)*gain;
+}
+
+void ReverbImpl::clear() {
+	for (auto &lines: delayLines)
+		for (auto &line: lines) {
+			line.pos = 0;
+			std::fill(line.buffer.begin(), line.buffer.end(), 0);
+		}
+}
+
 ReverbImpl::ReverbImpl(DecoderImpl *impl, float delay, float decay, size_t numDelays) :
 		DecoderImplDecorator(impl->getFileImpl(), impl),
 		delay(delay),
-		decay(decay),
+		decay(std::min(std::max(decay, 0.0f), maxDecay)),
 		numDelays(numDelays),
-		delayBuffer(numDelays),
-		bufPos(numDelays, 0) {
-
-	reverb = reverbFunc[getBitsPerSample()];
-
-	float delayInterval = 1.0/(float)numDelays;
-	for (auto &delayLine: delayBuffer) {
-		delayLine.resize(
-			delay * delayInterval *
-			(float)(getSampleRate() *
-			(getBitsPerSample() >> 3) *
-			getNumChannels()), 0);
-		delayInterval += 1.0/(float)numDelays;
+		delayLines(getNumChannels(), std::vector<DelayLine>(numDelays)),
+		blockFrames(maxBlockFrames) {
+
+	reverb = reverbFunc[getSampleFormat()];
+
+	// delay line lengths are in frames, evenly spaced up to 'delay' seconds,
+	// with each channel's lines slightly longer than the previous channel's
+	// so the tails are decorrelated.
+	for (size_t channel = 0; channel < delayLines.size(); ++channel) {
+		float delayInterval = 1.0/(float)numDelays;
+		for (auto &line: delayLines[channel]) {
+			size_t size =
+				(delay * delayInterval + stereoSpread * channel) *
+				(float)getSampleRate();
+			line.buffer.resize(std::max(size, (size_t)1), 0);
+			blockFrames = std::min(blockFrames, line.buffer.size());
+			delayInterval += 1.0/(float)numDelays;
+		}
 	}
+
+	input.resize(blockFrames);
+	delaySum.resize(blockFrames);
 }
 
 int ReverbImpl::getSamples(char* buf, int pos, int len) {
 	auto ret = impl->getSamples(buf, pos, len);
 
-	if (pos == 0) { // clear delay buffers when playing begins
-		for (auto &bp: bufPos)
-			bp = 0;
-		for (auto &delayLine: delayBuffer)
-			std::fill(delayLine.begin(), delayLine.end(), 0);
-	}
+	if (pos == 0) // clear delay buffers when playing begins
+		clear();
 
 	if (ret > 0)
-		reverb(*this, buf, pos, len);
+		reverb(*this, buf, pos, ret);
 
 	return ret;
 }
 
 } /* namespace jukebox */
-
@@ -26,20 +26,37 @@
 
 namespace jukebox {
 
+/*
+ * Feedback delay network, one per channel: the delay lines' outputs are
+ * cross-coupled through a Householder matrix (I - 2/N, orthogonal, so
+ * 'decay', up to 0.98, alone sets how fast the tail dies out) and fed
+ * back with the input. Samples are processed in blocks no longer than the shortest
+ * delay line, so every line is read and written as (at most two)
+ * contiguous runs.
+ */
 class ReverbImpl: public DecoderImplDecorator {
 public:
 	ReverbImpl(DecoderImpl *impl, float delay, float decay, size_t numDelays);
 	virtual ~ReverbImpl() = default;
 	int getSamples(char *buf, int pos, int len) override;
 private:
+	struct DelayLine {
+		std::vector<float> buffer;
+		size_t pos = 0;
+	};
+
 	float delay, decay;
 	size_t numDelays;
 
-	std::vector<std::vector<float> > delayBuffer;
-	std::vector<size_t> bufPos;
+	std::vector<std::vector<DelayLine> > delayLines; // [channel][line]
+	size_t blockFrames;
+	std::vector<float> input, delaySum;
+
+	void process(float *samples, size_t frames, std::vector<DelayLine> &lines);
+	void clear();
 
 	std::function<void(ReverbImpl &, void *, int, int)> reverb;
-	static std::unordered_map<short, decltype(reverb)> reverbFunc;
+	static std::unordered_map<SampleFormat, decltype(reverb)> reverbFunc;
 
 	template<typename T>
 	static void _reverb(ReverbImpl &self, void *buf, int pos, int len);
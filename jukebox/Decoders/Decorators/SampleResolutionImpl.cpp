@@ -13,40 +13,27 @@
     along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <limits>
-#include <algorithm>
-#include <cmath>
 #include <stdexcept>
 #include "SampleResolutionImpl.h"
 
 namespace jukebox {
 
-std::unordered_map<int, decltype(SampleResolutionImpl::changeResolution)>
-	SampleResolutionImpl::changeResolutionFunc = {
-			{0      , [](void *buf, void *out, int len, int source_offset, int dest_offset){
-				std::copy((char *)buf, (char *)buf+len, (char *)out);
-				return len;
-			}},
-			{32 - 16, SampleResolutionImpl::_changeResolution<int32_t, int16_t>}, // 16
-			{16 - 32, SampleResolutionImpl::_changeResolution<int16_t, int32_t>}, // -16
-			{32 -  8, SampleResolutionImpl::_changeResolution<int32_t, uint8_t>}, // 24
-			{8  - 32, SampleResolutionImpl::_changeResolution<uint8_t, int32_t>}, // -24
-			{16 -  8, SampleResolutionImpl::_changeResolution<int16_t, uint8_t>}, // 8
-			{8  - 16, SampleResolutionImpl::_changeResolution<uint8_t, int16_t>} // -8
-	};
-
 SampleResolutionImpl::SampleResolutionImpl(DecoderImpl* impl, int resolution) :
 	DecoderImplDecorator(impl->getFileImpl(), impl),
 	resolution(resolution),
 	nativeResolution(impl->getBitsPerSample()) {
 
-	if (resolution != 8 && resolution != 16 && resolution != 32)
+	if (resolution != 8 && resolution != 16 && resolution != 24 && resolution != 32)
 		throw std::runtime_error("invalid resolution: " + std::to_string(resolution));
 
-	changeResolution = changeResolutionFunc[nativeResolution - resolution];
+	format = sampleFormat(resolution);
+	nativeFormat = impl->getSampleFormat();
 }
 
 int SampleResolutionImpl::getSamples(char* buf, int pos, int len) {
+	if (format == nativeFormat)
+		return impl->getSamples(buf, pos, len);
+
 	std::unique_ptr<char []> resBuf(new char[len*nativeResolution/resolution]);
 
 	auto siz = impl->getSamples(
@@ -54,32 +41,12 @@ int SampleResolutionImpl::getSamples(char* buf, int pos, int len) {
 		pos*nativeResolution/resolution,
 		len*nativeResolution/resolution);
 
-	auto chsiz = changeResolution(resBuf.get(), buf, siz, impl->silenceLevel(), silenceLevel());
-	return chsiz;
-}
+	if (siz <= 0)
+		return siz;
 
-template<class T, class U>
-int SampleResolutionImpl::_changeResolution(
-		void* buf,
-		void *out,
-		int len,
-		int source_offset,
-		int dest_offset) {
-	if (len <= 0)
-		return len;
-
-	T *inp = reinterpret_cast<T *>(buf);
-	U *outp = reinterpret_cast<U *>(out);
-
-	auto beginIt = inp;
-	auto endIt = inp + (len / sizeof(T));
-	for (auto sample = beginIt; sample != endIt; ++sample, ++outp) {
-		double signedSample = ((double)(*sample - source_offset) / (double)std::numeric_limits<T>::max());
-		double convertedSample = signedSample * (double)std::numeric_limits<U>::max();
-		*outp = convertedSample + dest_offset;
-	}
-
-	return (len*sizeof(U))/sizeof(T);
+	auto count = siz / sampleSize(nativeFormat);
+	convertSamples(resBuf.get(), nativeFormat, buf, format, count);
+	return count * sampleSize(format);
 }
 
 int SampleResolutionImpl::getBlockSize() const {
@@ -90,6 +57,10 @@ short SampleResolutionImpl::getBitsPerSample() const {
 	return resolution;
 }
 
+SampleFormat SampleResolutionImpl::getSampleFormat() const {
+	return format;
+}
+
 int SampleResolutionImpl::getDataSize() const {
 	return (impl->getDataSize()*resolution)/nativeResolution;
 }
@@ -17,10 +17,9 @@
 #define JUKEBOX_DECODERS_DECORATORS_SAMPLERESOLUTIONIMPL_H_
 
 #include <memory>
-#include <functional>
-#include <unordered_map>
 #include "../DecoderImpl.h"
 #include "DecoderImplDecorator.h"
+#include "jukebox/Util/SampleConversion.h"
 
 namespace jukebox {
 
@@ -31,15 +30,12 @@ public:
 	int getSamples(char *buf, int pos, int len) override;
 	int getBlockSize() const override;
 	short getBitsPerSample() const override;
+	SampleFormat getSampleFormat() const override;
 	int getDataSize() const override;
 	virtual int silenceLevel() const;
 private:
 	int resolution, nativeResolution;
-	std::function<int(void *, void *, int, int, int)> changeResolution;
-	static std::unordered_map<int, decltype(changeResolution)> changeResolutionFunc;
-
-	template<class T, class U> // converts from T to U
-	static int _changeResolution(void *buf, void *out, int len, int source_offset, int dest_offset);
+	SampleFormat format, nativeFormat;
 };
 
 } /* namespace jukebox */
@@ -24,7 +24,8 @@ FLACDecoderImpl::FLACDecoderImpl(FLACFileImpl& fileImpl) :
 	fileImpl(fileImpl),
 	bytesPerSample(fileImpl.getBitsPerSample() >> 3),
 	frameSize(fileImpl.getNumChannels() * bytesPerSample),
-	flacHandler(fileImpl.createHandler(), closeFlac) {
+	reader(fileImpl.getSource()),
+	flacHandler(fileImpl.createHandler(reader), closeFlac) {
 }
 
 int FLACDecoderImpl::getSamples(char* buf, int pos, int len) {
@@ -39,6 +40,16 @@ int FLACDecoderImpl::getSamples(char* buf, int pos, int len) {
 			numFrames,
 			(int32_t *)buf) * frameSize;
 
+	if (bytesPerSample == 3) {
+		s32Buf.resize(numFrames * fileImpl.getNumChannels());
+		auto frames = drflac_read_pcm_frames_s32(
+			flacHandler.get(),
+			numFrames,
+			s32Buf.data());
+		convertSamples(s32Buf.data(), SampleFormat::S32, buf, SampleFormat::S24, frames*fileImpl.getNumChannels());
+		return frames * frameSize;
+	}
+
 	return drflac_read_pcm_frames_s16(
 		flacHandler.get(),
 		numFrames,
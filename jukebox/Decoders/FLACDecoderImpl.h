@@ -17,6 +17,7 @@
 #define JUKEBOX_DECODERS_VORBISDECODERIMPL_H_
 
 #include <memory>
+#include <vector>
 #include "jukebox/FileFormats/FLACFileImpl.h"
 #include "DecoderImpl.h"
 
@@ -31,7 +32,9 @@ private:
 	FLACFileImpl &fileImpl;
 	short bytesPerSample;
 	short frameSize;
+	ByteReader reader; // streamed handlers read through it, so it goes first
 	std::unique_ptr<drflac, decltype(&closeFlac)> flacHandler;
+	std::vector<int32_t> s32Buf; // 24 bit samples are decoded as s32 and packed
 };
 
 } /* namespace jukebox */
@@ -17,6 +17,7 @@
 #include <cstring>
 #include <algorithm>
 #include <functional>
+#include <array>
 
 #include "fluidsynth/soundfont.h"
 #include "jukebox/FileFormats/MIDIFileImpl.h"
@@ -35,11 +36,6 @@ void freeFluidSynthSynth(fluid_synth_t *synth) {
 		delete_fluid_synth(synth);
 }
 
-void freeFluidSynthPlayer(fluid_player_t *player) {
-	if (player)
-		delete_fluid_player(player);
-}
-
 // empty log function to remove warning messages from console
 void dummy_fluid_log_function(int level, char *	message,void * data){}
 
@@ -176,8 +172,7 @@ MIDIDecoderImpl::MIDIDecoderImpl(MIDIFileImpl& fileImpl) :
 		DecoderImpl(fileImpl),
 		fileImpl(fileImpl),
 		settings(new_fluid_settings(), freeFluidSynthSettings),
-		synth(new_fluid_synth(settings.get()), freeFluidSynthSynth),
-		player(new_fluid_player(synth.get()), freeFluidSynthPlayer) {
+		synth(new_fluid_synth(settings.get()), freeFluidSynthSynth) {
 
 	auto &midiConfig = MIDIConfigurator::getInstance();
 
@@ -193,31 +188,116 @@ MIDIDecoderImpl::MIDIDecoderImpl(MIDIFileImpl& fileImpl) :
 	}
 }
 
+/* The MIDI events are sequenced here, instead of using fluid_player,
+ * so the synth receives them at the exact frame they're due and
+ * seeking is under our control.
+ */
 int MIDIDecoderImpl::getSamples(char* buf, int pos, int len) {
-	if (pos == 0)
-		reset();
-
 	if (pos >= fileImpl.getDataSize())
 		return 0;
 
-	memset(buf, 0, len);
-
 	if (pos + len > fileImpl.getDataSize())
 		len = fileImpl.getDataSize() - pos;
 
-	fluid_synth_write_s16(
-			synth.get(), len/4, // 16 bit Stereo
-			buf, 0, 2,
-			buf, 1, 2);
+	auto frame = pos/getBlockSize();
+	if (frame != nextFrame)
+		seek(frame);
+
+	auto &events = fileImpl.getEvents();
+	auto out = reinterpret_cast<int16_t *>(buf);
+	int numFrames = len/getBlockSize();
+
+	while (numFrames > 0) {
+		while (nextEvent < events.size() && events[nextEvent].frame <= nextFrame)
+			sendEvent(events[nextEvent++]);
+
+		int frames = numFrames;
+		if (nextEvent < events.size())
+			frames = std::min(frames, events[nextEvent].frame - nextFrame);
+
+		fluid_synth_write_s16(
+				synth.get(), frames, // 16 bit Stereo
+				out, 0, 2,
+				out, 1, 2);
+
+		out += frames*2;
+		nextFrame += frames;
+		numFrames -= frames;
+	}
 
 	return len;
 }
 
-void MIDIDecoderImpl::reset() {
-	fluid_player_stop(player.get());
-	player.reset(new_fluid_player(synth.get()));
-	fluid_player_add_mem(player.get(), fileImpl.getMemoryBuffer(), fileImpl.getBufferSize());
-    fluid_player_play(player.get());
+/* Seeking doesn't render audio: it replays controller, program,
+ * pitch bend and sysex messages up to the target frame, only
+ * keeping track of note on/off, and then starts the notes that
+ * are still held at that point.
+ */
+void MIDIDecoderImpl::seek(int frame) {
+	fluid_synth_system_reset(synth.get());
+
+	auto &events = fileImpl.getEvents();
+	std::array<std::array<uint8_t, 128>, 16> heldNotes = {}; // velocity of sounding notes
+
+	nextEvent = 0;
+	while (nextEvent < events.size() && events[nextEvent].frame < frame) {
+		auto &event = events[nextEvent++];
+		auto channel = event.status & 0x0f;
+
+		switch (event.status & 0xf0) {
+			case 0x80:
+				heldNotes[channel][event.data1 & 0x7f] = 0;
+				break;
+			case 0x90: // velocity 0 is a note off
+				heldNotes[channel][event.data1 & 0x7f] = event.data2;
+				break;
+			default:
+				sendEvent(event);
+		}
+	}
+
+	for (int channel = 0; channel < 16; ++channel)
+		for (int key = 0; key < 128; ++key)
+			if (heldNotes[channel][key] > 0)
+				fluid_synth_noteon(synth.get(), channel, key, heldNotes[channel][key]);
+
+	nextFrame = frame;
+}
+
+void MIDIDecoderImpl::sendEvent(const MIDIEvent &event) {
+	auto channel = event.status & 0x0f;
+
+	switch (event.status & 0xf0) {
+		case 0x80:
+			fluid_synth_noteoff(synth.get(), channel, event.data1);
+			break;
+		case 0x90:
+			fluid_synth_noteon(synth.get(), channel, event.data1, event.data2);
+			break;
+		case 0xa0:
+			fluid_synth_key_pressure(synth.get(), channel, event.data1, event.data2);
+			break;
+		case 0xb0:
+			fluid_synth_cc(synth.get(), channel, event.data1, event.data2);
+			break;
+		case 0xc0:
+			fluid_synth_program_change(synth.get(), channel, event.data1);
+			break;
+		case 0xd0:
+			fluid_synth_channel_pressure(synth.get(), channel, event.data1);
+			break;
+		case 0xe0:
+			fluid_synth_pitch_bend(synth.get(), channel, (event.data2 << 7) | event.data1);
+			break;
+		case 0xf0:
+			if (event.sysexLength > 0)
+				fluid_synth_sysex(
+					synth.get(),
+					fileImpl.getSysexData().data() + event.sysexOffset,
+					event.sysexLength,
+					nullptr, nullptr, nullptr, 0);
+			break;
+	}
 }
 
 } /* namespace jukebox */
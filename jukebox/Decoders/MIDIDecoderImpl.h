@@ -25,7 +25,8 @@ class MIDIFileImpl;
 
 extern void freeFluidSynthSettings(fluid_settings_t *);
 extern void freeFluidSynthSynth(fluid_synth_t *);
-extern void freeFluidSynthPlayer(fluid_player_t *);
+
+struct MIDIEvent;
 
 class MIDIDecoderImpl: public DecoderImpl {
 public:
@@ -36,8 +37,10 @@ private:
 	MIDIFileImpl &fileImpl;
     std::unique_ptr<fluid_settings_t, decltype(&freeFluidSynthSettings)> settings;
     std::unique_ptr<fluid_synth_t, decltype(&freeFluidSynthSynth)> synth;
-    std::unique_ptr<fluid_player_t, decltype(&freeFluidSynthPlayer)> player;
-    void reset();
+    size_t nextEvent = 0;
+    int nextFrame = -1; // forces a seek on the first call
+    void seek(int frame);
+    void sendEvent(const MIDIEvent &event);
 };
 
 } /* namespace jukebox */
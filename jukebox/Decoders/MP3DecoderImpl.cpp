@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <limits>
 #include "MP3DecoderImpl.h"
+#include "jukebox/Util/SampleConversion.h"
 
 namespace jukebox {
 
@@ -24,18 +25,17 @@ MP3DecoderImpl::MP3DecoderImpl(MP3FileImpl& fileImpl) :
 	DecoderImpl(fileImpl),
 	fileImpl(fileImpl),
 	frameSize(fileImpl.getNumChannels() * (fileImpl.getBitsPerSample() >> 3)),
-	mp3(fileImpl.createHandler(), closeMP3) {
+	reader(fileImpl.getSource()),
+	mp3(fileImpl.createHandler(reader), closeMP3) {
 }
 
 int MP3DecoderImpl::getSamples(char* buf, int pos, int len) {
-	drmp3_seek_to_pcm_frame(mp3.get(), pos / frameSize);
+	drmp3_seek_to_pcm_frame(mp3.get(), pos / frameSize + fileImpl.getSkipFrames());
 
 	size_t numFrames = len/frameSize;
 	std::unique_ptr<float []> floatBuf(new float[numFrames*fileImpl.getNumChannels()]);
 	auto ret = drmp3_read_pcm_frames_f32(mp3.get(), numFrames, floatBuf.get());
-	auto sampleOut = (int16_t *)buf;
-	for (size_t i = 0; i < numFrames*fileImpl.getNumChannels(); ++i, ++sampleOut)
-		*sampleOut = floatBuf[i] * std::numeric_limits<int16_t>::max();
+	convertSamples(floatBuf.get(), SampleFormat::F32, buf, SampleFormat::S16, ret*fileImpl.getNumChannels());
 	return ret * frameSize;
 }
 
@@ -30,6 +30,7 @@ public:
 private:
 	MP3FileImpl &fileImpl;
 	int frameSize;
+	ByteReader reader; // streamed handlers read through it, so it goes first
 	std::unique_ptr<drmp3, decltype(&closeMP3)> mp3;
 };
 
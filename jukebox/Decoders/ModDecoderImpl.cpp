@@ -14,6 +14,8 @@
  */
 
 #include <cstring>
+#include <algorithm>
+#include <vector>
 #include "jukebox/FileFormats/ModFileImpl.h"
 #include "ModDecoderImpl.h"
 
@@ -34,14 +36,14 @@ ModDecoderImpl::ModDecoderImpl(ModFileImpl& fileImpl) :
 }
 
 int ModDecoderImpl::getSamples(char* buf, int pos, int len) {
-    if (pos == 0) {
-        micromod_set_position_obj(&mmodobj, 0);
-    }
-
 	if (pos >= fileImpl.getDataSize()) {
 		return 0;
     }
 
+	if (pos != next) {
+		seek(pos);
+	}
+
 	memset(buf, 0, len);
 
 	if (pos + len > fileImpl.getDataSize()) {
@@ -49,8 +51,25 @@ int ModDecoderImpl::getSamples(char* buf, int pos, int len) {
     }
 
     micromod_get_audio_obj(&mmodobj, (int16_t *)buf, len/sampleSize);
+	next = pos + len;
 
 	return len;
 }
 
+/* micromod can only jump to a pattern, so seeking restarts the song
+ * and renders up to pos, throwing it away.
+ */
+void ModDecoderImpl::seek(int pos) {
+	micromod_set_position_obj(&mmodobj, 0);
+
+	std::vector<int16_t> discard(4096 * 2);
+	for (long frames = pos/sampleSize; frames > 0; ) {
+		long count = std::min<long>(frames, discard.size() / 2);
+		std::fill(discard.begin(), discard.end(), 0);
+		micromod_get_audio_obj(&mmodobj, discard.data(), count);
+		frames -= count;
+	}
+	next = pos;
+}
+
 } /* namespace jukebox */
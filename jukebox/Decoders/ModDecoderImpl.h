@@ -33,7 +33,10 @@ public:
 private:
 	ModFileImpl &fileImpl;
     int sampleSize;
+	int next = 0; // where the song is, any other position seeks
     struct micromod_obj mmodobj;
+
+	void seek(int pos);
 };
 
 } /* namespace jukebox */
@@ -0,0 +1,51 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include "PCMCacheDecoderImpl.h"
+#include "jukebox/FileFormats/PCMCache.h"
+#include "jukebox/FileFormats/SoundFileImpl.h"
+
+namespace jukebox {
+
+PCMCacheDecoderImpl::PCMCacheDecoderImpl(
+		SoundFileImpl& fileImpl,
+		PCMCache &cache,
+		std::function<DecoderImpl *()> makeDecoder) :
+	DecoderImpl(fileImpl),
+	cache(cache),
+	makeDecoder(makeDecoder) {
+}
+
+int PCMCacheDecoderImpl::getSamples(char* buf, int pos, int len) {
+	if (pos >= fileImpl.getDataSize())
+		return 0;
+
+	len = std::min(len, fileImpl.getDataSize() - pos);
+
+	if (cache.read(buf, pos, len)) {
+		if (cache.rendered())
+			decoder.reset();
+		return len;
+	}
+
+	if (!decoder)
+		decoder.reset(makeDecoder());
+
+	return decoder->getSamples(buf, pos, len);
+}
+
+} /* namespace jukebox */
@@ -0,0 +1,47 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef JUKEBOX_DECODERS_PCMCACHEDECODERIMPL_H_
+#define JUKEBOX_DECODERS_PCMCACHEDECODERIMPL_H_
+
+#include <memory>
+#include <functional>
+#include "DecoderImpl.h"
+
+namespace jukebox {
+
+class PCMCache;
+
+/* Streams from the file's PCM cache. While the background rendering
+ * is still behind the requested position, it falls back to a regular
+ * (synthesizer) decoder. The fallback is stateful and is handed
+ * whatever position comes next, so it must seek by itself when that
+ * isn't where its last read ended (MIDIDecoderImpl, ModDecoderImpl do).
+ */
+class PCMCacheDecoderImpl: public DecoderImpl {
+public:
+	PCMCacheDecoderImpl(SoundFileImpl &fileImpl, PCMCache &cache, std::function<DecoderImpl *()> makeDecoder);
+	virtual ~PCMCacheDecoderImpl() = default;
+	int getSamples(char *buf, int pos, int len) override;
+private:
+	PCMCache &cache;
+	std::function<DecoderImpl *()> makeDecoder;
+	std::unique_ptr<DecoderImpl> decoder;
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_DECODERS_PCMCACHEDECODERIMPL_H_ */
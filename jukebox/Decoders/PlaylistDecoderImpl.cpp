@@ -0,0 +1,162 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "PlaylistDecoderImpl.h"
+#include "jukebox/FileFormats/PlaylistFileImpl.h"
+#include "jukebox/Util/WorkerPool.h"
+
+namespace jukebox {
+
+namespace {
+
+int trackBlockSize(const SoundFile &file) {
+	return file.getNumChannels() * sampleSize(file.getSampleFormat());
+}
+
+// equal-power fade, x in [0, 1]
+float fadeGain(float x) {
+	static const float halfPi = std::acos(-1.0f) / 2;
+	return std::sin(x * halfPi);
+}
+
+}
+
+PlaylistDecoderImpl::PlaylistDecoderImpl(PlaylistFileImpl &fileImpl) :
+		DecoderImpl(fileImpl),
+		playlist(fileImpl.getPlaylist()) {
+}
+
+void PlaylistDecoderImpl::prepare(size_t index, const Playlist::Track &track) {
+	if (voices.count(index))
+		return;
+
+	auto voice = std::make_shared<Voice>();
+	auto file = track.file;
+	size_t frames = std::min<size_t>(track.frames, track.fadeIn + prerollSecs * getSampleRate());
+
+	voice->ready = WorkerPool::getInstance().submit([voice, file, frames]() {
+		voice->decoder.reset(new Decoder(file));
+		voice->preroll.resize(frames * trackBlockSize(file));
+
+		int pos = 0, len = 0, size = voice->preroll.size();
+		while (pos < size && (len = voice->decoder->getSamples(voice->preroll.data() + pos, pos, size - pos)) > 0)
+			pos += len;
+		voice->preroll.resize(pos);
+	});
+	voices[index] = voice;
+}
+
+PlaylistDecoderImpl::Voice &PlaylistDecoderImpl::getVoice(size_t index, const Playlist::Track &track) {
+	prepare(index, track); // not prepared ahead (first track, seeking), wait for it
+	auto &voice = *voices[index];
+	if (voice.ready.valid()) {
+		try {
+			voice.ready.get();
+		} catch (std::exception &) { // don't take the playing thread down with a bad track
+			voice.decoder.reset();
+			voice.preroll.clear();
+		}
+	}
+	return voice;
+}
+
+void PlaylistDecoderImpl::read(Voice &voice, const Playlist::Track &track, size_t first, size_t count, char *buf) {
+	size_t blockSize = trackBlockSize(track.file);
+	size_t pos = first * blockSize, len = count * blockSize;
+
+	if (pos < voice.preroll.size()) {
+		auto n = std::min(len, voice.preroll.size() - pos);
+		memcpy(buf, voice.preroll.data() + pos, n);
+		pos += n;
+		buf += n;
+		len -= n;
+	}
+
+	while (len > 0) {
+		auto n = voice.decoder ? voice.decoder->getSamples(buf, pos, len) : 0;
+		if (n <= 0) {
+			memset(buf, track.file.silenceLevel(), len);
+			break;
+		}
+		pos += n;
+		buf += n;
+		len -= n;
+	}
+}
+
+int PlaylistDecoderImpl::getSamples(char *buf, int pos, int len) {
+	size_t first = pos / blockSize, count = len / blockSize;
+	auto channels = getNumChannels();
+	auto format = getSampleFormat();
+
+	playlist.getTracks(first, count, tracks);
+
+	// drop the tracks already played
+	if (!tracks.empty())
+		voices.erase(voices.begin(), voices.lower_bound(tracks.front().first));
+
+	// a whole block of a single track, no fade: straight from its decoder
+	if (tracks.size() == 1) {
+		auto index = tracks[0].first;
+		auto &track = tracks[0].second;
+		if (first >= track.start + track.fadeIn &&
+			first + count <= track.start + track.frames - track.fadeOut &&
+			track.file.getSampleFormat() == format) {
+
+			read(getVoice(index, track), track, first - track.start, count, buf);
+			if (index + 1 < playlist.size())
+				prepare(index + 1, playlist.getTrack(index + 1));
+			return len;
+		}
+	}
+
+	mix.assign(count * channels, 0.0f);
+	for (auto &entry : tracks) {
+		auto index = entry.first;
+		auto &track = entry.second;
+		auto begin = std::max(first, track.start);
+		auto end = std::min(first + count, track.start + track.frames);
+
+		trackBuf.resize((end - begin) * trackBlockSize(track.file));
+		trackSamples.resize((end - begin) * channels);
+		read(getVoice(index, track), track, begin - track.start, end - begin, trackBuf.data());
+		convertSamples(trackBuf.data(), track.file.getSampleFormat(), trackSamples.data(), SampleFormat::F32, trackSamples.size());
+
+		auto out = mix.data() + (begin - first) * channels;
+		auto in = trackSamples.data();
+		auto fadeOutStart = track.start + track.frames - track.fadeOut;
+		for (auto frame = begin; frame < end; ++frame) {
+			float gain = 1;
+			if (frame < track.start + track.fadeIn)
+				gain = fadeGain((frame - track.start + 0.5f) / track.fadeIn);
+			else if (frame >= fadeOutStart)
+				gain = fadeGain((track.start + track.frames - frame - 0.5f) / track.fadeOut);
+			for (int c = 0; c < channels; ++c)
+				*out++ += *in++ * gain;
+		}
+
+		if (index + 1 < playlist.size())
+			prepare(index + 1, playlist.getTrack(index + 1));
+	}
+
+	convertSamples(mix.data(), SampleFormat::F32, buf, format, mix.size());
+	return len;
+}
+
+} /* namespace jukebox */
@@ -0,0 +1,63 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef JUKEBOX_DECODERS_PLAYLISTDECODERIMPL_H_
+#define JUKEBOX_DECODERS_PLAYLISTDECODERIMPL_H_
+
+#include <future>
+#include <map>
+#include <memory>
+#include <vector>
+#include "DecoderImpl.h"
+#include "Decoder.h"
+#include "jukebox/FileFormats/Playlist.h"
+
+namespace jukebox {
+
+class PlaylistFileImpl;
+
+/* Mixes the playlist tracks playing at each position. Every track
+ * touched gets the next one opened and its first frames decoded on the
+ * worker pool, so the playing thread doesn't stall at transitions.
+ */
+class PlaylistDecoderImpl: public DecoderImpl {
+public:
+	PlaylistDecoderImpl(PlaylistFileImpl &fileImpl);
+	virtual ~PlaylistDecoderImpl() = default;
+	int getSamples(char *buf, int pos, int len) override;
+private:
+	struct Voice {
+		std::unique_ptr<Decoder> decoder; // none when the track failed to load, it plays as silence
+		std::vector<char> preroll; // first frames, in the track's format
+		std::future<void> ready;
+	};
+
+	static constexpr float prerollSecs = 0.5;
+
+	Playlist &playlist;
+	std::map<size_t, std::shared_ptr<Voice>> voices;
+	std::vector<std::pair<size_t, Playlist::Track>> tracks;
+	std::vector<char> trackBuf;
+	std::vector<float> trackSamples, mix;
+
+	Voice &getVoice(size_t index, const Playlist::Track &track);
+	void prepare(size_t index, const Playlist::Track &track);
+	void read(Voice &voice, const Playlist::Track &track, size_t first, size_t count, char *buf);
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_DECODERS_PLAYLISTDECODERIMPL_H_ */
@@ -0,0 +1,71 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <algorithm>
+#include <cstring>
+
+#include "QOADecoderImpl.h"
+#include "jukebox/Util/QOA.h"
+
+namespace jukebox {
+
+QOADecoderImpl::QOADecoderImpl(QOAFileImpl& fileImpl) :
+		DecoderImpl(fileImpl),
+		fileImpl(fileImpl),
+		frameSize(fileImpl.getNumChannels() * 2),
+		reader(fileImpl.getSource()),
+		qoaHandler(fileImpl.createHandler(reader)),
+		frame(qoa::frameLen * fileImpl.getNumChannels()) {
+}
+
+/* QOA frames are independent and, but for the last one, of the same size,
+ * so the one holding pos is found without reading the others.
+ */
+int QOADecoderImpl::getSamples(char* buf, int pos, int len) {
+	int done = 0;
+	auto current = pos / frameSize;
+	auto numFrames = len / frameSize;
+
+	while (done < numFrames) {
+		int64_t index = (current + done) / qoa::frameLen;
+		if (index != frameIndex) {
+			auto offset = qoa::fileHeaderSize + index * fileImpl.getFrameSize();
+			auto available = std::min<uint64_t>(fileImpl.getFrameSize(), qoaHandler->size - std::min(offset, qoaHandler->size));
+			auto p = qoaHandler->read(offset, available);
+			qoa::FrameHeader header;
+			if (p == nullptr || available < qoa::frameHeaderSize || !qoa::readFrameHeader(p, header) ||
+				header.numChannels != fileImpl.getNumChannels())
+				break;
+
+			frameFrames = qoa::decodeFrame(p, available, frame.data());
+			frameIndex = frameFrames > 0 ? index : -1;
+			if (frameFrames == 0)
+				break;
+		}
+
+		int first = (current + done) % qoa::frameLen;
+		int count = std::min(numFrames - done, frameFrames - first);
+		if (count <= 0)
+			break;
+		memcpy(buf + done * frameSize, &frame[first * fileImpl.getNumChannels()], count * frameSize);
+		done += count;
+	}
+
+	return done * frameSize;
+}
+
+} /* namespace jukebox */
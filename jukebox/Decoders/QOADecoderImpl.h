@@ -0,0 +1,46 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef JUKEBOX_DECODERS_QOADECODERIMPL_H_
+#define JUKEBOX_DECODERS_QOADECODERIMPL_H_
+
+#include <memory>
+#include <vector>
+#include "jukebox/FileFormats/QOAFileImpl.h"
+#include "DecoderImpl.h"
+
+namespace jukebox {
+
+class QOADecoderImpl: public DecoderImpl {
+public:
+	QOADecoderImpl(QOAFileImpl &fileImpl);
+	virtual ~QOADecoderImpl() = default;
+	int getSamples(char *buf, int pos, int len) override;
+private:
+	QOAFileImpl &fileImpl;
+	int frameSize;
+
+	ByteReader reader; // streamed handlers read through it, so it goes first
+	std::unique_ptr<QOAHandler> qoaHandler;
+	std::vector<int16_t> frame; // the last one decoded
+	int64_t frameIndex = -1;
+	int frameFrames = 0;
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_DECODERS_QOADECODERIMPL_H_ */
@@ -23,7 +23,8 @@ VorbisDecoderImpl::VorbisDecoderImpl(VorbisFileImpl& fileImpl) :
 	DecoderImpl(fileImpl),
 	fileImpl(fileImpl),
 	numChannels(fileImpl.getNumChannels()),
-	vorbisHandler(fileImpl.createHandler(), closeVorbis) {
+	reader(fileImpl.getSource()),
+	vorbisHandler(fileImpl.createHandler(reader), closeVorbis) {
 }
 
 int VorbisDecoderImpl::getSamples(char* buf, int pos, int len) {
@@ -30,6 +30,7 @@ public:
 private:
 	VorbisFileImpl &fileImpl;
 	int numChannels;
+	ByteReader reader; // streamed handlers read through it, so it goes first
 	std::unique_ptr<stb_vorbis, decltype(&closeVorbis)> vorbisHandler;
 };
 
@@ -25,14 +25,8 @@ WaveDecoderImpl::WaveDecoderImpl(WaveFileImpl& fileImpl) :
 		DecoderImpl(fileImpl),
 		fileImpl(fileImpl),
 		frameSize(fileImpl.getNumChannels() * (fileImpl.getBitsPerSample() >> 3)),
-		wavHandler(fileImpl.createHandler(), closeWav) {
-}
-
-short WaveDecoderImpl::getBitsPerSample() const {
-	if (wavHandler->translatedFormatTag == DR_WAVE_FORMAT_PCM)
-		return fileImpl.getBitsPerSample();
-	else
-		return fileImpl.getBitsPerSample() >= 32?32:16;
+		reader(fileImpl.getSource()),
+		wavHandler(fileImpl.createHandler(reader), closeWav) {
 }
 
 int WaveDecoderImpl::getSamples(char* buf, int pos, int len) {
@@ -46,6 +40,11 @@ int WaveDecoderImpl::getSamples(char* buf, int pos, int len) {
 			wavHandler.get(),
 			numFrames,
 			(int *)buf) * frameSize;
+	else if (wavHandler->translatedFormatTag == DR_WAVE_FORMAT_IEEE_FLOAT)
+		return drwav_read_pcm_frames_f32(
+			wavHandler.get(),
+			numFrames,
+			(float *)buf) * frameSize;
 	else {
 		if (fileImpl.getBitsPerSample() >= 32)
 			return drwav_read_pcm_frames_s32(
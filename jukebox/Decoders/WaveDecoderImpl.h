@@ -25,12 +25,12 @@ class WaveDecoderImpl: public DecoderImpl {
 public:
 	WaveDecoderImpl(WaveFileImpl &fileImpl);
 	virtual ~WaveDecoderImpl() = default;
-	short getBitsPerSample() const override;
 	int getSamples(char *buf, int pos, int len) override;
 private:
 	WaveFileImpl &fileImpl;
 	int frameSize;
 
+	ByteReader reader; // streamed handlers read through it, so it goes first
 	std::unique_ptr<drwav, decltype(&closeWav)> wavHandler;
 };
 
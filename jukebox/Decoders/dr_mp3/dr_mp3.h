@@ -3054,11 +3054,10 @@ drmp3_bool32 drmp3_seek_to_pcm_frame__seek_table(drmp3* pMP3, drmp3_uint64 frame
 
     // Whole MP3 frames need to be discarded first.
     for (drmp3_uint16 iMP3Frame = 0; iMP3Frame < seekPoint.mp3FramesToDiscard; ++iMP3Frame) {
-        // Pass in non-null for the last frame because we want to ensure the sample rate converter is preloaded correctly.
-        drmp3d_sample_t* pPCMFrames = NULL;
-        if (iMP3Frame == seekPoint.mp3FramesToDiscard-1) {
-            pPCMFrames = (drmp3d_sample_t*)pMP3->pcmFrames;
-        }
+        // libjukebox: all of them are decoded, not only the last one, so the overlap and synthesis filter state the
+        // first frame after the seek point carries over is the one a serial decode has (MPEG-2/2.5 frames are a single
+        // granule, decoding just the last frame left it off). This also preloads the sample rate converter.
+        drmp3d_sample_t* pPCMFrames = (drmp3d_sample_t*)pMP3->pcmFrames;
 
         // We first need to decode the next frame, and then we need to flush the resampler.
         drmp3_uint32 pcmFramesReadPreSRC = drmp3_decode_next_frame_ex(pMP3, pPCMFrames, DRMP3_TRUE);
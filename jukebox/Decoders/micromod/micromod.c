@@ -1,5 +1,9 @@
 #include "micromod.h"
 
+#if defined( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
 #define FP_SHIFT 14
 #define FP_ONE   16384
 #define FP_MASK  16383
@@ -374,6 +378,50 @@ static long sequence_tick( struct micromod_obj* obj ) {
 	return song_end;
 }
 
+/*
+	Mix whole blocks of 8 frames of the span [sidx, epos) into buf, advancing
+	buf_idx and sidx past them. Each output is ( sample * amp ) >> shift truncated
+	to 16 bits, exactly as the scalar loops in resample() compute it, which
+	then mix the remaining frames.
+*/
+static void mix_blocks( short *buf, unsigned long *buf_idx, signed char *sdat, unsigned long *sidx,
+	unsigned long step, unsigned long epos, short lamp, short ramp, long shift ) {
+#if defined( __SSE2__ )
+	unsigned long idx = *sidx;
+	short *out = buf + *buf_idx;
+	long blocks = 0;
+	__m128i vlamp, vramp, smp, lo, hi, left, right, lshift, hshift;
+	if( step > 0 && idx < epos ) blocks = ( ( epos - idx + step - 1 ) / step ) >> 3;
+	vlamp = _mm_set1_epi16( lamp );
+	vramp = _mm_set1_epi16( ramp );
+	lshift = _mm_cvtsi32_si128( shift );
+	hshift = _mm_cvtsi32_si128( 16 - shift );
+	while( blocks-- > 0 ) {
+		/* The sample fetch is a gather, the arithmetic is 8 lanes wide. */
+		smp = _mm_set_epi16(
+			sdat[ ( idx + step * 7 ) >> FP_SHIFT ], sdat[ ( idx + step * 6 ) >> FP_SHIFT ],
+			sdat[ ( idx + step * 5 ) >> FP_SHIFT ], sdat[ ( idx + step * 4 ) >> FP_SHIFT ],
+			sdat[ ( idx + step * 3 ) >> FP_SHIFT ], sdat[ ( idx + step * 2 ) >> FP_SHIFT ],
+			sdat[ ( idx + step ) >> FP_SHIFT ], sdat[ idx >> FP_SHIFT ] );
+		/* Low 16 bits of the 32-bit product shifted right, from its two halves. */
+		lo = _mm_mullo_epi16( smp, vlamp );
+		hi = _mm_mulhi_epi16( smp, vlamp );
+		left = _mm_or_si128( _mm_srl_epi16( lo, lshift ), _mm_sll_epi16( hi, hshift ) );
+		lo = _mm_mullo_epi16( smp, vramp );
+		hi = _mm_mulhi_epi16( smp, vramp );
+		right = _mm_or_si128( _mm_srl_epi16( lo, lshift ), _mm_sll_epi16( hi, hshift ) );
+		_mm_storeu_si128( ( __m128i * ) out, _mm_add_epi16(
+			_mm_loadu_si128( ( __m128i * ) out ), _mm_unpacklo_epi16( left, right ) ) );
+		_mm_storeu_si128( ( __m128i * ) ( out + 8 ), _mm_add_epi16(
+			_mm_loadu_si128( ( __m128i * ) ( out + 8 ) ), _mm_unpackhi_epi16( left, right ) ) );
+		out += 16;
+		idx += step << 3;
+	}
+	*buf_idx = out - buf;
+	*sidx = idx;
+#endif
+}
+
 static void resample( struct micromod_obj* obj, struct micromod_channel *chan, short *buf, long offset, long count ) {
 	unsigned long epos;
 	unsigned long buf_idx = offset << 1;
@@ -405,6 +453,7 @@ static void resample( struct micromod_obj* obj, struct micromod_channel *chan, s
 			if( epos > lep1 ) epos = lep1;
 			if( lamp && ramp ) {
 				/* Mix both channels. */
+				mix_blocks( buf, &buf_idx, sdat, &sidx, step, epos, lamp, ramp, 2 );
 				while( sidx < epos ) {
 					ampl = sdat[ sidx >> FP_SHIFT ];
 					buf[ buf_idx++ ] += ampl * lamp >> 2;
@@ -413,6 +462,7 @@ static void resample( struct micromod_obj* obj, struct micromod_channel *chan, s
 				}
 			} else {
 				/* Only mix one channel. */
+				mix_blocks( buf, &buf_idx, sdat, &sidx, step, epos, ramp ? 0 : ampl, ramp ? ampl : 0, 0 );
 				if( ramp ) buf_idx++;
 				while( sidx < epos ) {
 					buf[ buf_idx ] += sdat[ sidx >> FP_SHIFT ] * ampl;
@@ -18,6 +18,7 @@
 #include <exception>
 #include <stdlib.h>
 
+#include "jukebox/Decoders/BlockCacheDecoderImpl.h"
 #include "jukebox/Decoders/FLACDecoderImpl.h"
 #include "SoundFile.h"
 #include "FLACFileImpl.h"
@@ -26,11 +27,11 @@ namespace jukebox {
 
 class FLACFileMemoryLoader : public MemoryFileLoader {
 public:
-	FLACFileMemoryLoader(SoundFileImpl &fileImpl, std::istream& inp) : MemoryFileLoader(fileImpl, inp) {}
+	FLACFileMemoryLoader(SoundFileImpl &fileImpl, std::shared_ptr<ByteSource> source) : MemoryFileLoader(fileImpl, source) {}
 	virtual ~FLACFileMemoryLoader() = default;
 
-	void *createHandler() override {
-		auto ret = drflac_open_memory(memoryBuffer.get(), memoryBufferSize);
+	void *createHandler(ByteReader &) override {
+		auto ret = drflac_open_memory(getMemoryBuffer(), getBufferSize());
 		if (ret == nullptr)
 			throw std::runtime_error("error creating FLAC decoder handler from memory");
 
@@ -40,17 +41,16 @@ public:
 
 class FLACFileStreamLoader : public FileLoader {
 public:
-	FLACFileStreamLoader(SoundFileImpl &fileImpl, std::istream& inp) : FileLoader(fileImpl, inp) {}
+	FLACFileStreamLoader(SoundFileImpl &fileImpl, std::shared_ptr<ByteSource> source) : FileLoader(fileImpl, source) {}
 	virtual ~FLACFileStreamLoader() = default;
 
-	void *createHandler() override {
-		inp.clear();
-		inp.seekg(0, std::ios::beg);
+	void *createHandler(ByteReader &reader) override {
+		reader.seek(0, SEEK_SET);
 
 		auto ret = drflac_open(
 				(drflac_read_proc)dr_libs_read_callback,
 				(drflac_seek_proc)dr_libs_seek_callback,
-				(void *)&inp);
+				(void *)&reader);
 
 		if (ret == nullptr)
 			throw std::runtime_error("error creating FLAC decoder handler from stream");
@@ -64,25 +64,22 @@ void closeFlac(drflac *f) {
 		drflac_close(f);
 }
 
-FLACFileImpl::FLACFileImpl(const std::string& filename, bool onMemory) :
-	SoundFileImpl(),
-	filename(filename),
-	streamBuffer(new std::fstream(this->filename, std::ios::binary|std::ios::in)),
-	inp(*streamBuffer),
-	fileLoader(onMemory?
-		(FileLoader *)new FLACFileMemoryLoader(*this, inp):
-		(FileLoader *)new FLACFileStreamLoader(*this, inp)) {
+FLACFileImpl::FLACFileImpl(const std::string &filename, bool onMemory) :
+	FLACFileImpl(std::make_shared<FileByteSource>(filename), filename, onMemory) {
+}
 
-	load();
+FLACFileImpl::FLACFileImpl(std::istream &inp, bool onMemory) :
+	FLACFileImpl(std::make_shared<StreamByteSource>(inp), ":stream:", onMemory) {
 }
 
-FLACFileImpl::FLACFileImpl(std::istream& inp, bool onMemory) : SoundFileImpl(),
-	filename(":stream:"),
-	inp(inp),
+FLACFileImpl::FLACFileImpl(std::shared_ptr<ByteSource> source, const std::string &filename, bool onMemory) :
+	SoundFileImpl(),
+	filename(filename),
 	fileLoader(onMemory?
-		(FileLoader *)new FLACFileMemoryLoader(*this, inp):
-		(FileLoader *)new FLACFileStreamLoader(*this, inp)) {
+		(FileLoader *)new FLACFileMemoryLoader(*this, source):
+		(FileLoader *)new FLACFileStreamLoader(*this, source)) {
 
+	blockCache = std::make_shared<BlockCache>();
 	load();
 }
 
@@ -102,20 +99,32 @@ const std::string& FLACFileImpl::getFilename() const {
 	return filename;
 }
 
+bool FLACFileImpl::exactSeek() const {
+	return true;
+}
+
 DecoderImpl *FLACFileImpl::makeDecoder() {
-	return new FLACDecoderImpl(*this);
+	return new BlockCacheDecoderImpl(*this, *blockCache, new FLACDecoderImpl(*this));
+}
+
+drflac *FLACFileImpl::createHandler(ByteReader &reader) {
+	return (drflac *)fileLoader->createHandler(reader);
 }
 
-drflac *FLACFileImpl::createHandler() {
-	return (drflac *)fileLoader->createHandler();
+std::shared_ptr<ByteSource> FLACFileImpl::getSource() {
+	return fileLoader->getSource();
 }
 
 void FLACFileImpl::load() {
-	std::unique_ptr<drflac, decltype(&closeFlac)> flacHandler(createHandler(), closeFlac);
+	ByteReader reader(getSource());
+	std::unique_ptr<drflac, decltype(&closeFlac)> flacHandler(createHandler(reader), closeFlac);
 
 	numChannels = flacHandler->channels;
 	sampleRate = flacHandler->sampleRate;
-	bitsPerSample = flacHandler->bitsPerSample <= 16?16:32;
+	if (flacHandler->bitsPerSample <= 16)
+		bitsPerSample = 16;
+	else
+		bitsPerSample = flacHandler->bitsPerSample <= 24?24:32;
 	dataSize = (flacHandler->totalSampleCount * (bitsPerSample >> 3)) ;
 }
 
@@ -30,20 +30,21 @@ class FLACFileImpl : public SoundFileImpl {
 public:
 	FLACFileImpl(const std::string &filename, bool);
 	FLACFileImpl(std::istream &inp, bool);
+	FLACFileImpl(std::shared_ptr<ByteSource> source, const std::string &filename, bool);
 	virtual ~FLACFileImpl() = default;
 	short getNumChannels() const override;
 	int getSampleRate() const override;
 	short getBitsPerSample() const override;
 	const std::string &getFilename() const override;
 	DecoderImpl *makeDecoder() override;
-	drflac *createHandler();
+	bool exactSeek() const override;
+	drflac *createHandler(ByteReader &reader);
+	std::shared_ptr<ByteSource> getSource();
 private:
 	short numChannels = 0;
 	int sampleRate = 0;
 	short bitsPerSample = 0;
 	std::string filename;
-	std::unique_ptr<std::istream> streamBuffer;
-	std::istream &inp;
 	std::unique_ptr<FileLoader> fileLoader;
 
 	void load();
@@ -16,44 +16,37 @@
 #ifndef JUKEBOX_FILEFORMATS_FILELOADER_H_
 #define JUKEBOX_FILEFORMATS_FILELOADER_H_
 
-#include <iostream>
+#include <memory>
 #include "SoundFileImpl.h"
+#include "jukebox/Util/ByteReader.h"
+#include "jukebox/Util/ByteSource.h"
 
 namespace jukebox {
 
 class FileLoader {
 public:
-	FileLoader(SoundFileImpl &fileImpl, std::istream& inp) :
-		fileImpl(fileImpl), inp(inp) {};
+	FileLoader(SoundFileImpl &fileImpl, std::shared_ptr<ByteSource> source) :
+		fileImpl(fileImpl), source(source) {};
 
 	virtual ~FileLoader() = default;
-	virtual void *createHandler() = 0;
+	// the reader (owned by the decoder, outliving the handler) feeds streamed handlers
+	virtual void *createHandler(ByteReader &reader) = 0;
+	std::shared_ptr<ByteSource> getSource() {return source;}
 protected:
 	SoundFileImpl &fileImpl;
-	std::istream& inp;
+	std::shared_ptr<ByteSource> source;
 };
 
 class MemoryFileLoader : public FileLoader {
 public:
-	MemoryFileLoader(SoundFileImpl &fileImpl, std::istream& inp) :
-		FileLoader(fileImpl, inp)	{
-		auto fileStart = inp.tellg();
-		inp.seekg(0, std::ios::end);
-		memoryBufferSize = inp.tellg() - fileStart;
-		inp.seekg(fileStart, std::ios::beg);
-
-		memoryBuffer.reset(new uint8_t[memoryBufferSize]);
-		inp.read((char *)memoryBuffer.get(), memoryBufferSize);
-		inp.seekg(fileStart, std::ios::beg);
+	MemoryFileLoader(SoundFileImpl &fileImpl, std::shared_ptr<ByteSource> source) :
+		FileLoader(fileImpl, source->data() ? source : std::make_shared<MemoryByteSource>(*source))	{
 	};
 
 	virtual ~MemoryFileLoader() = default;
 
-	uint8_t *getMemoryBuffer() {return memoryBuffer.get();}
-	int getBufferSize() {return memoryBufferSize;}
-protected:
-	std::unique_ptr<uint8_t []> memoryBuffer;
-	int memoryBufferSize = 0;
+	const uint8_t *getMemoryBuffer() {return source->data();}
+	int getBufferSize() {return source->size();}
 };
 
 }
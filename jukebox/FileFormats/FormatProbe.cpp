@@ -0,0 +1,147 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "FormatProbe.h"
+extern "C" {
+#include "jukebox/Decoders/micromod/micromod.h"
+}
+
+namespace jukebox {
+
+constexpr size_t FormatProbe::probeSize;
+
+FormatProbe::FormatProbe(std::shared_ptr<ByteSource> source) {
+	auto len = std::min<uint64_t>(probeSize, source->size());
+	if (source->data()) { // nothing to keep, it's all in memory
+		format = identify(*source, source->data(), len);
+		this->source = source;
+	} else {
+		std::vector<uint8_t> head(len);
+		head.resize(source->readAt(0, head.data(), head.size()));
+		format = identify(*source, head.data(), head.size());
+		this->source = std::make_shared<PrefixByteSource>(source, std::move(head));
+	}
+}
+
+FileFormat FormatProbe::getFormat() const {
+	return format;
+}
+
+std::shared_ptr<ByteSource> FormatProbe::getSource() const {
+	return source;
+}
+
+bool FormatProbe::parseMP3Header(const uint8_t *p, MP3Header &header) {
+	static const int bitrates[2][15] = {
+		{0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320},
+		{0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160}};
+	static const int sampleRates[3] = {44100, 48000, 32000};
+
+	int version = (p[1] >> 3) & 3, bitrateIndex = p[2] >> 4, rateIndex = (p[2] >> 2) & 3;
+	if (p[0] != 0xff || (p[1] & 0xe6) != 0xe2 || version == 1 ||
+		bitrateIndex == 0 || bitrateIndex == 15 || rateIndex == 3)
+		return false;
+
+	bool mpeg1 = version == 3;
+	header.sampleRate = sampleRates[rateIndex] >> (mpeg1 ? 0 : version == 2 ? 1 : 2);
+	header.bitrate = bitrates[mpeg1 ? 0 : 1][bitrateIndex] * 1000;
+	header.samplesPerFrame = mpeg1 ? 1152 : 576;
+	header.size = header.samplesPerFrame / 8 * header.bitrate / header.sampleRate + ((p[2] >> 1) & 1);
+	header.channels = (p[3] >> 6) == 3 ? 1 : 2;
+	header.sideInfo = mpeg1 ? (header.channels == 1 ? 17 : 32) : (header.channels == 1 ? 9 : 17);
+	return true;
+}
+
+// len bytes of the frame whose header was parsed, the tag follows its side information
+bool FormatProbe::parseXingHeader(const uint8_t *frame, size_t len, const MP3Header &header, XingHeader &xing) {
+	size_t tag = 4 + header.sideInfo;
+	if (len < tag + 8 || (memcmp(frame + tag, "Xing", 4) != 0 && memcmp(frame + tag, "Info", 4) != 0))
+		return false;
+
+	auto flags = frame[tag + 7];
+	auto p = tag + 8;
+	uint64_t frames = 0;
+	if ((flags & 0x01) && p + 4 <= len) {
+		frames = ((uint64_t)frame[p] << 24) | (frame[p + 1] << 16) | (frame[p + 2] << 8) | frame[p + 3];
+		p += 4;
+	}
+	p += (flags & 0x02 ? 4 : 0) + (flags & 0x04 ? 100 : 0) + (flags & 0x08 ? 4 : 0);
+
+	xing.delay = xing.padding = 0;
+	if (p + 24 <= len && (memcmp(frame + p, "LAME", 4) == 0 ||
+		memcmp(frame + p, "Lavc", 4) == 0 || memcmp(frame + p, "Lavf", 4) == 0)) {
+		xing.delay = (frame[p + 21] << 4) | (frame[p + 22] >> 4);
+		xing.padding = ((frame[p + 22] & 0x0f) << 8) | frame[p + 23];
+	}
+
+	xing.samples = frames * header.samplesPerFrame;
+	xing.samples -= std::min<uint64_t>(xing.samples, xing.delay + xing.padding);
+	return true;
+}
+
+FileFormat FormatProbe::identify(ByteSource &source, const uint8_t *p, size_t len) {
+	static const uint8_t wave64[16] = {'r', 'i', 'f', 'f', 0x2e, 0x91, 0xcf, 0x11, 0xa5, 0xd6, 0x28, 0xdb, 0x04, 0xc1, 0x00, 0x00};
+
+	if ((len >= 12 && memcmp(p, "RIFF", 4) == 0 && memcmp(p + 8, "WAVE", 4) == 0) ||
+		(len >= 16 && memcmp(p, wave64, 16) == 0))
+		return FileFormat::wave;
+
+	if (len >= 4 && memcmp(p, "fLaC", 4) == 0)
+		return FileFormat::flac;
+
+	if (len >= 4 && memcmp(p, "MThd", 4) == 0)
+		return FileFormat::midi;
+
+	if (len >= 4 && memcmp(p, "qoaf", 4) == 0)
+		return FileFormat::qoa;
+
+	if (len >= 27 && memcmp(p, "OggS", 4) == 0) { // by the first packet, after the segment table
+		auto packet = p + 27 + p[26];
+		if (packet + 7 <= p + len && memcmp(packet, "\x01vorbis", 7) == 0)
+			return FileFormat::vorbis;
+		if (packet + 5 <= p + len && memcmp(packet, "\x7f" "FLAC", 5) == 0)
+			return FileFormat::flac;
+		return FileFormat::unknown;
+	}
+
+	if (len >= 10 && memcmp(p, "ID3", 3) == 0) {
+		uint64_t end = 10 + (((p[6] & 0x7f) << 21) | ((p[7] & 0x7f) << 14) | ((p[8] & 0x7f) << 7) | (p[9] & 0x7f)) +
+			((p[5] & 0x10) ? 10 : 0);
+		uint8_t magic[4];
+		bool flac = end + sizeof(magic) <= len ? memcmp(p + end, "fLaC", 4) == 0 :
+			source.readAt(end, magic, sizeof(magic)) == sizeof(magic) && memcmp(magic, "fLaC", 4) == 0;
+		return flac ? FileFormat::flac : FileFormat::mp3;
+	}
+
+	if (len >= 1084 && micromod_calculate_mod_file_len((signed char *)p) > 0)
+		return FileFormat::mod;
+
+	// raw MPEG streams may start with junk, two frames in a row tell them from it
+	MP3Header header, next;
+	for (size_t pos = 0; pos + 4 <= len; ++pos)
+		if (parseMP3Header(p + pos, header) && pos + header.size + 4 <= len &&
+			parseMP3Header(p + pos + header.size, next) && next.sampleRate == header.sampleRate)
+			return FileFormat::mp3;
+
+	return FileFormat::unknown;
+}
+
+} /* namespace jukebox */
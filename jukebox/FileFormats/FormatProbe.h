@@ -0,0 +1,73 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef JUKEBOX_FILEFORMATS_FORMATPROBE_H_
+#define JUKEBOX_FILEFORMATS_FORMATPROBE_H_
+
+#include <cstdint>
+#include <memory>
+#include "jukebox/Util/ByteSource.h"
+
+namespace jukebox {
+
+enum class FileFormat {
+	unknown,
+	wave,
+	vorbis,
+	flac,
+	mp3,
+	midi,
+	mod,
+	qoa
+};
+
+/* Identifies a file by its contents: RIFF/WAVE or Wave64, Ogg Vorbis or
+ * Ogg FLAC, fLaC, an ID3v2 tag (MP3, or FLAC after it), MThd, qoaf,
+ * the Mod signatures and, last, MPEG layer III frame sync. It reads the first
+ * probeSize bytes once (plus 4 past an ID3 tag longer than that), and
+ * getSource() serves them from memory, so the loader doesn't read them
+ * again.
+ */
+class FormatProbe {
+public:
+	struct MP3Header {
+		int sampleRate, bitrate, samplesPerFrame, size, channels, sideInfo;
+	};
+
+	// the Xing/Info frame heading VBR and gapless files, with the LAME (or Lavc/Lavf) extension
+	struct XingHeader {
+		uint64_t samples; // the gapless length, 0 without a frame count
+		int delay, padding; // encoder delay and end padding, 0 without the extension
+	};
+
+	static constexpr size_t probeSize = 4096;
+
+	FormatProbe(std::shared_ptr<ByteSource> source);
+	FileFormat getFormat() const;
+	std::shared_ptr<ByteSource> getSource() const;
+	static bool parseMP3Header(const uint8_t *p, MP3Header &header); // layer III only, as dr_mp3
+	static bool parseXingHeader(const uint8_t *frame, size_t len, const MP3Header &header, XingHeader &xing);
+private:
+	FileFormat format = FileFormat::unknown;
+	std::shared_ptr<ByteSource> source;
+
+	static FileFormat identify(ByteSource &source, const uint8_t *p, size_t len);
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_FILEFORMATS_FORMATPROBE_H_ */
@@ -14,37 +14,38 @@
  */
 
 #include <iostream>
-#include <fstream>
+#include <cmath>
 #include "jukebox/FileFormats/SoundFile.h"
 #include "MIDIFileImpl.h"
 #include "jukebox/Decoders/MIDIDecoderImpl.h"
+#include "jukebox/Decoders/PCMCacheDecoderImpl.h"
 #include "midi/MidiFile.h"
 
 namespace jukebox {
 
 class MIDIFileMemoryLoader : public MemoryFileLoader {
 public:
-	MIDIFileMemoryLoader(SoundFileImpl &fileImpl, std::istream& inp) : MemoryFileLoader(fileImpl, inp) {}
+	MIDIFileMemoryLoader(SoundFileImpl &fileImpl, std::shared_ptr<ByteSource> source) : MemoryFileLoader(fileImpl, source) {}
 	virtual ~MIDIFileMemoryLoader() = default;
 
-	void *createHandler() override {
+	void *createHandler(ByteReader &) override {
 		return nullptr;
 	};
 };
 
-MIDIFileImpl::MIDIFileImpl(const std::string &filename) :
-	SoundFileImpl(),
-	filename(filename) {
+MIDIFileImpl::MIDIFileImpl(const std::string &filename, bool preRender) :
+	MIDIFileImpl(std::make_shared<FileByteSource>(filename), filename, preRender) {
+}
 
-	auto inp = std::fstream(this->filename, std::ios::binary|std::ios::in);
-	load(inp);
+MIDIFileImpl::MIDIFileImpl(std::istream& inp, bool preRender) :
+	MIDIFileImpl(std::make_shared<StreamByteSource>(inp), ":stream:", preRender) {
 }
 
-MIDIFileImpl::MIDIFileImpl(std::istream& inp) :
+MIDIFileImpl::MIDIFileImpl(std::shared_ptr<ByteSource> source, const std::string &filename, bool preRender) :
 	SoundFileImpl(),
-	filename(":stream:") {
+	filename(filename) {
 
-	load(inp);
+	load(source, preRender);
 }
 
 short MIDIFileImpl::getNumChannels() const {
@@ -64,20 +65,57 @@ const std::string& MIDIFileImpl::getFilename() const {
 }
 
 DecoderImpl *MIDIFileImpl::makeDecoder() {
+	if (pcmCache)
+		return new PCMCacheDecoderImpl(*this, *pcmCache, [this](){
+			return new MIDIDecoderImpl(*this);
+		});
+
 	return new MIDIDecoderImpl(*this);
 }
 
-void MIDIFileImpl::load(std::istream& inp) {
-	fileLoader.reset(new MIDIFileMemoryLoader(*this, inp));
+void MIDIFileImpl::load(std::shared_ptr<ByteSource> source, bool preRender) {
+	fileLoader.reset(new MIDIFileMemoryLoader(*this, source));
 
+	ByteSourceStream inp(fileLoader->getSource());
 	smf::MidiFile midiFile(inp);
-	midiFile.sortTracks();
+	midiFile.markSequence(); // keeps the file order of simultaneous events (e.g., RPN sequences)
+	midiFile.joinTracks();
+	midiFile.doTimeAnalysis();
+
+	auto &track = midiFile[0];
+	events.reserve(track.size());
+	for (int i = 0; i < track.size(); ++i) {
+		auto &event = track[i];
+		if (event.empty() || event.isMeta())
+			continue;
+
+		MIDIEvent midiEvent = {
+			(int)std::round(event.seconds * getSampleRate()),
+			event[0], 0, 0, 0, 0};
+
+		if (midiEvent.status == 0xf0 || midiEvent.status == 0xf7) { // payload without F0/F7 framing
+			auto end = event.end();
+			if (event.back() == 0xf7)
+				--end;
+			midiEvent.status = 0xf0;
+			midiEvent.sysexOffset = sysexData.size();
+			sysexData.insert(sysexData.end(), event.begin() + 1, end);
+			midiEvent.sysexLength = sysexData.size() - midiEvent.sysexOffset;
+		} else {
+			midiEvent.data1 = event.size() > 1 ? event[1] : 0;
+			midiEvent.data2 = event.size() > 2 ? event[2] : 0;
+		}
+		events.push_back(midiEvent);
+	}
 
 	dataSize = midiFile.getFileDurationInSeconds()*
 			getSampleRate()*getNumChannels()*(getBitsPerSample()/8);
+
+	if (preRender)
+		pcmCache.reset(new PCMCache(new MIDIDecoderImpl(*this)));
 }
 
-uint8_t* MIDIFileImpl::getMemoryBuffer() {
+const uint8_t* MIDIFileImpl::getMemoryBuffer() {
 	return fileLoader->getMemoryBuffer();
 }
 
@@ -85,4 +123,12 @@ int MIDIFileImpl::getBufferSize() {
 	return fileLoader->getBufferSize();
 }
 
+const std::vector<MIDIEvent> &MIDIFileImpl::getEvents() const {
+	return events;
+}
+
+const std::vector<char> &MIDIFileImpl::getSysexData() const {
+	return sysexData;
+}
+
 } /* namespace jukebox */
@@ -18,28 +18,48 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include "SoundFileImpl.h"
 #include "FileLoader.h"
+#include "PCMCache.h"
 
 namespace jukebox {
 
+/* channel/sysex message of the merged MIDI track, timestamped in
+ * sample frames (tempo changes are already accounted for)
+ */
+struct MIDIEvent {
+	int frame;
+	uint8_t status;
+	uint8_t data1;
+	uint8_t data2;
+	int sysexOffset; // sysex payload position/length in MIDIFileImpl::getSysexData()
+	int sysexLength;
+};
+
 class MIDIFileImpl: public SoundFileImpl {
 public:
-	MIDIFileImpl(const std::string &filename);
-	MIDIFileImpl(std::istream& inp);
+	MIDIFileImpl(const std::string &filename, bool preRender = false);
+	MIDIFileImpl(std::istream& inp, bool preRender = false);
+	MIDIFileImpl(std::shared_ptr<ByteSource> source, const std::string &filename, bool preRender = false);
 	virtual ~MIDIFileImpl() = default;
 	short getNumChannels() const override;
 	int getSampleRate() const override;
 	short getBitsPerSample() const override;
 	const std::string &getFilename() const override;
 	DecoderImpl *makeDecoder() override;
-	uint8_t *getMemoryBuffer();
+	const uint8_t *getMemoryBuffer();
 	int getBufferSize();
+	const std::vector<MIDIEvent> &getEvents() const;
+	const std::vector<char> &getSysexData() const;
 private:
 	std::string filename;
 	std::unique_ptr<MemoryFileLoader> fileLoader;
+	std::vector<MIDIEvent> events;
+	std::vector<char> sysexData;
+	std::unique_ptr<PCMCache> pcmCache; // must be the last member, it renders using the ones above
 
-	void load(std::istream& inp);
+	void load(std::shared_ptr<ByteSource> source, bool preRender);
 };
 
 } /* namespace jukebox */
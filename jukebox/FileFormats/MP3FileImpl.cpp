@@ -19,11 +19,19 @@
 #include <algorithm>
 #include <string.h>
 
+#include "jukebox/Decoders/BlockCacheDecoderImpl.h"
 #include "jukebox/Decoders/MP3DecoderImpl.h"
 #include "SoundFile.h"
+#include "FormatProbe.h"
 #include "MP3FileImpl.h"
 
 #define DR_MP3_IMPLEMENTATION
+/* frames decoded before a seek point, refilling the bit reservoir (up to
+ * 511 bytes) and the overlap/filterbank state, so seeking outputs exactly
+ * what a serial decode does (dr_mp3's 2 are too few at low bitrates). They
+ * must span less than the second between seek points (findSeekPoints()).
+ */
+#define DRMP3_SEEK_LEADING_MP3_FRAMES 10
 #include "jukebox/Decoders/dr_mp3/dr_mp3.h"
 
 namespace jukebox {
@@ -34,10 +42,10 @@ namespace jukebox {
  */
 class MP3FileMemoryLoader : public MemoryFileLoader {
 public:
-	MP3FileMemoryLoader(SoundFileImpl &fileImpl, std::istream& inp) : MemoryFileLoader(fileImpl, inp) {}
+	MP3FileMemoryLoader(SoundFileImpl &fileImpl, std::shared_ptr<ByteSource> source) : MemoryFileLoader(fileImpl, source) {}
 	virtual ~MP3FileMemoryLoader() = default;
 
-	void *createHandler() override {
+	void *createHandler(ByteReader &) override {
 		drmp3_config config = {
 			(uint32_t)fileImpl.getNumChannels(),
 			(uint32_t)fileImpl.getSampleRate()
@@ -45,7 +53,7 @@ public:
 
 		std::unique_ptr<drmp3> ret(new drmp3);
 
-		if (!drmp3_init_memory(ret.get(), (char *)memoryBuffer.get(), memoryBufferSize, &config))
+		if (!drmp3_init_memory(ret.get(), (char *)getMemoryBuffer(), getBufferSize(), &config))
 			throw std::runtime_error("error creating MP3 decoder handler from memory");
 
 		return ret.release();
@@ -54,31 +62,28 @@ public:
 
 /* Stream Loader is useful for large files, when it is not
  * practical to keep the entire encoded sound in memory.
- * The main use case is for background music. It is not possible
- * to play the same sound object simultaneously from a stream (you
- * need to create another sound object from the same file in order
- * to do this)
+ * The main use case is for background music. Each decoder reads
+ * the stream on its own, so it may still play simultaneously.
  */
 class MP3FileStreamLoader : public FileLoader {
 public:
-	MP3FileStreamLoader(SoundFileImpl &fileImpl, std::istream& inp) : FileLoader(fileImpl, inp) {}
+	MP3FileStreamLoader(SoundFileImpl &fileImpl, std::shared_ptr<ByteSource> source) : FileLoader(fileImpl, source) {}
 	virtual ~MP3FileStreamLoader() = default;
 
-	void *createHandler() override {
+	void *createHandler(ByteReader &reader) override {
 		drmp3_config config = {
 			(uint32_t)fileImpl.getNumChannels(),
 			(uint32_t)fileImpl.getSampleRate()
 		};
 
-		inp.clear();
-		inp.seekg(0, std::ios::beg);
+		reader.seek(0, SEEK_SET);
 
 		std::unique_ptr<drmp3> ret(new drmp3);
 		if (!drmp3_init(
 				ret.get(),
 				(drmp3_read_proc)dr_libs_read_callback,
 				(drmp3_seek_proc)dr_libs_seek_callback,
-				(void *)&inp,
+				(void *)&reader,
 				&config)) {
 			throw std::runtime_error("error creating MP3 decoder handler from stream");
 		}
@@ -95,25 +100,21 @@ void closeMP3(drmp3 *f) {
 }
 
 MP3FileImpl::MP3FileImpl(const std::string &filename, bool onMemory) :
-	SoundFileImpl(),
-	filename(filename),
-	streamBuffer(new std::fstream(filename, std::ios::binary|std::ios::in)),
-	inp(*streamBuffer),
-	fileLoader(onMemory?
-		(FileLoader *)new MP3FileMemoryLoader(*this, inp):
-		(FileLoader *)new MP3FileStreamLoader(*this, inp)) {
+	MP3FileImpl(std::make_shared<FileByteSource>(filename), filename, onMemory) {
+}
 
-	load();
+MP3FileImpl::MP3FileImpl(std::istream &inp, bool onMemory) :
+	MP3FileImpl(std::make_shared<StreamByteSource>(inp), ":stream:", onMemory) {
 }
 
-MP3FileImpl::MP3FileImpl(std::istream& inp, bool onMemory) :
+MP3FileImpl::MP3FileImpl(std::shared_ptr<ByteSource> source, const std::string &filename, bool onMemory) :
 	SoundFileImpl(),
-	filename(":stream:"),
-	inp(inp),
+	filename(filename),
 	fileLoader(onMemory?
-		(FileLoader *)new MP3FileMemoryLoader(*this, inp):
-		(FileLoader *)new MP3FileStreamLoader(*this, inp)) {
+		(FileLoader *)new MP3FileMemoryLoader(*this, source):
+		(FileLoader *)new MP3FileStreamLoader(*this, source)) {
 
+	blockCache = std::make_shared<BlockCache>();
 	load();
 }
 
@@ -134,23 +135,89 @@ const std::string& MP3FileImpl::getFilename() const {
 }
 
 void MP3FileImpl::load() {
-	std::unique_ptr<drmp3, decltype(&closeMP3)> mp3(createHandler(), closeMP3);
+	ByteReader reader(getSource());
+	std::unique_ptr<drmp3, decltype(&closeMP3)> mp3(createHandler(reader), closeMP3);
 
 	numChannels = mp3->channels;
 	sampleRate = mp3->mp3FrameSampleRate;
+
+	auto numFrames = drmp3_get_pcm_frame_count(mp3.get());
+	findSeekPoints();
+
 	dataSize =
-		drmp3_get_pcm_frame_count(mp3.get()) *
+		trimGapless(numFrames) *
 		numChannels *
 		(bitsPerSample >> 3) *
 		mp3->mp3FrameSampleRate / mp3->sampleRate;
 }
 
+/* A seek point per second, otherwise dr_mp3 seeks by decoding from the
+ * start. They are in output frames, so they come from a handler set up
+ * like the decoders' (the one load() uses has dr_mp3's default rate).
+ */
+void MP3FileImpl::findSeekPoints() {
+	ByteReader reader(getSource());
+	std::unique_ptr<drmp3, decltype(&closeMP3)> mp3(createHandler(reader), closeMP3);
+
+	drmp3_uint32 count = std::max<uint64_t>(drmp3_get_pcm_frame_count(mp3.get()) / sampleRate, 1);
+	seekPoints.resize(count);
+	if (drmp3_calculate_seek_points(mp3.get(), &count, seekPoints.data()))
+		seekPoints.resize(count);
+	else
+		seekPoints.clear();
+}
+
+/* The Xing/Info frame heading VBR and gapless encoded files decodes to
+ * silence, and its LAME extension gives the encoder delay and the end
+ * padding. Skipping those (plus the decoder delay) lets tracks join
+ * seamlessly. Returns the number of frames left to play.
+ */
+uint64_t MP3FileImpl::trimGapless(uint64_t numFrames) {
+	const uint64_t decoderDelay = 528 + 1;
+	uint8_t header[10], frame[192];
+
+	auto source = getSource();
+	uint64_t offset = 0;
+	if (source->readAt(0, header, sizeof(header)) == sizeof(header) && memcmp(header, "ID3", 3) == 0) {
+		auto tagSize = (header[6] << 21) | (header[7] << 14) | (header[8] << 7) | header[9];
+		offset = 10 + tagSize + ((header[5] & 0x10) ? 10 : 0);
+	}
+
+	FormatProbe::MP3Header mp3;
+	FormatProbe::XingHeader xing;
+	if (source->readAt(offset, frame, sizeof(frame)) < sizeof(frame) || !FormatProbe::parseMP3Header(frame, mp3) ||
+		!FormatProbe::parseXingHeader(frame, sizeof(frame), mp3, xing))
+		return numFrames;
+
+	skipFrames = mp3.samplesPerFrame + (xing.delay || xing.padding ? xing.delay + decoderDelay : 0);
+	if (numFrames <= skipFrames)
+		return numFrames;
+
+	auto available = numFrames - skipFrames;
+	return xing.samples == 0 ? available : std::min(available, xing.samples);
+}
+
+uint64_t MP3FileImpl::getSkipFrames() const {
+	return skipFrames;
+}
+
+bool MP3FileImpl::exactSeek() const {
+	return true;
+}
+
 DecoderImpl *MP3FileImpl::makeDecoder() {
-	return new MP3DecoderImpl(*this);
+	return new BlockCacheDecoderImpl(*this, *blockCache, new MP3DecoderImpl(*this));
+}
+
+drmp3 *MP3FileImpl::createHandler(ByteReader &reader) {
+	auto mp3 = (drmp3 *)fileLoader->createHandler(reader);
+	if (!seekPoints.empty())
+		drmp3_bind_seek_table(mp3, seekPoints.size(), seekPoints.data());
+	return mp3;
 }
 
-drmp3 *MP3FileImpl::createHandler() {
-	return (drmp3 *)fileLoader->createHandler();
+std::shared_ptr<ByteSource> MP3FileImpl::getSource() {
+	return fileLoader->getSource();
 }
 
 } /* namespace jukebox */
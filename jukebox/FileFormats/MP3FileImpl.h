@@ -32,23 +32,29 @@ class MP3FileImpl : public SoundFileImpl {
 public:
 	MP3FileImpl(const std::string &filename, bool);
 	MP3FileImpl(std::istream& inp, bool);
+	MP3FileImpl(std::shared_ptr<ByteSource> source, const std::string &filename, bool);
 	virtual ~MP3FileImpl() = default;
 	short getNumChannels() const override;
 	int getSampleRate() const override;
 	short getBitsPerSample() const override;
 	const std::string &getFilename() const override;
 	DecoderImpl *makeDecoder() override;
-	drmp3 *createHandler();
+	bool exactSeek() const override;
+	drmp3 *createHandler(ByteReader &reader);
+	std::shared_ptr<ByteSource> getSource();
+	uint64_t getSkipFrames() const;
 private:
 	std::string filename;
 	int sampleRate = 0;
 	short numChannels = 0;
 	short bitsPerSample = 16;
-	std::unique_ptr<std::istream> streamBuffer;
-	std::istream &inp;
+	uint64_t skipFrames = 0;
+	std::vector<drmp3_seek_point> seekPoints;
 	std::unique_ptr<FileLoader> fileLoader;
 
 	void load();
+	void findSeekPoints();
+	uint64_t trimGapless(uint64_t numFrames);
 };
 
 } /* namespace jukebox */
@@ -0,0 +1,989 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "MediaScanner.h"
+#include "FormatProbe.h"
+#include "jukebox/Util/ByteSource.h"
+#include "jukebox/Util/FileSystem.h"
+#include "jukebox/Util/QOA.h"
+#include "jukebox/Util/WorkerPool.h"
+extern "C" {
+#include "jukebox/Decoders/micromod/micromod.h"
+}
+
+namespace jukebox {
+
+static uint16_t le16(const uint8_t *p) {
+	return p[0] | (p[1] << 8);
+}
+
+static uint32_t le32(const uint8_t *p) {
+	return le16(p) | ((uint32_t)le16(p + 2) << 16);
+}
+
+static uint64_t le64(const uint8_t *p) {
+	return le32(p) | ((uint64_t)le32(p + 4) << 32);
+}
+
+static uint16_t be16(const uint8_t *p) {
+	return (p[0] << 8) | p[1];
+}
+
+static uint32_t be32(const uint8_t *p) {
+	return ((uint32_t)be16(p) << 16) | be16(p + 2);
+}
+
+static uint32_t syncSafe(const uint8_t *p) {
+	return ((p[0] & 0x7f) << 21) | ((p[1] & 0x7f) << 14) | ((p[2] & 0x7f) << 7) | (p[3] & 0x7f);
+}
+
+static std::vector<uint8_t> readBytes(ByteSource &source, uint64_t offset, uint64_t len) {
+	std::vector<uint8_t> buf(offset < source.size() ? std::min(len, source.size() - offset) : 0);
+	buf.resize(source.readAt(offset, buf.data(), buf.size()));
+	return buf;
+}
+
+static void appendUTF8(std::string &out, uint32_t c) {
+	if (c < 0x80) {
+		out += (char)c;
+	} else if (c < 0x800) {
+		out += (char)(0xc0 | (c >> 6));
+		out += (char)(0x80 | (c & 0x3f));
+	} else if (c < 0x10000) {
+		out += (char)(0xe0 | (c >> 12));
+		out += (char)(0x80 | ((c >> 6) & 0x3f));
+		out += (char)(0x80 | (c & 0x3f));
+	} else {
+		out += (char)(0xf0 | (c >> 18));
+		out += (char)(0x80 | ((c >> 12) & 0x3f));
+		out += (char)(0x80 | ((c >> 6) & 0x3f));
+		out += (char)(0x80 | (c & 0x3f));
+	}
+}
+
+// up to the first NUL
+static std::string latin1(const uint8_t *p, size_t len) {
+	std::string out;
+	for (size_t i = 0; i < len && p[i]; ++i)
+		appendUTF8(out, p[i]);
+	return out;
+}
+
+static std::string utf16(const uint8_t *p, size_t len, bool bigEndian) {
+	std::string out;
+	for (size_t i = 0; i + 1 < len; i += 2) {
+		uint32_t c = bigEndian ? be16(p + i) : le16(p + i);
+		if (c == 0)
+			break;
+		if (c >= 0xd800 && c < 0xdc00 && i + 3 < len) {
+			uint32_t low = bigEndian ? be16(p + i + 2) : le16(p + i + 2);
+			if (low >= 0xdc00 && low < 0xe000) {
+				c = 0x10000 + ((c - 0xd800) << 10) + (low - 0xdc00);
+				i += 2;
+			}
+		}
+		appendUTF8(out, c);
+	}
+	return out;
+}
+
+static bool validUTF8(const uint8_t *p, size_t len) {
+	for (size_t i = 0; i < len; ) {
+		int n = p[i] < 0x80 ? 0 : (p[i] & 0xe0) == 0xc0 ? 1 : (p[i] & 0xf0) == 0xe0 ? 2 : (p[i] & 0xf8) == 0xf0 ? 3 : -1;
+		if (n < 0 || i + n >= len)
+			return false;
+		for (int j = 1; j <= n; ++j)
+			if ((p[i + j] & 0xc0) != 0x80)
+				return false;
+		i += n + 1;
+	}
+	return true;
+}
+
+// untyped text (RIFF INFO, ID3v1, MIDI meta events): UTF-8 when it is valid, Latin-1 otherwise
+static std::string text(const uint8_t *p, size_t len) {
+	len = std::find(p, p + len, 0) - p;
+	return validUTF8(p, len) ? std::string((const char *)p, len) : latin1(p, len);
+}
+
+// the first value of a tag wins, trailing padding is dropped
+static void setTag(MediaInfo &info, const std::string &name, std::string value) {
+	while (!value.empty() && (value.back() == ' ' || value.back() == '\0'))
+		value.pop_back();
+	if (!value.empty())
+		info.tags.emplace(name, value);
+}
+
+static void parseVorbisComments(MediaInfo &info, const uint8_t *p, size_t len) {
+	if (len < 4)
+		return;
+
+	uint64_t pos = 4 + (uint64_t)le32(p); // vendor string
+	if (pos + 4 > len)
+		return;
+
+	auto count = le32(p + pos);
+	pos += 4;
+	for (uint32_t i = 0; i < count && pos + 4 <= len; ++i) {
+		auto size = le32(p + pos);
+		pos += 4;
+		if (size > len - pos)
+			break;
+
+		std::string comment((const char *)p + pos, size);
+		pos += size;
+		auto eq = comment.find('=');
+		if (eq == std::string::npos)
+			continue;
+
+		auto name = comment.substr(0, eq);
+		std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+		if (name != "METADATA_BLOCK_PICTURE")
+			setTag(info, name, comment.substr(eq + 1));
+	}
+}
+
+static void parseRIFFInfo(MediaInfo &info, const uint8_t *p, size_t len) {
+	static const char *names[][2] = {
+		{"INAM", "TITLE"}, {"IART", "ARTIST"}, {"IPRD", "ALBUM"}, {"ICRD", "DATE"},
+		{"ITRK", "TRACKNUMBER"}, {"IPRT", "TRACKNUMBER"}, {"IGNR", "GENRE"},
+		{"ICMT", "COMMENT"}, {"ICOP", "COPYRIGHT"}};
+
+	for (size_t pos = 4; pos + 8 <= len; ) {
+		auto size = std::min<size_t>(le32(p + pos + 4), len - pos - 8);
+		for (auto &name: names)
+			if (memcmp(p + pos, name[0], 4) == 0)
+				setTag(info, name[1], text(p + pos + 8, size));
+		pos += 8 + size + (size & 1);
+	}
+}
+
+static void probeWave(ByteSource &source, MediaInfo &info) {
+	uint8_t header[12];
+	if (source.readAt(0, header, sizeof(header)) < sizeof(header) ||
+		memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0)
+		throw std::runtime_error("invalid WAVE file " + info.filename);
+
+	uint64_t offset = sizeof(header), dataSize = 0;
+	uint16_t blockAlign = 0;
+	uint8_t chunk[8];
+	while (source.readAt(offset, chunk, sizeof(chunk)) == sizeof(chunk)) {
+		uint64_t size = le32(chunk + 4), body = offset + sizeof(chunk);
+		if (memcmp(chunk, "fmt ", 4) == 0) {
+			auto fmt = readBytes(source, body, 16);
+			if (fmt.size() == 16) {
+				info.numChannels = le16(&fmt[2]);
+				info.sampleRate = le32(&fmt[4]);
+				blockAlign = le16(&fmt[12]);
+				info.bitsPerSample = le16(&fmt[14]);
+			}
+		} else if (memcmp(chunk, "data", 4) == 0) {
+			dataSize = std::min(size, source.size() - body);
+		} else if (memcmp(chunk, "LIST", 4) == 0) {
+			auto list = readBytes(source, body, std::min<uint64_t>(size, 64 * 1024));
+			if (list.size() >= 4 && memcmp(list.data(), "INFO", 4) == 0)
+				parseRIFFInfo(info, list.data(), list.size());
+		}
+		offset = body + size + (size & 1);
+	}
+
+	if (blockAlign == 0 || info.sampleRate == 0)
+		throw std::runtime_error("invalid WAVE file " + info.filename);
+	info.duration = (double)(dataSize / blockAlign) / info.sampleRate;
+}
+
+static uint64_t id3v2Size(ByteSource &source) {
+	uint8_t header[10];
+	if (source.readAt(0, header, sizeof(header)) < sizeof(header) || memcmp(header, "ID3", 3) != 0)
+		return 0;
+	return 10 + syncSafe(header + 6) + ((header[5] & 0x10) ? 10 : 0);
+}
+
+static std::vector<uint8_t> unsynchronise(const uint8_t *p, size_t len) {
+	std::vector<uint8_t> out;
+	out.reserve(len);
+	for (size_t i = 0; i < len; ++i)
+		if (!(p[i] == 0 && i > 0 && p[i - 1] == 0xff))
+			out.push_back(p[i]);
+	return out;
+}
+
+static std::string id3Text(uint8_t encoding, const uint8_t *p, size_t len) {
+	switch (encoding) {
+	case 0:
+		return latin1(p, len);
+	case 1:
+		if (len >= 2 && (p[0] == 0xff || p[0] == 0xfe))
+			return utf16(p + 2, len - 2, p[0] == 0xfe);
+		return utf16(p, len, true);
+	case 2:
+		return utf16(p, len, true);
+	default:
+		return std::string((const char *)p, std::find(p, p + len, 0) - p);
+	}
+}
+
+// text frames and the description-less comment, returns where the audio starts
+static uint64_t parseID3v2(ByteSource &source, MediaInfo &info) {
+	static const char *names[][3] = { // v2.3/v2.4, v2.2, name
+		{"TIT2", "TT2", "TITLE"}, {"TPE1", "TP1", "ARTIST"}, {"TPE2", "TP2", "ALBUMARTIST"},
+		{"TALB", "TAL", "ALBUM"}, {"TRCK", "TRK", "TRACKNUMBER"}, {"TPOS", "TPA", "DISCNUMBER"},
+		{"TCON", "TCO", "GENRE"}, {"TDRC", "TYE", "DATE"}, {"TYER", "", "DATE"},
+		{"TCOM", "TCM", "COMPOSER"}, {"TCOP", "TCR", "COPYRIGHT"}, {"COMM", "COM", "COMMENT"}};
+
+	auto end = id3v2Size(source);
+	uint8_t header[10];
+	if (end == 0 || source.readAt(0, header, sizeof(header)) < sizeof(header) || header[3] < 2 || header[3] > 4)
+		return end;
+
+	auto version = header[3];
+	auto tag = readBytes(source, sizeof(header), std::min<uint64_t>(syncSafe(header + 6), 1 << 20)); // cover art comes after the text, usually
+	if ((header[5] & 0x80) && version < 4)
+		tag = unsynchronise(tag.data(), tag.size());
+
+	size_t pos = 0, frameHeader = version == 2 ? 6 : 10;
+	if ((header[5] & 0x40) && version > 2 && tag.size() >= 4) // extended header
+		pos = version == 3 ? 4 + be32(tag.data()) : syncSafe(tag.data());
+
+	while (pos + frameHeader <= tag.size() && tag[pos] != 0) { // zeros are padding
+		std::string id((const char *)&tag[pos], version == 2 ? 3 : 4);
+		size_t size = version == 2 ? (tag[pos + 3] << 16) | (tag[pos + 4] << 8) | tag[pos + 5] :
+			version == 3 ? be32(&tag[pos + 4]) : syncSafe(&tag[pos + 4]);
+		uint16_t flags = version == 2 ? 0 : be16(&tag[pos + 8]);
+		pos += frameHeader;
+		if (size > tag.size() - pos)
+			break;
+
+		std::vector<uint8_t> frame(tag.begin() + pos, tag.begin() + pos + size);
+		pos += size;
+		if (version == 3) {
+			if (flags & 0xc0) // compressed/encrypted
+				continue;
+			if ((flags & 0x20) && !frame.empty()) // group id
+				frame.erase(frame.begin());
+		} else if (version == 4) {
+			if (flags & 0x0c)
+				continue;
+			if ((flags & 0x40) && !frame.empty())
+				frame.erase(frame.begin());
+			if ((flags & 0x01) && frame.size() >= 4) // data length indicator
+				frame.erase(frame.begin(), frame.begin() + 4);
+			if (flags & 0x02)
+				frame = unsynchronise(frame.data(), frame.size());
+		}
+		if (frame.empty())
+			continue;
+
+		for (auto &name: names) {
+			if (id != name[version == 2 ? 1 : 0])
+				continue;
+
+			auto encoding = frame[0];
+			size_t start = 1;
+			if (id[0] == 'C') { // language, then a description
+				if (frame.size() < 4)
+					break;
+				auto description = id3Text(encoding, &frame[4], frame.size() - 4);
+				if (!description.empty())
+					break;
+				start = 4 + (encoding == 1 || encoding == 2 ? 2 : 1);
+				if (encoding == 1 && frame.size() >= 6 && (frame[4] == 0xff || frame[4] == 0xfe))
+					start += 2; // BOM of the empty description
+				if (start > frame.size())
+					break;
+			}
+			setTag(info, name[2], id3Text(encoding, frame.data() + start, frame.size() - start));
+			break;
+		}
+	}
+	return end;
+}
+
+static void parseID3v1(ByteSource &source, MediaInfo &info) {
+	uint8_t tag[128];
+	if (source.size() < sizeof(tag) || source.readAt(source.size() - sizeof(tag), tag, sizeof(tag)) < sizeof(tag) ||
+		memcmp(tag, "TAG", 3) != 0)
+		return;
+
+	setTag(info, "TITLE", text(tag + 3, 30));
+	setTag(info, "ARTIST", text(tag + 33, 30));
+	setTag(info, "ALBUM", text(tag + 63, 30));
+	setTag(info, "DATE", text(tag + 93, 4));
+	setTag(info, "COMMENT", text(tag + 97, tag[125] == 0 ? 28 : 30));
+	if (tag[125] == 0 && tag[126] != 0)
+		setTag(info, "TRACKNUMBER", std::to_string(tag[126]));
+}
+
+static void probeMP3(ByteSource &source, MediaInfo &info) {
+	auto offset = parseID3v2(source, info);
+	parseID3v1(source, info);
+
+	// the first frame followed by another one
+	auto buf = readBytes(source, offset, 64 * 1024);
+	FormatProbe::MP3Header header, next;
+	size_t pos = 0;
+	for (; pos + 4 <= buf.size(); ++pos)
+		if (FormatProbe::parseMP3Header(&buf[pos], header) &&
+			(pos + header.size + 4 > buf.size() || FormatProbe::parseMP3Header(&buf[pos + header.size], next)))
+			break;
+	if (pos + 4 > buf.size())
+		throw std::runtime_error("invalid MP3 file " + info.filename);
+
+	info.numChannels = header.channels;
+	info.sampleRate = header.sampleRate;
+
+	// the gapless length, as MP3FileImpl::trimGapless()
+	auto frame = &buf[pos];
+	size_t available = buf.size() - pos;
+	FormatProbe::XingHeader xing;
+	if (FormatProbe::parseXingHeader(frame, available, header, xing) && xing.samples > 0) {
+		info.duration = (double)xing.samples / header.sampleRate;
+		return;
+	}
+
+	if (available >= 36 + 18 && memcmp(frame + 36, "VBRI", 4) == 0) {
+		info.duration = (double)be32(frame + 36 + 14) * header.samplesPerFrame / header.sampleRate;
+		return;
+	}
+
+	// constant bitrate
+	uint64_t end = source.size(), start = offset + pos;
+	uint8_t id3v1[3];
+	if (end >= 128 && source.readAt(end - 128, id3v1, 3) == 3 && memcmp(id3v1, "TAG", 3) == 0)
+		end -= 128;
+	info.duration = end > start ? (end - start) * 8.0 / header.bitrate : 0;
+}
+
+// the first packets of the first logical stream, up to 1MB each
+static std::vector<std::vector<uint8_t>> oggPackets(ByteSource &source, size_t count, uint32_t &serial) {
+	std::vector<std::vector<uint8_t>> packets(count);
+	size_t packet = 0;
+	uint64_t offset = 0;
+	serial = 0;
+	while (packet < count) {
+		uint8_t page[27 + 255];
+		if (source.readAt(offset, page, 27) < 27 || memcmp(page, "OggS", 4) != 0 ||
+			source.readAt(offset + 27, page + 27, page[26]) < page[26])
+			break;
+
+		uint64_t size = 0;
+		for (int i = 0; i < page[26]; ++i)
+			size += page[27 + i];
+		auto body = offset + 27 + page[26];
+		bool first = offset == 0;
+		offset = body + size;
+		if (first)
+			serial = le32(page + 14);
+		else if (le32(page + 14) != serial)
+			continue;
+
+		auto data = readBytes(source, body, size);
+		size_t pos = 0;
+		for (int i = 0; i < page[26] && packet < count; ++i) {
+			auto from = std::min(pos, data.size()), to = std::min(pos + page[27 + i], data.size());
+			if (packets[packet].size() < (1 << 20))
+				packets[packet].insert(packets[packet].end(), data.begin() + from, data.begin() + to);
+			pos += page[27 + i];
+			if (page[27 + i] < 255)
+				++packet;
+		}
+	}
+	return packets;
+}
+
+// the granule position of the stream's last page (~0 if none), its length in frames
+static uint64_t oggLastGranule(ByteSource &source, uint32_t serial) {
+	uint64_t tailSize = std::min<uint64_t>(source.size(), 64 * 1024);
+	auto tail = readBytes(source, source.size() - tailSize, tailSize);
+	for (size_t end = tail.size(); end >= 27; --end) {
+		auto p = &tail[end - 27];
+		if (memcmp(p, "OggS", 4) == 0 && le32(p + 14) == serial && le64(p + 6) != ~0ull)
+			return le64(p + 6);
+	}
+	return ~0ull;
+}
+
+// STREAMINFO block body (34 bytes), returns the total frames (0 if unknown)
+static uint64_t parseStreamInfo(MediaInfo &info, const uint8_t *p) {
+	info.sampleRate = (p[10] << 12) | (p[11] << 4) | (p[12] >> 4);
+	info.numChannels = ((p[12] >> 1) & 7) + 1;
+	info.bitsPerSample = (((p[12] & 1) << 4) | (p[13] >> 4)) + 1;
+	return ((uint64_t)(p[13] & 0x0f) << 32) | be32(p + 14);
+}
+
+/* Ogg FLAC: the first packet is 0x7f "FLAC", the mapping version, the
+ * header packet count, "fLaC" and the STREAMINFO block; each header
+ * packet after it holds one metadata block, VORBIS_COMMENT first.
+ */
+static void probeOggFLAC(ByteSource &source, MediaInfo &info) {
+	uint32_t serial;
+	auto packets = oggPackets(source, 2, serial);
+	auto &first = packets[0], &comments = packets[1];
+	if (first.size() < 13 + 4 + 34 || memcmp(&first[0], "\x7f" "FLAC", 5) != 0 ||
+		memcmp(&first[9], "fLaC", 4) != 0 || (first[13] & 0x7f) != 0)
+		throw std::runtime_error("invalid FLAC file " + info.filename);
+
+	auto totalFrames = parseStreamInfo(info, &first[17]);
+	if (info.sampleRate == 0)
+		throw std::runtime_error("invalid FLAC file " + info.filename);
+	if (comments.size() > 4 && (comments[0] & 0x7f) == 4)
+		parseVorbisComments(info, &comments[4], comments.size() - 4);
+
+	if (totalFrames == 0) {
+		auto granule = oggLastGranule(source, serial);
+		totalFrames = granule != ~0ull ? granule : 0;
+	}
+	info.duration = (double)totalFrames / info.sampleRate;
+}
+
+static void probeFLAC(ByteSource &source, MediaInfo &info) {
+	auto offset = id3v2Size(source);
+	uint8_t magic[4];
+	if (source.readAt(offset, magic, sizeof(magic)) == sizeof(magic) && memcmp(magic, "OggS", 4) == 0)
+		return probeOggFLAC(source, info);
+	if (offset + sizeof(magic) > source.size() || memcmp(magic, "fLaC", 4) != 0)
+		throw std::runtime_error("invalid FLAC file " + info.filename);
+
+	uint64_t totalFrames = 0;
+	offset += sizeof(magic);
+	for (bool last = false; !last; ) {
+		uint8_t header[4];
+		if (source.readAt(offset, header, sizeof(header)) < sizeof(header))
+			break;
+
+		last = header[0] & 0x80;
+		auto type = header[0] & 0x7f;
+		uint64_t size = (header[1] << 16) | (header[2] << 8) | header[3];
+		if (type == 0) { // STREAMINFO
+			auto streamInfo = readBytes(source, offset + 4, 34);
+			if (streamInfo.size() == 34)
+				totalFrames = parseStreamInfo(info, streamInfo.data());
+		} else if (type == 4) { // VORBIS_COMMENT
+			auto comments = readBytes(source, offset + 4, std::min<uint64_t>(size, 1 << 20));
+			parseVorbisComments(info, comments.data(), comments.size());
+		}
+		offset += 4 + size;
+	}
+
+	if (info.sampleRate == 0)
+		throw std::runtime_error("invalid FLAC file " + info.filename);
+	info.duration = (double)totalFrames / info.sampleRate;
+}
+
+static void probeVorbis(ByteSource &source, MediaInfo &info) {
+	// identification and comment packets of the first stream
+	uint32_t serial;
+	auto packets = oggPackets(source, 2, serial);
+	auto &ident = packets[0], &comments = packets[1];
+	if (ident.size() < 16 || ident[0] != 1 || memcmp(&ident[1], "vorbis", 6) != 0)
+		throw std::runtime_error("invalid Vorbis file " + info.filename);
+
+	info.numChannels = ident[11];
+	info.sampleRate = le32(&ident[12]);
+	if (info.sampleRate == 0)
+		throw std::runtime_error("invalid Vorbis file " + info.filename);
+	if (comments.size() > 7 && comments[0] == 3 && memcmp(&comments[1], "vorbis", 6) == 0)
+		parseVorbisComments(info, &comments[7], comments.size() - 7);
+
+	// the granule position of the last page is the length, as stb_vorbis
+	auto granule = oggLastGranule(source, serial);
+	if (granule != ~0ull)
+		info.duration = (double)granule / info.sampleRate;
+}
+
+static uint64_t readVLQ(const uint8_t *p, size_t &pos, size_t end) {
+	uint64_t value = 0;
+	for (int i = 0; i < 4 && pos < end; ++i) {
+		value = (value << 7) | (p[pos] & 0x7f);
+		if (!(p[pos++] & 0x80))
+			break;
+	}
+	return value;
+}
+
+// the tempo map and the last event of all tracks, without building a MidiFile
+static void probeMIDI(ByteSource &source, MediaInfo &info) {
+	auto file = readBytes(source, 0, 16 << 20);
+	auto p = file.data();
+	size_t size = file.size();
+	if (size < 14 || memcmp(p, "MThd", 4) != 0)
+		throw std::runtime_error("invalid MIDI file " + info.filename);
+
+	uint16_t numTracks = be16(p + 10), division = be16(p + 12);
+	std::vector<std::pair<uint64_t, uint32_t>> tempos; // tick, microseconds per quarter note
+	uint64_t lastTick = 0;
+	size_t pos = 8 + (size_t)be32(p + 4);
+	for (int track = 0; track < numTracks && pos + 8 <= size; ) {
+		size_t start = pos + 8, end = start + std::min<size_t>(be32(p + pos + 4), size - start);
+		bool isTrack = memcmp(p + pos, "MTrk", 4) == 0;
+		pos = end;
+		if (!isTrack)
+			continue;
+
+		++track;
+		uint64_t tick = 0;
+		uint8_t status = 0;
+		for (size_t i = start; i < end; ) {
+			tick += readVLQ(p, i, end);
+			lastTick = std::max(lastTick, tick);
+			if (i >= end)
+				break;
+			if (p[i] & 0x80)
+				status = p[i++];
+			else if (status < 0x80 || status >= 0xf0) // running status is for channel messages only
+				break;
+
+			if (status == 0xff) {
+				if (i >= end)
+					break;
+				auto type = p[i++];
+				auto len = readVLQ(p, i, end);
+				if (len > end - i)
+					break;
+				if (type == 0x51 && len == 3)
+					tempos.emplace_back(tick, (p[i] << 16) | (p[i + 1] << 8) | p[i + 2]);
+				else if (type == 0x03 && track == 1)
+					setTag(info, "TITLE", text(p + i, len));
+				else if (type == 0x02)
+					setTag(info, "COPYRIGHT", text(p + i, len));
+				else if (type == 0x2f)
+					break;
+				i += len;
+				status = 0;
+			} else if (status == 0xf0 || status == 0xf7) {
+				i += std::min<uint64_t>(readVLQ(p, i, end), end - i);
+				status = 0;
+			} else {
+				i += (status & 0xe0) == 0xc0 ? 1 : 2; // program change and channel pressure have one data byte
+			}
+		}
+	}
+
+	double seconds = 0;
+	if (division & 0x8000) { // SMPTE frames
+		int fps = -(int8_t)(division >> 8);
+		double ticksPerSecond = (fps == 29 ? 29.97 : fps) * (division & 0xff);
+		seconds = ticksPerSecond > 0 ? lastTick / ticksPerSecond : 0;
+	} else if (division != 0) {
+		std::stable_sort(tempos.begin(), tempos.end(), [](const std::pair<uint64_t, uint32_t> &a, const std::pair<uint64_t, uint32_t> &b) {
+			return a.first < b.first;
+		});
+		uint64_t tick = 0;
+		double tempo = 500000;
+		for (auto &change: tempos) {
+			if (change.first > lastTick)
+				break;
+			seconds += (change.first - tick) * tempo / 1e6 / division;
+			tick = change.first;
+			tempo = change.second;
+		}
+		seconds += (lastTick - tick) * tempo / 1e6 / division;
+	}
+
+	info.numChannels = 2; // as MIDIFileImpl renders it
+	info.sampleRate = 44100;
+	info.bitsPerSample = 16;
+	info.duration = seconds;
+}
+
+// Mod files hold no length, micromod walks the pattern sequence (without mixing)
+static void probeMod(ByteSource &source, MediaInfo &info) {
+	auto module = readBytes(source, 0, source.size());
+	if (module.size() < 1084 || micromod_calculate_mod_file_len((signed char *)module.data()) <= 0)
+		throw std::runtime_error("invalid Mod file " + info.filename);
+
+	struct micromod_obj mmodobj;
+	if (micromod_initialise_obj(&mmodobj, (signed char *)module.data(), 44100) != 0)
+		throw std::runtime_error("invalid Mod file " + info.filename);
+
+	info.numChannels = 2; // as ModFileImpl renders it
+	info.sampleRate = 44100;
+	info.bitsPerSample = 16;
+	info.duration = micromod_calculate_song_duration_obj(&mmodobj) / 44100.0;
+	setTag(info, "TITLE", text(module.data(), 20));
+}
+
+// the file header has the length, unless it was streamed (0), then the frames do
+static void probeQOA(ByteSource &source, MediaInfo &info) {
+	uint8_t header[qoa::fileHeaderSize + qoa::frameHeaderSize];
+	uint32_t frames;
+	qoa::FrameHeader frame;
+	if (source.readAt(0, header, sizeof(header)) < sizeof(header) || !qoa::readFileHeader(header, frames) ||
+		!qoa::readFrameHeader(header + qoa::fileHeaderSize, frame))
+		throw std::runtime_error("invalid QOA file " + info.filename);
+
+	info.numChannels = frame.numChannels;
+	info.sampleRate = frame.sampleRate;
+	for (uint64_t offset = qoa::fileHeaderSize; frames == 0 &&
+		source.readAt(offset, header, qoa::frameHeaderSize) == qoa::frameHeaderSize &&
+		qoa::readFrameHeader(header, frame); offset += frame.size)
+		info.duration += (double)frame.frames / info.sampleRate;
+	if (frames > 0)
+		info.duration = (double)frames / info.sampleRate;
+}
+
+static std::string extension(const std::string &filename) {
+	auto p = filename.rfind('.');
+	std::string ext = p != std::string::npos ? filename.substr(p + 1) : std::string();
+	std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+	return ext;
+}
+
+struct Probe {
+	const char *name; // the factory's extension, scan() only opens files with one of them
+	void (*probe)(ByteSource &, MediaInfo &);
+};
+
+static const std::map<FileFormat, Probe> probes = {
+	{FileFormat::wave, {"wav", probeWave}}, {FileFormat::mp3, {"mp3", probeMP3}},
+	{FileFormat::flac, {"flac", probeFLAC}}, {FileFormat::vorbis, {"ogg", probeVorbis}},
+	{FileFormat::midi, {"mid", probeMIDI}}, {FileFormat::mod, {"mod", probeMod}},
+	{FileFormat::qoa, {"qoa", probeQOA}}};
+
+static bool knownExtension(const std::string &filename) {
+	auto ext = extension(filename);
+	return std::any_of(probes.begin(), probes.end(), [&ext](const std::pair<const FileFormat, Probe> &probe) {
+		return ext == probe.second.name;
+	});
+}
+
+// by the contents, as the factory loads it
+static MediaInfo probeFile(const std::string &filename, const FileStat &st) {
+	FormatProbe formatProbe(std::make_shared<FileByteSource>(filename));
+	auto probe = probes.find(formatProbe.getFormat());
+	if (probe == probes.end())
+		throw std::runtime_error("error probing " + filename + ". unknown format");
+
+	MediaInfo info;
+	info.filename = filename;
+	info.format = probe->second.name;
+	info.fileSize = st.size;
+	info.modified = st.modified;
+	probe->second.probe(*formatProbe.getSource(), info);
+	return info;
+}
+
+MediaInfo MediaScanner::probe(const std::string &filename) {
+	return probeFile(filename, statFile(filename));
+}
+
+/* Scan jobs run on the shared pool: a directory job lists it, submits
+ * its subdirectories and its files in batches. scan() waits for the
+ * pending jobs to drop to zero; on a pool worker that could deadlock the
+ * pool, so there the jobs run right away, on that thread.
+ */
+struct ScanState {
+	std::unordered_map<std::string, const MediaInfo *> previous;
+	MediaScanner::Progress progress;
+	std::vector<MediaInfo> entries;
+	std::set<uint64_t> directories; // visited, against symbolic link cycles
+	size_t pending = 0, files = 0, probed = 0;
+	bool serial = false;
+	std::mutex mutex;
+	std::condition_variable cond;
+};
+
+static void submitJob(std::shared_ptr<ScanState> state, std::function<void()> job) {
+	if (state->serial) {
+		try {
+			job();
+		} catch (...) {
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(state->mutex);
+		++state->pending;
+	}
+	WorkerPool::getInstance().submit([state, job](){
+		try {
+			job();
+		} catch (...) {
+			// unreadable directories are left out
+		}
+		{
+			std::lock_guard<std::mutex> lock(state->mutex);
+			--state->pending;
+		}
+		state->cond.notify_all();
+	});
+}
+
+static void scanFiles(std::shared_ptr<ScanState> state, const std::vector<std::pair<std::string, FileStat>> &files) {
+	for (auto &file: files) {
+		MediaInfo info;
+		bool probed = false;
+		auto previous = state->previous.find(file.first);
+		if (previous != state->previous.end() &&
+			previous->second->fileSize == file.second.size &&
+			previous->second->modified == file.second.modified) {
+			info = *previous->second;
+		} else {
+			try {
+				info = probeFile(file.first, file.second);
+				probed = true;
+			} catch (std::exception &) {
+				continue; // not indexed, probed again on the next scan
+			}
+		}
+
+		size_t scanned;
+		{
+			std::lock_guard<std::mutex> lock(state->mutex);
+			state->entries.push_back(std::move(info));
+			state->probed += probed;
+			scanned = ++state->files;
+		}
+		if (state->progress)
+			state->progress(scanned);
+	}
+}
+
+static bool firstVisit(std::shared_ptr<ScanState> state, const FileStat &st) {
+	std::lock_guard<std::mutex> lock(state->mutex);
+	return st.id == 0 || state->directories.insert(st.id).second;
+}
+
+static void scanDirectory(std::shared_ptr<ScanState> state, const std::string &path) {
+	const size_t filesPerJob = 32;
+	auto separator = path.empty() || path.back() == '/' || path.back() == '\\' ? "" : "/";
+
+	std::vector<std::pair<std::string, FileStat>> files;
+	for (auto &name: listDirectory(path)) {
+		auto child = path + separator + name;
+		auto st = statFile(child);
+		if (st.directory) {
+			if (!st.link && firstVisit(state, st))
+				submitJob(state, [state, child](){ scanDirectory(state, child); });
+		} else if (st.exists && knownExtension(child)) {
+			files.emplace_back(child, st);
+		}
+	}
+
+	for (size_t i = 0; i < files.size(); i += filesPerJob) {
+		std::vector<std::pair<std::string, FileStat>> batch(
+			files.begin() + i, files.begin() + std::min(i + filesPerJob, files.size()));
+		submitJob(state, [state, batch](){ scanFiles(state, batch); });
+	}
+}
+
+// entries of a directory start with it and a separator, as scanDirectory() names them
+static bool underPath(const std::string &filename, const std::string &path, bool directory) {
+	if (!directory)
+		return filename == path;
+
+	auto separator = path.empty() || path.back() == '/' || path.back() == '\\' ? "" : "/";
+	auto prefix = path + separator;
+	return filename.compare(0, prefix.size(), prefix) == 0;
+}
+
+size_t MediaScanner::scan(const std::vector<std::string> &paths, Progress progress) {
+	auto state = std::make_shared<ScanState>();
+	for (auto &entry: entries)
+		state->previous.emplace(entry.filename, &entry);
+	state->progress = progress;
+	state->serial = WorkerPool::onWorker();
+
+	std::vector<std::pair<std::string, FileStat>> roots;
+	for (auto &path: paths) {
+		auto st = statFile(path);
+		if (!st.exists)
+			throw std::runtime_error("error scanning " + path);
+		roots.emplace_back(path, st);
+	}
+
+	for (auto &root: roots) {
+		auto path = root.first;
+		if (!root.second.directory)
+			submitJob(state, [state, root](){ scanFiles(state, {root}); });
+		else if (firstVisit(state, root.second))
+			submitJob(state, [state, path](){ scanDirectory(state, path); });
+	}
+
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->cond.wait(lock, [state](){ return state->pending == 0; });
+
+	// entries outside the scanned paths stay as they were
+	auto &scanned = state->entries;
+	for (auto &entry: entries)
+		if (std::none_of(roots.begin(), roots.end(), [&entry](const std::pair<std::string, FileStat> &root) {
+			return underPath(entry.filename, root.first, root.second.directory);
+		}))
+			scanned.push_back(std::move(entry));
+
+	std::sort(scanned.begin(), scanned.end(), [](const MediaInfo &a, const MediaInfo &b) {
+		return a.filename < b.filename;
+	});
+	scanned.erase(std::unique(scanned.begin(), scanned.end(), [](const MediaInfo &a, const MediaInfo &b) {
+		return a.filename == b.filename;
+	}), scanned.end());
+	entries = std::move(scanned);
+	return state->probed;
+}
+
+const std::vector<MediaInfo> &MediaScanner::getEntries() const {
+	return entries;
+}
+
+/* The index is little endian: "JBXINDEX", version, count, then the
+ * entries sorted by filename, each one storing only the part of its
+ * filename that differs from the previous entry's.
+ */
+static const char indexMagic[8] = {'J', 'B', 'X', 'I', 'N', 'D', 'E', 'X'};
+static const uint32_t indexVersion = 1;
+
+static void writeU16(std::ostream &out, uint16_t value) {
+	uint8_t bytes[2] = {(uint8_t)value, (uint8_t)(value >> 8)};
+	out.write((const char *)bytes, sizeof(bytes));
+}
+
+static void writeU32(std::ostream &out, uint32_t value) {
+	writeU16(out, value);
+	writeU16(out, value >> 16);
+}
+
+static void writeU64(std::ostream &out, uint64_t value) {
+	writeU32(out, value);
+	writeU32(out, value >> 32);
+}
+
+static void writeString(std::ostream &out, const std::string &value) {
+	writeU32(out, value.size());
+	out.write(value.data(), value.size());
+}
+
+struct IndexReader {
+	const std::vector<uint8_t> &data;
+	size_t pos;
+	bool ok;
+
+	const uint8_t *take(size_t len) {
+		ok = ok && len <= data.size() - pos;
+		if (!ok)
+			return nullptr;
+		pos += len;
+		return &data[pos - len];
+	}
+	uint16_t u16() { auto p = take(2); return p ? le16(p) : 0; }
+	uint32_t u32() { auto p = take(4); return p ? le32(p) : 0; }
+	uint64_t u64() { auto p = take(8); return p ? le64(p) : 0; }
+	std::string string() {
+		auto len = u32();
+		auto p = take(len);
+		return p ? std::string((const char *)p, len) : std::string();
+	}
+};
+
+void MediaScanner::save(const std::string &indexFile) const {
+	auto tmpFile = indexFile + ".tmp";
+	{
+		std::ofstream out(tmpFile, std::ios::binary | std::ios::trunc);
+		if (!out)
+			throw std::runtime_error("error writing " + indexFile);
+
+		out.write(indexMagic, sizeof(indexMagic));
+		writeU32(out, indexVersion);
+		writeU32(out, entries.size());
+		const std::string *last = nullptr;
+		for (auto &entry: entries) {
+			size_t shared = 0;
+			if (last)
+				shared = std::mismatch(last->begin(), last->begin() + std::min(last->size(), entry.filename.size()),
+					entry.filename.begin()).first - last->begin();
+			last = &entry.filename;
+
+			writeU32(out, shared);
+			writeString(out, entry.filename.substr(shared));
+			writeString(out, entry.format);
+			writeU64(out, entry.fileSize);
+			writeU64(out, entry.modified);
+			writeU16(out, entry.numChannels);
+			writeU32(out, entry.sampleRate);
+			writeU16(out, entry.bitsPerSample);
+			uint64_t duration;
+			memcpy(&duration, &entry.duration, sizeof(duration));
+			writeU64(out, duration);
+			writeU32(out, entry.tags.size());
+			for (auto &tag: entry.tags) {
+				writeString(out, tag.first);
+				writeString(out, tag.second);
+			}
+		}
+		if (!out.flush())
+			throw std::runtime_error("error writing " + indexFile);
+	}
+
+	if (!renameFile(tmpFile, indexFile))
+		throw std::runtime_error("error writing " + indexFile);
+}
+
+bool MediaScanner::load(const std::string &indexFile) {
+	entries.clear();
+	std::ifstream in(indexFile, std::ios::binary);
+	if (!in)
+		return false;
+	std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+	IndexReader reader = {data, 0, true};
+	auto magic = reader.take(sizeof(indexMagic));
+	if (!magic || memcmp(magic, indexMagic, sizeof(indexMagic)) != 0 || reader.u32() != indexVersion)
+		return false;
+
+	auto count = reader.u32();
+	std::vector<MediaInfo> loaded;
+	std::string last;
+	for (uint32_t i = 0; i < count && reader.ok; ++i) {
+		MediaInfo entry;
+		auto shared = reader.u32();
+		if (shared > last.size())
+			return false;
+		entry.filename = last.substr(0, shared) + reader.string();
+		entry.format = reader.string();
+		entry.fileSize = reader.u64();
+		entry.modified = reader.u64();
+		entry.numChannels = reader.u16();
+		entry.sampleRate = reader.u32();
+		entry.bitsPerSample = reader.u16();
+		auto duration = reader.u64();
+		memcpy(&entry.duration, &duration, sizeof(duration));
+		auto numTags = reader.u32();
+		for (uint32_t j = 0; j < numTags && reader.ok; ++j) {
+			auto name = reader.string();
+			entry.tags.emplace(name, reader.string());
+		}
+		last = entry.filename;
+		loaded.push_back(std::move(entry));
+	}
+
+	if (!reader.ok)
+		return false;
+	entries = std::move(loaded);
+	return true;
+}
+
+} /* namespace jukebox */
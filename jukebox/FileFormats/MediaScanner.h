@@ -0,0 +1,73 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef JUKEBOX_FILEFORMATS_MEDIASCANNER_H_
+#define JUKEBOX_FILEFORMATS_MEDIASCANNER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+
+namespace jukebox {
+
+/* What a library index needs of a file, read from its headers and tags
+ * only. Tags use Vorbis comment names (TITLE, ARTIST, ALBUM, DATE,
+ * TRACKNUMBER, GENRE...) whatever the format stores, values in UTF-8.
+ */
+struct MediaInfo {
+	std::string filename;
+	std::string format; // the factory's extension: wav, mp3, ogg, flac, mid, mod, qoa
+	uint64_t fileSize = 0;
+	int64_t modified = 0; // last write time, compared on rescans
+	short numChannels = 0;
+	int sampleRate = 0;
+	short bitsPerSample = 0; // as stored (0 if lossy), MIDI/Mod as rendered
+	double duration = 0; // seconds, unrounded (CBR MP3s without a Xing header are estimated)
+	std::map<std::string, std::string> tags;
+};
+
+/* Indexes directories without decoding: durations come from the
+ * Xing/VBRI header (MP3), STREAMINFO (FLAC), the last Ogg page, the data
+ * chunk (WAVE), the tempo map (MIDI), the pattern sequence (Mod) or the
+ * file header (QOA).
+ * Directories are listed and their files probed on the shared worker
+ * pool; files are picked by extension but identified by their contents,
+ * as the factory does. Those whose size and write time match the loaded
+ * index are not read again.
+ */
+class MediaScanner {
+public:
+	using Progress = std::function<void(size_t files)>; // called from the workers
+
+	static MediaInfo probe(const std::string &filename); // throws on unreadable or unsupported files
+	bool load(const std::string &indexFile); // false (and empty) if it can't be read
+	void save(const std::string &indexFile) const;
+	/* rescans the paths (directories, recursively, or files), returns how
+	 * many files were probed. Entries outside them are kept. On a pool
+	 * worker it doesn't wait for the pool, it scans on that thread alone.
+	 */
+	size_t scan(const std::vector<std::string> &paths, Progress progress = nullptr);
+	const std::vector<MediaInfo> &getEntries() const; // sorted by filename
+private:
+	std::vector<MediaInfo> entries;
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_FILEFORMATS_MEDIASCANNER_H_ */
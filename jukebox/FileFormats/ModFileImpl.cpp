@@ -14,10 +14,10 @@
  */
 
 #include <iostream>
-#include <fstream>
 #include "jukebox/FileFormats/SoundFile.h"
 #include "ModFileImpl.h"
 #include "jukebox/Decoders/ModDecoderImpl.h"
+#include "jukebox/Decoders/PCMCacheDecoderImpl.h"
 extern "C" {
 #include "jukebox/Decoders/micromod/micromod.h"
 }
@@ -26,27 +26,27 @@ namespace jukebox {
 
 class ModFileMemoryLoader : public MemoryFileLoader {
 public:
-	ModFileMemoryLoader(SoundFileImpl &fileImpl, std::istream& inp) : MemoryFileLoader(fileImpl, inp) {}
+	ModFileMemoryLoader(SoundFileImpl &fileImpl, std::shared_ptr<ByteSource> source) : MemoryFileLoader(fileImpl, source) {}
 	virtual ~ModFileMemoryLoader() = default;
 
-	void *createHandler() override {
+	void *createHandler(ByteReader &) override {
 		return nullptr;
 	};
 };
 
-ModFileImpl::ModFileImpl(const std::string &filename) :
-	SoundFileImpl(),
-	filename(filename) {
+ModFileImpl::ModFileImpl(const std::string &filename, bool preRender) :
+	ModFileImpl(std::make_shared<FileByteSource>(filename), filename, preRender) {
+}
 
-	auto inp = std::fstream(this->filename, std::ios::binary|std::ios::in);
-	load(inp);
+ModFileImpl::ModFileImpl(std::istream& inp, bool preRender) :
+	ModFileImpl(std::make_shared<StreamByteSource>(inp), ":stream:", preRender) {
 }
 
-ModFileImpl::ModFileImpl(std::istream& inp) :
+ModFileImpl::ModFileImpl(std::shared_ptr<ByteSource> source, const std::string &filename, bool preRender) :
 	SoundFileImpl(),
-	filename(":stream:") {
+	filename(filename) {
 
-	load(inp);
+	load(source, preRender);
 }
 
 short ModFileImpl::getNumChannels() const {
@@ -66,11 +66,16 @@ const std::string& ModFileImpl::getFilename() const {
 }
 
 DecoderImpl *ModFileImpl::makeDecoder() {
+	if (pcmCache)
+		return new PCMCacheDecoderImpl(*this, *pcmCache, [this](){
+			return new ModDecoderImpl(*this);
+		});
+
 	return new ModDecoderImpl(*this);
 }
 
-void ModFileImpl::load(std::istream& inp) {
-	fileLoader.reset(new ModFileMemoryLoader(*this, inp));
+void ModFileImpl::load(std::shared_ptr<ByteSource> source, bool preRender) {
+	fileLoader.reset(new ModFileMemoryLoader(*this, source));
 
     struct micromod_obj mmodobj;
     auto result = micromod_initialise_obj(
@@ -85,9 +90,12 @@ void ModFileImpl::load(std::istream& inp) {
 	dataSize = 
         micromod_calculate_song_duration_obj(&mmodobj) * // num of samples
 		getNumChannels() * (getBitsPerSample()/8); // sample size
+
+	if (preRender)
+		pcmCache.reset(new PCMCache(new ModDecoderImpl(*this)));
 }
 
-uint8_t* ModFileImpl::getMemoryBuffer() {
+const uint8_t* ModFileImpl::getMemoryBuffer() {
 	return fileLoader->getMemoryBuffer();
 }
 
@@ -20,26 +20,29 @@
 #include <string>
 #include "SoundFileImpl.h"
 #include "FileLoader.h"
+#include "PCMCache.h"
 
 namespace jukebox {
 
 class ModFileImpl: public SoundFileImpl {
 public:
-	ModFileImpl(const std::string &filename);
-	ModFileImpl(std::istream& inp);
+	ModFileImpl(const std::string &filename, bool preRender = false);
+	ModFileImpl(std::istream& inp, bool preRender = false);
+	ModFileImpl(std::shared_ptr<ByteSource> source, const std::string &filename, bool preRender = false);
 	virtual ~ModFileImpl() = default;
 	short getNumChannels() const override;
 	int getSampleRate() const override;
 	short getBitsPerSample() const override;
 	const std::string &getFilename() const override;
 	DecoderImpl *makeDecoder() override;
-	uint8_t *getMemoryBuffer();
+	const uint8_t *getMemoryBuffer();
 	int getBufferSize();
 private:
 	std::string filename;
 	std::unique_ptr<MemoryFileLoader> fileLoader;
+	std::unique_ptr<PCMCache> pcmCache; // must be the last member, it renders using the ones above
 
-	void load(std::istream& inp);
+	void load(std::shared_ptr<ByteSource> source, bool preRender);
 };
 
 } /* namespace jukebox */
@@ -0,0 +1,67 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <cstring>
+#include "PCMCache.h"
+#include "jukebox/Util/WorkerPool.h"
+
+namespace jukebox {
+
+PCMCache::PCMCache(DecoderImpl *renderer) :
+	renderer(renderer),
+	dataSize(renderer->getDataSize()),
+	buffer(new char[dataSize]()), // silence past a short rendering
+	renderedSize(0),
+	cancelled(false) {
+
+	rendering = WorkerPool::getInstance().submit([this](){ render(); });
+}
+
+PCMCache::~PCMCache() {
+	cancelled = true;
+	rendering.wait();
+}
+
+bool PCMCache::read(char *buf, int pos, int len) const {
+	len = std::min(len, dataSize - pos);
+	if (len < 0 || pos + len > renderedSize.load(std::memory_order_acquire))
+		return false;
+
+	std::memcpy(buf, buffer.get() + pos, len);
+	return true;
+}
+
+bool PCMCache::rendered() const {
+	return renderedSize.load(std::memory_order_acquire) == dataSize;
+}
+
+void PCMCache::render() {
+	const int chunkSize = renderer->getBlockSize() * 4096;
+
+	int pos = 0;
+	while (pos < dataSize && !cancelled) {
+		auto len = renderer->getSamples(buffer.get() + pos, pos, std::min(chunkSize, dataSize - pos));
+		if (len <= 0)
+			break;
+
+		pos += len;
+		renderedSize.store(pos, std::memory_order_release);
+	}
+	renderer.reset(); // the synthesizer is not needed anymore
+}
+
+} /* namespace jukebox */
@@ -0,0 +1,51 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef JUKEBOX_FILEFORMATS_PCMCACHE_H_
+#define JUKEBOX_FILEFORMATS_PCMCACHE_H_
+
+#include <memory>
+#include <atomic>
+#include <future>
+#include "jukebox/Decoders/DecoderImpl.h"
+
+namespace jukebox {
+
+/* Decoded PCM of a synthesized (MIDI, Mod) file. Their output is
+ * deterministic, so it is rendered once, in background, on the shared
+ * worker pool and every decoder/prototype of the file streams from
+ * memory instead of running the synthesizer on the playing thread.
+ */
+class PCMCache {
+public:
+	PCMCache(DecoderImpl *renderer); // takes ownership, renders from 0 up to its data size
+	~PCMCache();
+	bool read(char *buf, int pos, int len) const; // false if [pos, pos+len) isn't rendered yet
+	bool rendered() const;
+private:
+	std::unique_ptr<DecoderImpl> renderer;
+	int dataSize;
+	std::unique_ptr<char []> buffer;
+	std::atomic<int> renderedSize;
+	std::atomic<bool> cancelled;
+	std::future<void> rendering;
+
+	void render();
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_FILEFORMATS_PCMCACHE_H_ */
@@ -0,0 +1,95 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <stdexcept>
+#include "Playlist.h"
+
+namespace jukebox {
+
+Playlist::Playlist(float crossfadeSecs) :
+		crossfadeSecs(std::max(0.0f, crossfadeSecs)) {
+}
+
+Playlist& Playlist::add(SoundFile file) {
+	std::lock_guard<std::mutex> lock(tracksMutex);
+
+	if (tracks.empty()) {
+		numChannels = file.getNumChannels();
+		sampleRate = file.getSampleRate();
+		bitsPerSample = file.getBitsPerSample();
+		format = file.getSampleFormat();
+	} else if (file.getNumChannels() != numChannels || file.getSampleRate() != sampleRate)
+		throw std::runtime_error("playlist tracks must have the same sample rate and number of channels.");
+
+	size_t frames = file.getDataSize() / (file.getNumChannels() * sampleSize(file.getSampleFormat()));
+	size_t start = 0, overlap = 0;
+
+	if (!tracks.empty()) {
+		auto &last = tracks.back();
+		size_t crossfade = crossfadeSecs * sampleRate;
+		overlap = std::min(crossfade, std::min(last.frames / 2, frames / 2));
+		last.fadeOut = overlap;
+		start = last.start + last.frames - overlap;
+	}
+
+	tracks.push_back({file, start, frames, overlap, 0});
+	numFrames = start + frames;
+	return *this;
+}
+
+size_t Playlist::size() const {
+	std::lock_guard<std::mutex> lock(tracksMutex);
+	return tracks.size();
+}
+
+Playlist::Track Playlist::getTrack(size_t i) const {
+	std::lock_guard<std::mutex> lock(tracksMutex);
+	return tracks.at(i);
+}
+
+void Playlist::getTracks(size_t first, size_t count, std::vector<std::pair<size_t, Track>> &result) const {
+	std::lock_guard<std::mutex> lock(tracksMutex);
+
+	result.clear();
+	// tracks are sorted by start and end, at most two overlap a frame
+	auto i = std::upper_bound(tracks.begin(), tracks.end(), first,
+			[](size_t frame, const Track &track) { return frame < track.start + track.frames; });
+	for (; i != tracks.end() && i->start < first + count; ++i)
+		result.emplace_back(i - tracks.begin(), *i);
+}
+
+size_t Playlist::getNumFrames() const {
+	return numFrames;
+}
+
+short Playlist::getNumChannels() const {
+	return numChannels;
+}
+
+int Playlist::getSampleRate() const {
+	return sampleRate;
+}
+
+short Playlist::getBitsPerSample() const {
+	return bitsPerSample;
+}
+
+SampleFormat Playlist::getSampleFormat() const {
+	return format;
+}
+
+} /* namespace jukebox */
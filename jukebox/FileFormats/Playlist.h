@@ -0,0 +1,69 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef JUKEBOX_FILEFORMATS_PLAYLIST_H_
+#define JUKEBOX_FILEFORMATS_PLAYLIST_H_
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "SoundFile.h"
+
+namespace jukebox {
+
+/* Sound files played back to back through a single Sound (one output
+ * stream, see factory::makeSound(std::shared_ptr<Playlist>)). While a
+ * track plays, the next one is opened and its start decoded in background,
+ * so transitions are gapless or, with a crossfade, overlap with
+ * equal-power gains. Tracks may be added while playing (at least a
+ * crossfade before the current one ends). The first track sets the
+ * sample rate, channels and format, the others must match its rate and
+ * channels.
+ */
+class Playlist {
+public:
+	struct Track {
+		SoundFile file;
+		size_t start;   // first frame within the playlist
+		size_t frames;
+		size_t fadeIn;  // overlap with the previous track
+		size_t fadeOut; // overlap with the next track
+	};
+
+	Playlist(float crossfadeSecs = 0);
+	Playlist &add(SoundFile file);
+	size_t size() const;
+	Track getTrack(size_t i) const;
+	void getTracks(size_t first, size_t count, std::vector<std::pair<size_t, Track>> &tracks) const; // overlapping [first, first+count)
+	size_t getNumFrames() const;
+	short getNumChannels() const;
+	int getSampleRate() const;
+	short getBitsPerSample() const;
+	SampleFormat getSampleFormat() const;
+private:
+	float crossfadeSecs;
+	mutable std::mutex tracksMutex;
+	std::vector<Track> tracks;
+	std::atomic<size_t> numFrames{0};
+	short numChannels = 0;
+	int sampleRate = 0;
+	short bitsPerSample = 0;
+	SampleFormat format = SampleFormat::S16;
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_FILEFORMATS_PLAYLIST_H_ */
@@ -0,0 +1,67 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include "PlaylistFileImpl.h"
+#include "jukebox/Decoders/PlaylistDecoderImpl.h"
+
+namespace jukebox {
+
+PlaylistFileImpl::PlaylistFileImpl(std::shared_ptr<Playlist> playlist) :
+		SoundFileImpl(),
+		playlist(playlist) {
+
+	if (playlist->size() == 0)
+		throw std::runtime_error("empty playlist.");
+}
+
+short PlaylistFileImpl::getNumChannels() const {
+	return playlist->getNumChannels();
+}
+
+int PlaylistFileImpl::getSampleRate() const {
+	return playlist->getSampleRate();
+}
+
+short PlaylistFileImpl::getBitsPerSample() const {
+	return playlist->getBitsPerSample();
+}
+
+SampleFormat PlaylistFileImpl::getSampleFormat() const {
+	return playlist->getSampleFormat();
+}
+
+const std::string& PlaylistFileImpl::getFilename() const {
+	return filename;
+}
+
+DecoderImpl *PlaylistFileImpl::makeDecoder() {
+	return new PlaylistDecoderImpl(*this);
+}
+
+int PlaylistFileImpl::getDataSize() const {
+	size_t blockSize = getNumChannels() * sampleSize(getSampleFormat());
+	size_t maxFrames = std::numeric_limits<int>::max() / blockSize;
+	return std::min(playlist->getNumFrames(), maxFrames) * blockSize;
+}
+
+Playlist& PlaylistFileImpl::getPlaylist() {
+	return *playlist;
+}
+
+} /* namespace jukebox */
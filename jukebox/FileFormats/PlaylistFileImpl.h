@@ -0,0 +1,46 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef JUKEBOX_FILEFORMATS_PLAYLISTFILEIMPL_H_
+#define JUKEBOX_FILEFORMATS_PLAYLISTFILEIMPL_H_
+
+#include <memory>
+#include <string>
+#include "SoundFileImpl.h"
+#include "Playlist.h"
+
+namespace jukebox {
+
+class PlaylistFileImpl : public SoundFileImpl {
+public:
+	PlaylistFileImpl(std::shared_ptr<Playlist> playlist);
+	virtual ~PlaylistFileImpl() = default;
+	short getNumChannels() const override;
+	int getSampleRate() const override;
+	short getBitsPerSample() const override;
+	SampleFormat getSampleFormat() const override;
+	const std::string &getFilename() const override;
+	DecoderImpl *makeDecoder() override;
+	int getDataSize() const override; // grows as tracks are added
+	Playlist &getPlaylist();
+private:
+	std::shared_ptr<Playlist> playlist;
+	std::string filename = ":playlist:";
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_FILEFORMATS_PLAYLISTFILEIMPL_H_ */
@@ -0,0 +1,144 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <exception>
+
+#include "jukebox/Decoders/QOADecoderImpl.h"
+#include "jukebox/Util/QOA.h"
+#include "SoundFile.h"
+#include "QOAFileImpl.h"
+
+namespace jukebox {
+
+const uint8_t *QOAHandler::read(uint64_t offset, size_t len) {
+	if (memory)
+		return offset + len <= size ? memory + offset : nullptr;
+
+	buffer.resize(len);
+	if (!reader->seek(offset, SEEK_SET) || reader->read(buffer.data(), len) < len)
+		return nullptr;
+	return buffer.data();
+}
+
+class QOAFileMemoryLoader : public MemoryFileLoader {
+public:
+	QOAFileMemoryLoader(SoundFileImpl &fileImpl, std::shared_ptr<ByteSource> source) : MemoryFileLoader(fileImpl, source) {}
+	virtual ~QOAFileMemoryLoader() = default;
+
+	void *createHandler(ByteReader &) override {
+		auto ret = new QOAHandler();
+		ret->memory = getMemoryBuffer();
+		ret->size = getBufferSize();
+		return ret;
+	};
+};
+
+class QOAFileStreamLoader : public FileLoader {
+public:
+	QOAFileStreamLoader(SoundFileImpl &fileImpl, std::shared_ptr<ByteSource> source) : FileLoader(fileImpl, source) {}
+	virtual ~QOAFileStreamLoader() = default;
+
+	void *createHandler(ByteReader &reader) override {
+		auto ret = new QOAHandler();
+		ret->reader = &reader;
+		ret->size = reader.size();
+		return ret;
+	};
+};
+
+QOAFileImpl::QOAFileImpl(const std::string &filename, bool onMemory) :
+	QOAFileImpl(std::make_shared<FileByteSource>(filename), filename, onMemory) {
+}
+
+QOAFileImpl::QOAFileImpl(std::istream &inp, bool onMemory) :
+	QOAFileImpl(std::make_shared<StreamByteSource>(inp), ":stream:", onMemory) {
+}
+
+QOAFileImpl::QOAFileImpl(std::shared_ptr<ByteSource> source, const std::string &filename, bool onMemory) :
+	SoundFileImpl(),
+	filename(filename),
+	fileLoader(onMemory?
+		(FileLoader *)new QOAFileMemoryLoader(*this, source):
+		(FileLoader *)new QOAFileStreamLoader(*this, source)) {
+
+	load();
+}
+
+short QOAFileImpl::getNumChannels() const {
+	return numChannels;
+}
+
+int QOAFileImpl::getSampleRate() const {
+	return sampleRate;
+}
+
+short QOAFileImpl::getBitsPerSample() const {
+	return 16;
+}
+
+const std::string &QOAFileImpl::getFilename() const {
+	return filename;
+}
+
+bool QOAFileImpl::exactSeek() const {
+	return true;
+}
+
+DecoderImpl *QOAFileImpl::makeDecoder() {
+	return new QOADecoderImpl(*this);
+}
+
+QOAHandler *QOAFileImpl::createHandler(ByteReader &reader) {
+	return (QOAHandler *)fileLoader->createHandler(reader);
+}
+
+std::shared_ptr<ByteSource> QOAFileImpl::getSource() {
+	return fileLoader->getSource();
+}
+
+size_t QOAFileImpl::getFrameSize() const {
+	return frameSize;
+}
+
+void QOAFileImpl::load() {
+	ByteReader reader(getSource());
+	std::unique_ptr<QOAHandler> qoaHandler(createHandler(reader));
+
+	uint32_t frames;
+	qoa::FrameHeader header;
+	auto p = qoaHandler->read(0, qoa::fileHeaderSize + qoa::frameHeaderSize);
+	if (p == nullptr || !qoa::readFileHeader(p, frames) || !qoa::readFrameHeader(p + qoa::fileHeaderSize, header))
+		throw std::runtime_error("error loading QOA file " + filename);
+
+	numChannels = header.numChannels;
+	sampleRate = header.sampleRate;
+	frameSize = qoa::frameSize(numChannels, qoa::frameLen);
+
+	// a streamed file (length 0) is as long as its frames
+	if (frames == 0) {
+		uint64_t offset = qoa::fileHeaderSize;
+		while ((p = qoaHandler->read(offset, qoa::frameHeaderSize)) != nullptr &&
+			qoa::readFrameHeader(p, header) && header.numChannels == numChannels) {
+			frames += header.frames;
+			offset += header.size;
+		}
+	}
+
+	dataSize = frames * numChannels * 2;
+}
+
+} /* namespace jukebox */
@@ -0,0 +1,66 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef JUKEBOX_FILEFORMATS_QOAFILEIMPL_H_
+#define JUKEBOX_FILEFORMATS_QOAFILEIMPL_H_
+
+#include <memory>
+#include <vector>
+#include "SoundFileImpl.h"
+#include "FileLoader.h"
+#include "jukebox/Decoders/Decoder.h"
+
+namespace jukebox {
+
+// frames of the file, straight from memory or read through the decoder's reader
+struct QOAHandler {
+	const uint8_t *memory = nullptr;
+	uint64_t size = 0;
+	ByteReader *reader = nullptr;
+	std::vector<uint8_t> buffer;
+
+	const uint8_t *read(uint64_t offset, size_t len); // nullptr past the end
+};
+
+class QOAFileImpl : public SoundFileImpl {
+public:
+	QOAFileImpl(const std::string &filename, bool);
+	QOAFileImpl(std::istream &inp, bool);
+	QOAFileImpl(std::shared_ptr<ByteSource> source, const std::string &filename, bool);
+	virtual ~QOAFileImpl() = default;
+	short getNumChannels() const override;
+	int getSampleRate() const override;
+	short getBitsPerSample() const override;
+	const std::string &getFilename() const override;
+	DecoderImpl *makeDecoder() override;
+	bool exactSeek() const override;
+	QOAHandler *createHandler(ByteReader &reader);
+	std::shared_ptr<ByteSource> getSource();
+	size_t getFrameSize() const; // of every frame but the last one, in bytes
+private:
+	short numChannels = 0;
+	int sampleRate = 0;
+	size_t frameSize = 0;
+	std::string filename;
+	std::unique_ptr<FileLoader> fileLoader;
+
+	void load();
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_FILEFORMATS_QOAFILEIMPL_H_ */
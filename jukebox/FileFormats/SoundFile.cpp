@@ -36,10 +36,30 @@ short SoundFile::getBitsPerSample() const {
 	return impl->getBitsPerSample();
 };
 
+SampleFormat SoundFile::getSampleFormat() const {
+	return impl->getSampleFormat();
+};
+
 int SoundFile::getDataSize() const {
 	return impl->getDataSize();
 };
 
+// loop region in frames, end exclusive (0 when the file has none)
+size_t SoundFile::getLoopStart() const {
+	return impl->getLoopStart();
+};
+
+size_t SoundFile::getLoopEnd() const {
+	return impl->getLoopEnd();
+};
+
+/* decoded blocks (4096 frames) of a compressed file kept for random
+ * access, shared by its decoders; 0 disables the cache
+ */
+void SoundFile::setBlockCacheSize(size_t blocks) {
+	impl->setBlockCacheSize(blocks);
+}
+
 // sound duration in seconds
 double SoundFile::getDuration() const {
 	double rate = impl->getSampleRate();
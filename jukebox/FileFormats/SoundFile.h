@@ -30,7 +30,11 @@ public:
 	short getNumChannels() const;
 	int getSampleRate() const;
 	short getBitsPerSample() const;
+	SampleFormat getSampleFormat() const;
 	int getDataSize() const;
+	size_t getLoopStart() const;
+	size_t getLoopEnd() const;
+	void setBlockCacheSize(size_t blocks);
 	const std::string &getFilename() const;
 	double getDuration() const;
 	void truncAt(int pos);
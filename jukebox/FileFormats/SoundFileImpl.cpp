@@ -14,8 +14,10 @@
  */
 
 #include <algorithm>
-#include <istream>
+#include <cstdio>
 #include "SoundFileImpl.h"
+#include "jukebox/Util/BlockCache.h"
+#include "jukebox/Util/ByteReader.h"
 
 namespace jukebox {
 
@@ -27,21 +29,37 @@ int SoundFileImpl::getDataSize() const {
 	return dataSize;
 };
 
+size_t SoundFileImpl::getLoopStart() const {
+	return loopStart;
+};
+
+size_t SoundFileImpl::getLoopEnd() const {
+	return loopEnd;
+};
+
+bool SoundFileImpl::exactSeek() const {
+	return false;
+}
+
+void SoundFileImpl::setBlockCacheSize(size_t blocks) {
+	if (blockCache)
+		blockCache->setCapacity(blocks);
+}
+
+SampleFormat SoundFileImpl::getSampleFormat() const {
+	return sampleFormat(getBitsPerSample());
+}
+
 int jukebox::SoundFileImpl::silenceLevel() const {
 	return getBitsPerSample() == 8?128:0;
 }
 
 size_t dr_libs_read_callback(void *stream, void *outBuf, size_t len) {
-	auto inp = (std::istream *)stream;
-	inp->clear();
-	return inp->read((char *)outBuf, len).gcount();
+	return ((ByteReader *)stream)->read(outBuf, len);
 }
 
 uint32_t dr_libs_seek_callback(void *stream, int offset, int origin) { // seek origin: 0=start; 1=current
-	auto inp = (std::istream *)stream;
-	inp->clear();
-	inp->seekg(offset, origin==0?std::ios::beg:std::ios::cur);
-	return true;
+	return ((ByteReader *)stream)->seek(offset, origin==0?SEEK_SET:SEEK_CUR);
 }
 
 }
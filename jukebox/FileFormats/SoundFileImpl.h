@@ -18,10 +18,13 @@
 
 #include <string>
 #include <cstdint>
+#include <memory>
 #include "jukebox/Decoders/DecoderImpl.h"
 
 namespace jukebox {
 
+class BlockCache;
+
 extern size_t dr_libs_read_callback(void *stream, void *outBuf, size_t len);
 extern uint32_t dr_libs_seek_callback(void *stream, int offset, int origin);
 
@@ -32,13 +35,20 @@ public:
 	virtual short getNumChannels() const = 0;
 	virtual int getSampleRate() const = 0;
 	virtual short getBitsPerSample() const = 0;
+	virtual SampleFormat getSampleFormat() const; // integer format of getBitsPerSample() by default
 	virtual const std::string &getFilename() const = 0;
 	virtual DecoderImpl *makeDecoder() = 0;
 	virtual int silenceLevel() const;
 	virtual void truncAt(int pos);
 	virtual int getDataSize() const;
+	virtual size_t getLoopStart() const; // loop region embedded in the file, in frames,
+	virtual size_t getLoopEnd() const;   // the end is exclusive (0 when there is none)
+	virtual bool exactSeek() const; // a decoder may start anywhere, outputting what a serial decode does
+	void setBlockCacheSize(size_t blocks);
 protected:
 	int dataSize = 0;
+	size_t loopStart = 0, loopEnd = 0;
+	std::shared_ptr<BlockCache> blockCache; // set by the formats decoding through it
 };
 
 } /* namespace jukebox */
@@ -16,10 +16,14 @@
 #include <fstream>
 #include <istream>
 #include <exception>
+#include <cctype>
+#include <cstring>
+#include <vector>
 #include <stdlib.h>
 
 #define STB_VORBIS_HEADER_ONLY
 #include "jukebox/Decoders/stb_vorbis/stb_vorbis.c"
+#include "jukebox/Decoders/BlockCacheDecoderImpl.h"
 #include "jukebox/Decoders/VorbisDecoderImpl.h"
 #include "SoundFile.h"
 #include "VorbisFileImpl.h"
@@ -28,12 +32,12 @@ namespace jukebox {
 
 class VorbisFileMemoryLoader : public MemoryFileLoader {
 public:
-	VorbisFileMemoryLoader(SoundFileImpl &fileImpl, std::istream& inp) : MemoryFileLoader(fileImpl, inp) {}
+	VorbisFileMemoryLoader(SoundFileImpl &fileImpl, std::shared_ptr<ByteSource> source) : MemoryFileLoader(fileImpl, source) {}
 	virtual ~VorbisFileMemoryLoader() = default;
 
-	void *createHandler() override {
+	void *createHandler(ByteReader &) override {
 		int err;
-		auto ret = stb_vorbis_open_memory(memoryBuffer.get(), memoryBufferSize, &err, nullptr);
+		auto ret = stb_vorbis_open_memory(getMemoryBuffer(), getBufferSize(), &err, nullptr);
 		if (ret == nullptr)
 			throw std::runtime_error("error creating Vorbis decoder handler from memory");
 		return (void *)ret;
@@ -41,40 +45,34 @@ public:
 };
 
 int stb_vorbis_fgetc_cb(void *h) {
-	auto stream = (std::istream *)h;
-	return stream->get();
+	return ((ByteReader *)h)->get();
 }
 
 int stb_vorbis_fseek_cb(void *h, long int off, int dir) {
-	auto stream = (std::istream *)h;
-	stream->seekg(off, (std::ios_base::seekdir)dir);
-	return 0;
+	return ((ByteReader *)h)->seek(off, dir) ? 0 : -1;
 }
 
 long int stb_vorbis_ftell_cb(void *h) {
-	auto stream = (std::istream *)h;
-	return stream->tellg();
+	return ((ByteReader *)h)->tell();
 }
 
 size_t stb_vorbis_fread_cb(void *buf, size_t len, size_t count, void *h) {
-	auto stream = (std::istream *)h;
-	size_t ret = stream->read((char *)buf, len*count).gcount();
+	size_t ret = ((ByteReader *)h)->read(buf, len*count);
 	return ret == (len*count)?count:0;
 }
 
 class VorbisFileStreamLoader : public FileLoader {
 public:
-	VorbisFileStreamLoader(SoundFileImpl &fileImpl, std::istream& inp) : FileLoader(fileImpl, inp) {}
+	VorbisFileStreamLoader(SoundFileImpl &fileImpl, std::shared_ptr<ByteSource> source) : FileLoader(fileImpl, source) {}
 	virtual ~VorbisFileStreamLoader() = default;
 
-	void *createHandler() override {
-		inp.clear();
-		inp.seekg(0, std::ios::beg);
+	void *createHandler(ByteReader &reader) override {
+		reader.seek(0, SEEK_SET);
 
 		int err;
 
 		auto ret = stb_vorbis_open(
-				(void *)&inp,
+				(void *)&reader,
 				&err,
 				nullptr,
 				stb_vorbis_fgetc_cb,
@@ -95,44 +93,131 @@ void closeVorbis(stb_vorbis *v) {
 		stb_vorbis_close(v);
 }
 
-VorbisFileImpl::VorbisFileImpl(const std::string& filename, bool onMemory) :
-	SoundFileImpl(),
-	filename(filename),
-	streamBuffer(new std::fstream(filename, std::ios::binary|std::ios::in)),
-	inp(*streamBuffer),
-	fileLoader(onMemory?
-		(FileLoader *)new VorbisFileMemoryLoader(*this, inp):
-		(FileLoader *)new VorbisFileStreamLoader(*this, inp)) {
+VorbisFileImpl::VorbisFileImpl(const std::string &filename, bool onMemory) :
+	VorbisFileImpl(std::make_shared<FileByteSource>(filename), filename, onMemory) {
+}
 
-	load();
+VorbisFileImpl::VorbisFileImpl(std::istream &inp, bool onMemory) :
+	VorbisFileImpl(std::make_shared<StreamByteSource>(inp), ":stream:", onMemory) {
 }
 
-VorbisFileImpl::VorbisFileImpl(std::istream& inp, bool onMemory) :
+VorbisFileImpl::VorbisFileImpl(std::shared_ptr<ByteSource> source, const std::string &filename, bool onMemory) :
 	SoundFileImpl(),
-	filename(":stream:"),
-	inp(inp),
+	filename(filename),
 	fileLoader(onMemory?
-		(FileLoader *)new VorbisFileMemoryLoader(*this, inp):
-		(FileLoader *)new VorbisFileStreamLoader(*this, inp)) {
+		(FileLoader *)new VorbisFileMemoryLoader(*this, source):
+		(FileLoader *)new VorbisFileStreamLoader(*this, source)) {
 
+	blockCache = std::make_shared<BlockCache>();
 	load();
 }
 
-stb_vorbis* VorbisFileImpl::createHandler() {
-	return (stb_vorbis *)fileLoader->createHandler();
+stb_vorbis *VorbisFileImpl::createHandler(ByteReader &reader) {
+	return (stb_vorbis *)fileLoader->createHandler(reader);
+}
+
+std::shared_ptr<ByteSource> VorbisFileImpl::getSource() {
+	return fileLoader->getSource();
 }
 
 void VorbisFileImpl::load() {
-	std::unique_ptr<stb_vorbis, decltype(&closeVorbis)> vorbisHandler(createHandler(), closeVorbis);
+	ByteReader reader(getSource());
+	std::unique_ptr<stb_vorbis, decltype(&closeVorbis)> vorbisHandler(createHandler(reader), closeVorbis);
 
 	auto vorbisInfo = stb_vorbis_get_info(vorbisHandler.get());
 	numChannels = vorbisInfo.channels;
 	sampleRate = vorbisInfo.sample_rate;
 	dataSize = stb_vorbis_stream_length_in_samples(vorbisHandler.get()) * numChannels * 2;
+	readLoopTags();
+}
+
+/* LOOPSTART and LOOPLENGTH (or LOOPEND) comments give the loop region in
+ * frames. stb_vorbis skips the comment header, the stream's second packet,
+ * so it is gathered here from the first Ogg pages.
+ */
+void VorbisFileImpl::readLoopTags() {
+	const size_t maxPacket = 1 << 24; // cover art can make it big
+	std::vector<uint8_t> packet, body;
+	uint8_t header[27], segments[255];
+	int packets = 0;
+
+	ByteReader reader(getSource(), 1 << 16);
+	while (packets < 2 && packet.size() < maxPacket &&
+		reader.read(header, sizeof(header)) == sizeof(header) && memcmp(header, "OggS", 4) == 0 &&
+		reader.read(segments, header[26]) == header[26]) {
+
+		size_t pageSize = 0;
+		for (int i = 0; i < header[26]; ++i)
+			pageSize += segments[i];
+		body.resize(pageSize);
+		if (reader.read(body.data(), pageSize) != pageSize)
+			break;
+
+		size_t offset = 0;
+		for (int i = 0; i < header[26] && packets < 2; ++i) {
+			if (packets == 1)
+				packet.insert(packet.end(), body.begin() + offset, body.begin() + offset + segments[i]);
+			offset += segments[i];
+			if (segments[i] < 255)
+				++packets;
+		}
+	}
+
+	if (packets < 2 || packet.size() < 11 || packet[0] != 3 || memcmp(&packet[1], "vorbis", 6) != 0)
+		return;
+
+	auto p = packet.data() + 7, last = packet.data() + packet.size();
+	auto read32 = [&p]() {
+		uint32_t v = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+		p += 4;
+		return v;
+	};
+
+	uint32_t vendor = read32();
+	if ((size_t)(last - p) < (size_t)vendor + 4)
+		return;
+	p += vendor;
+
+	size_t start = 0, length = 0, end = 0;
+	bool hasStart = false;
+	for (auto count = read32(); count > 0 && last - p >= 4; --count) {
+		uint32_t len = read32();
+		if ((size_t)(last - p) < len)
+			break;
+
+		std::string comment((const char *)p, len);
+		p += len;
+		auto eq = comment.find('=');
+		if (eq == std::string::npos)
+			continue;
+
+		auto key = comment.substr(0, eq);
+		for (auto &c : key)
+			c = toupper(c);
+		auto value = std::strtoull(comment.c_str() + eq + 1, nullptr, 10);
+		if (key == "LOOPSTART") {
+			start = value;
+			hasStart = true;
+		} else if (key == "LOOPLENGTH")
+			length = value;
+		else if (key == "LOOPEND")
+			end = value;
+	}
+
+	if (hasStart && length > 0)
+		end = start + length;
+	if (hasStart && end > start) {
+		loopStart = start;
+		loopEnd = end;
+	}
+}
+
+bool VorbisFileImpl::exactSeek() const {
+	return true;
 }
 
 DecoderImpl *VorbisFileImpl::makeDecoder() {
-	return new VorbisDecoderImpl(*this);
+	return new BlockCacheDecoderImpl(*this, *blockCache, new VorbisDecoderImpl(*this));
 }
 
 short VorbisFileImpl::getNumChannels() const {
@@ -31,23 +31,25 @@ class VorbisFileImpl : public SoundFileImpl {
 public:
 	VorbisFileImpl(const std::string &filename, bool);
 	VorbisFileImpl(std::istream &inp, bool);
+	VorbisFileImpl(std::shared_ptr<ByteSource> source, const std::string &filename, bool);
 	virtual ~VorbisFileImpl() = default;
 	short getNumChannels() const override;
 	int getSampleRate() const override;
 	short getBitsPerSample() const override;
 	const std::string &getFilename() const override;
 	DecoderImpl *makeDecoder() override;
-	stb_vorbis *createHandler();
+	bool exactSeek() const override;
+	stb_vorbis *createHandler(ByteReader &reader);
+	std::shared_ptr<ByteSource> getSource();
 private:
 	short numChannels = 0;
 	int sampleRate = 0;
 	int fileSize = 0;
 	std::string filename;
-	std::unique_ptr<std::istream> streamBuffer;
-	std::istream &inp;
 	std::unique_ptr<FileLoader> fileLoader;
 
 	void load();
+	void readLoopTags();
 };
 
 } /* namespace jukebox */
@@ -25,11 +25,11 @@ namespace jukebox {
 
 class WaveFileMemoryLoader : public MemoryFileLoader {
 public:
-	WaveFileMemoryLoader(SoundFileImpl &fileImpl, std::istream& inp) : MemoryFileLoader(fileImpl, inp) {}
+	WaveFileMemoryLoader(SoundFileImpl &fileImpl, std::shared_ptr<ByteSource> source) : MemoryFileLoader(fileImpl, source) {}
 	virtual ~WaveFileMemoryLoader() = default;
 
-	void *createHandler() override {
-		auto ret = drwav_open_memory(memoryBuffer.get(), memoryBufferSize);
+	void *createHandler(ByteReader &) override {
+		auto ret = drwav_open_memory(getMemoryBuffer(), getBufferSize());
 		if (ret == nullptr)
 			throw std::runtime_error("error creating WAV decoder handler from memory");
 		return ret;
@@ -38,17 +38,16 @@ public:
 
 class WaveFileStreamLoader : public FileLoader {
 public:
-	WaveFileStreamLoader(SoundFileImpl &fileImpl, std::istream& inp) : FileLoader(fileImpl, inp) {}
+	WaveFileStreamLoader(SoundFileImpl &fileImpl, std::shared_ptr<ByteSource> source) : FileLoader(fileImpl, source) {}
 	virtual ~WaveFileStreamLoader() = default;
 
-	void *createHandler() override {
-		inp.clear();
-		inp.seekg(0, std::ios::beg);
+	void *createHandler(ByteReader &reader) override {
+		reader.seek(0, SEEK_SET);
 
 		auto ret = drwav_open(
 				(drwav_read_proc)dr_libs_read_callback,
 				(drwav_seek_proc)dr_libs_seek_callback,
-				(void *)&inp);
+				(void *)&reader);
 
 		if (ret == nullptr)
 			throw std::runtime_error("error creating WAV decoder handler from stream");
@@ -62,24 +61,20 @@ void closeWav(drwav *f) {
 }
 
 
-WaveFileImpl::WaveFileImpl(const std::string& filename, bool onMemory) :
-	SoundFileImpl(),
-	filename(filename),
-	streamBuffer(new std::fstream(this->filename, std::ios::binary|std::ios::in)),
-	inp(*streamBuffer),
-	fileLoader(onMemory ?
-		static_cast<FileLoader *>(new WaveFileMemoryLoader(*this, inp)) :
-		static_cast<FileLoader *>(new WaveFileStreamLoader(*this, inp))) {
-	load();
+WaveFileImpl::WaveFileImpl(const std::string &filename, bool onMemory) :
+	WaveFileImpl(std::make_shared<FileByteSource>(filename), filename, onMemory) {
 }
 
 WaveFileImpl::WaveFileImpl(std::istream &inp, bool onMemory) :
+	WaveFileImpl(std::make_shared<StreamByteSource>(inp), ":stream:", onMemory) {
+}
+
+WaveFileImpl::WaveFileImpl(std::shared_ptr<ByteSource> source, const std::string &filename, bool onMemory) :
 	SoundFileImpl(),
-	filename(":stream:"),
-	inp(inp),
+	filename(filename),
 	fileLoader(onMemory?
-		(FileLoader *)new WaveFileMemoryLoader(*this, inp):
-		(FileLoader *)new WaveFileStreamLoader(*this, inp)) {
+		(FileLoader *)new WaveFileMemoryLoader(*this, source):
+		(FileLoader *)new WaveFileStreamLoader(*this, source)) {
 
 	load();
 }
@@ -96,25 +91,55 @@ short WaveFileImpl::getBitsPerSample() const {
 	return bitsPerSample;
 }
 
+SampleFormat WaveFileImpl::getSampleFormat() const {
+	return format;
+}
+
 const std::string &WaveFileImpl::getFilename() const {
 	return filename;
 }
 
+bool WaveFileImpl::exactSeek() const {
+	return true;
+}
+
 DecoderImpl *WaveFileImpl::makeDecoder() {
 	return new WaveDecoderImpl(*this);
 }
 
-drwav* WaveFileImpl::createHandler() {
-	return (drwav *)fileLoader->createHandler();
+drwav *WaveFileImpl::createHandler(ByteReader &reader) {
+	return (drwav *)fileLoader->createHandler(reader);
+}
+
+std::shared_ptr<ByteSource> WaveFileImpl::getSource() {
+	return fileLoader->getSource();
 }
 
 void WaveFileImpl::load() {
-	std::unique_ptr<drwav, decltype(&closeWav)> wavHandler(createHandler(), closeWav);
+	ByteReader reader(getSource());
+	std::unique_ptr<drwav, decltype(&closeWav)> wavHandler(createHandler(reader), closeWav);
 
 	numChannels = wavHandler->channels;
 	sampleRate = wavHandler->sampleRate;
 	bitsPerSample = wavHandler->bitsPerSample;
+
+	// PCM is played as is, float as float32, the rest is decoded by dr_wav
+	if (wavHandler->translatedFormatTag == DR_WAVE_FORMAT_IEEE_FLOAT) {
+		bitsPerSample = 32;
+		format = SampleFormat::F32;
+	} else {
+		if (wavHandler->translatedFormatTag != DR_WAVE_FORMAT_PCM)
+			bitsPerSample = bitsPerSample >= 32?32:16;
+		format = sampleFormat(bitsPerSample);
+	}
+
 	dataSize = (wavHandler->totalPCMFrameCount * (bitsPerSample >> 3) * numChannels) ;
+
+	// first sampler loop, its end frame is inclusive
+	if (wavHandler->smpl.numSampleLoops > 0 && wavHandler->smpl.loops[0].start <= wavHandler->smpl.loops[0].end) {
+		loopStart = wavHandler->smpl.loops[0].start;
+		loopEnd = wavHandler->smpl.loops[0].end + 1;
+	}
 }
 
 }
@@ -36,21 +36,24 @@ class WaveFileImpl : public SoundFileImpl {
 public:
 	WaveFileImpl(const std::string &filename, bool);
 	WaveFileImpl(std::istream &inp, bool);
+	WaveFileImpl(std::shared_ptr<ByteSource> source, const std::string &filename, bool);
 	virtual ~WaveFileImpl() = default;
 	short getNumChannels() const override;
 	int getSampleRate() const override;
 	short getBitsPerSample() const override;
+	SampleFormat getSampleFormat() const override;
 	const std::string &getFilename() const override;
 	DecoderImpl *makeDecoder() override;
-	drwav *createHandler();
+	bool exactSeek() const override;
+	drwav *createHandler(ByteReader &reader);
+	std::shared_ptr<ByteSource> getSource();
 private:
 	short numChannels = 0;
 	int sampleRate = 0;
 	int fileSize = 0;
 	short bitsPerSample = 0;
+	SampleFormat format = SampleFormat::S16;
 	std::string filename;
-	std::unique_ptr<std::istream> streamBuffer;
-	std::istream &inp;
 	std::unique_ptr<FileLoader> fileLoader;
 
 	void load();
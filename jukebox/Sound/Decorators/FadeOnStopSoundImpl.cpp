@@ -85,6 +85,26 @@ void FadeOnStopSoundImpl::addTimedEventCallback(size_t seconds, std::function<vo
 	impl->addTimedEventCallback(seconds, te);
 }
 
+void FadeOnStopSoundImpl::addFrameEventCallback(size_t frame, std::function<void(void)> te) {
+	impl->addFrameEventCallback(frame, te);
+}
+
+void FadeOnStopSoundImpl::scheduleStart(uint64_t frame) {
+	impl->scheduleStart(frame);
+}
+
+void FadeOnStopSoundImpl::scheduleStop(uint64_t frame) {
+	impl->scheduleStop(frame);
+}
+
+void FadeOnStopSoundImpl::clearSchedule() {
+	impl->clearSchedule();
+}
+
+void FadeOnStopSoundImpl::setLoopPoints(size_t start, size_t end) {
+	impl->setLoopPoints(start, end);
+}
+
 Decoder &FadeOnStopSoundImpl::getDecoder() {
 	return impl->getDecoder();
 }
@@ -39,6 +39,11 @@ public:
 	std::function<void(void)> popOnStopCallback() override;
 	void clearOnStopStack() override;
 	void addTimedEventCallback(size_t seconds, std::function<void(void)>) override;
+	void addFrameEventCallback(size_t frame, std::function<void(void)>) override;
+	void scheduleStart(uint64_t frame) override;
+	void scheduleStop(uint64_t frame) override;
+	void clearSchedule() override;
+	void setLoopPoints(size_t start, size_t end) override;
 	Decoder &getDecoder() override;
 private:
 	std::unique_ptr<SoundImpl> impl;
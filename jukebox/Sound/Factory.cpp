@@ -3,12 +3,17 @@
 #include <algorithm>
 
 #include "jukebox/Sound/FileWriterSoundImpl.h"
+#include "jukebox/Sound/QOAWriterSoundImpl.h"
 #include "jukebox/FileFormats/MP3FileImpl.h"
 #include "jukebox/FileFormats/VorbisFileImpl.h"
 #include "jukebox/FileFormats/WaveFileImpl.h"
 #include "jukebox/FileFormats/FLACFileImpl.h"
 #include "jukebox/FileFormats/MIDIFileImpl.h"
 #include "jukebox/FileFormats/ModFileImpl.h"
+#include "jukebox/FileFormats/PlaylistFileImpl.h"
+#include "jukebox/FileFormats/QOAFileImpl.h"
+#include "jukebox/FileFormats/FormatProbe.h"
+#include "jukebox/Util/WorkerPool.h"
 
 namespace jukebox {
 namespace factory {
@@ -27,6 +32,10 @@ Sound makeSound(std::istream &inp, const std::string &filename, bool onMemory) {
 	return Sound(makeSoundImpl(new Decoder(loadFromStream(inp, filename, onMemory))));
 }
 
+Sound makeSound(std::shared_ptr<Playlist> playlist) {
+	return Sound(makeSoundImpl(new Decoder(loadPlaylist(playlist))));
+}
+
 Sound makeSoundOutputToFile(SoundFile &file, const std::string &filename) {
 	return Sound(new FileWriterSoundImpl(new Decoder(file), filename));
 }
@@ -35,6 +44,14 @@ Sound makeSoundOutputToFile(const std::string  &inputFile, const std::string &fi
 	return Sound(new FileWriterSoundImpl(new Decoder(loadFile(inputFile, onMemory)), filename));
 }
 
+Sound makeSoundOutputToQOAFile(SoundFile &file, const std::string &filename) {
+	return Sound(new QOAWriterSoundImpl(new Decoder(file), filename));
+}
+
+Sound makeSoundOutputToQOAFile(const std::string &inputFile, const std::string &filename, bool onMemory) {
+	return Sound(new QOAWriterSoundImpl(new Decoder(loadFile(inputFile, onMemory)), filename));
+}
+
 std::string fileExtension(std::string const & filename) {
     auto p = filename.rfind('.');
     std::string extension = p != std::string::npos ? filename.substr(p+1) : std::string();
@@ -42,28 +59,79 @@ std::string fileExtension(std::string const & filename) {
     return extension;
 }
 
-// TODO: add more extensions and/or a way to autodetect the file format
+/* The format comes from the contents, the extension is only a fallback
+ * for those FormatProbe doesn't recognize. name is the loaded file's
+ * name (":stream:" for client streams).
+ */
+static SoundFile loadProbed(std::shared_ptr<ByteSource> source, const std::string &filename, const std::string &name, bool onMemory) {
+    FormatProbe probe(source);
+    auto format = probe.getFormat();
+    if (format == FileFormat::unknown) {
+        auto ext = fileExtension(filename);
+        if (ext == "ogg") format = FileFormat::vorbis;
+        else if (ext == "mp3") format = FileFormat::mp3;
+        else if (ext == "flac") format = FileFormat::flac;
+        else if (ext == "mid") format = FileFormat::midi;
+        else if (ext == "wav") format = FileFormat::wave;
+        else if (ext == "mod") format = FileFormat::mod;
+        else if (ext == "qoa") format = FileFormat::qoa;
+        else throw std::runtime_error("error loading " + filename + ". unknown format, extension " + ext);
+    }
+
+    source = probe.getSource();
+    switch (format) {
+    case FileFormat::vorbis: return SoundFile(new VorbisFileImpl(source, name, onMemory));
+    case FileFormat::mp3: return SoundFile(new MP3FileImpl(source, name, onMemory));
+    case FileFormat::flac: return SoundFile(new FLACFileImpl(source, name, onMemory));
+    case FileFormat::midi: return SoundFile(new MIDIFileImpl(source, name, onMemory));
+    case FileFormat::wave: return SoundFile(new WaveFileImpl(source, name, onMemory));
+    case FileFormat::mod: return SoundFile(new ModFileImpl(source, name, onMemory));
+    case FileFormat::qoa: return SoundFile(new QOAFileImpl(source, name, onMemory));
+    default: throw std::runtime_error("error loading " + filename);
+    }
+}
+
 SoundFile loadFile(const std::string &filename, bool onMemory) {
-    auto ext = fileExtension(filename);
-    if (ext == "ogg") return loadVorbisFile(filename, onMemory);
-    if (ext == "mp3") return loadMP3File(filename, onMemory);
-    if (ext == "flac") return loadFLACFile(filename, onMemory);
-    if (ext == "mid") return loadMIDIFile(filename);
-    if (ext == "wav") return loadWaveFile(filename, onMemory);
-    if (ext == "mod") return loadModFile(filename);
-    throw std::runtime_error("error loading " + filename + ". invalid extension " + ext);
+    return loadProbed(std::make_shared<FileByteSource>(filename), filename, filename, onMemory);
 }
 
-// TODO: add more extensions and/or a way to autodetect the file format
 SoundFile loadFromStream(std::istream &inp, const std::string &filename, bool onMemory) {
-    auto ext = fileExtension(filename);
-    if (ext == "ogg") return loadVorbisStream(inp, onMemory);
-    if (ext == "mp3") return loadMP3Stream(inp, onMemory);
-    if (ext == "flac") return loadFLACStream(inp, onMemory);
-    if (ext == "mid") return loadMIDIStream(inp);
-    if (ext == "wav") return loadWaveStream(inp, onMemory);
-    if (ext == "mod") return loadModStream(inp);
-    throw std::runtime_error("error loading " + filename + ". invalid extension " + ext);
+    return loadProbed(std::make_shared<StreamByteSource>(inp), filename, ":stream:", onMemory);
+}
+
+SoundFile loadFromSource(std::shared_ptr<ByteSource> source, const std::string &filename, bool onMemory) {
+    return loadProbed(source, filename, filename, onMemory);
+}
+
+SoundFile loadPlaylist(std::shared_ptr<Playlist> playlist) {
+    return SoundFile(new PlaylistFileImpl(playlist));
+}
+
+std::future<SoundFile> loadFileAsync(const std::string &filename, bool onMemory) {
+    return WorkerPool::getInstance().submit([filename, onMemory](){
+        return loadFile(filename, onMemory);
+    });
+}
+
+void loadFileAsync(const std::string &filename, std::function<void(SoundFile)> onLoad,
+    std::function<void(std::exception_ptr)> onError, bool onMemory) {
+
+    WorkerPool::getInstance().submit([filename, onLoad, onError, onMemory](){
+        std::unique_ptr<SoundFile> file;
+        try {
+            file.reset(new SoundFile(loadFile(filename, onMemory)));
+        } catch (...) {
+            if (onError)
+                onError(std::current_exception());
+            return;
+        }
+        onLoad(*file);
+    });
+}
+
+LoadBatch loadBatch(const std::vector<std::string> &filenames, bool onMemory,
+    LoadBatch::Progress progress, size_t maxParallel) {
+    return LoadBatch(filenames, onMemory, std::move(progress), maxParallel);
 }
 
 SoundFile loadWaveFile(const std::string &filename, bool onMemory)
@@ -106,20 +174,28 @@ SoundFile loadFLACStream(std::istream &inp, bool onMemory)
     return SoundFile(new FLACFileImpl(inp, onMemory));
 }
 
-SoundFile loadMIDIFile(const std::string &filename) {
-    return SoundFile(new MIDIFileImpl(filename));
+SoundFile loadMIDIFile(const std::string &filename, bool preRender) {
+    return SoundFile(new MIDIFileImpl(filename, preRender));
+}
+
+SoundFile loadMIDIStream(std::istream &inp, bool preRender) {
+    return SoundFile(new MIDIFileImpl(inp, preRender));
+}
+
+SoundFile loadModFile(const std::string &filename, bool preRender) {
+    return SoundFile(new ModFileImpl(filename, preRender));
 }
 
-SoundFile loadMIDIStream(std::istream &inp) {
-    return SoundFile(new MIDIFileImpl(inp));
+SoundFile loadModStream(std::istream &inp, bool preRender) {
+    return SoundFile(new ModFileImpl(inp, preRender));
 }
 
-SoundFile loadModFile(const std::string &filename) {
-    return SoundFile(new ModFileImpl(filename));
+SoundFile loadQOAFile(const std::string &filename, bool onMemory) {
+    return SoundFile(new QOAFileImpl(filename, onMemory));
 }
 
-SoundFile loadModStream(std::istream &inp) {
-    return SoundFile(new ModFileImpl(inp));
+SoundFile loadQOAStream(std::istream &inp, bool onMemory) {
+    return SoundFile(new QOAFileImpl(inp, onMemory));
 }
 
 }
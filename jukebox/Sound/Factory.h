@@ -17,10 +17,16 @@
 #define LIBJUKEBOX_SOUND_FACTORY_2018_03_01_H_
 
 #include <memory>
+#include <future>
+#include <functional>
+#include <exception>
 
 #include "Sound.h"
 #include "SoundImpl.h"
 #include "jukebox/FileFormats/SoundFile.h"
+#include "jukebox/FileFormats/Playlist.h"
+#include "jukebox/Util/ByteSource.h"
+#include "LoadBatch.h"
 
 namespace jukebox {
 namespace factory {
@@ -28,12 +34,36 @@ namespace factory {
 Sound makeSound(SoundFile &file);
 Sound makeSound(const std::string &filename, bool onMemory = false);
 Sound makeSound(std::istream &inp, const std::string &filename, bool onMemory = false);
+Sound makeSound(std::shared_ptr<Playlist> playlist);
 Sound makeSoundOutputToFile(SoundFile &file, const std::string &filename);
 Sound makeSoundOutputToFile(const std::string &inputFile, const std::string &filename, bool onMemory = false);
+// QOA instead of WAVE: 16 bit, up to 8 channels, about a fifth of the size
+Sound makeSoundOutputToQOAFile(SoundFile &file, const std::string &filename);
+Sound makeSoundOutputToQOAFile(const std::string &inputFile, const std::string &filename, bool onMemory = false);
 SoundImpl *makeSoundImpl(Decoder *decoder);
 
+/* For synthesized formats (MIDI, Mod) onMemory/preRender renders the
+ * whole sound to PCM on the worker pool as soon as it is loaded, not
+ * lazily ahead of the play cursor, and keeps it in memory (about 10MB a
+ * minute), so playing it costs the same as WAVE. Until the rendering
+ * gets there, reads are synthesized as without it.
+ * The format is detected from the contents, the filename's extension is
+ * only used when it isn't recognized.
+ */
 SoundFile loadFile(const std::string &filename, bool onMemory = false);
 SoundFile loadFromStream(std::istream &inp, const std::string &filename, bool onMemory = false);
+// e.g. a MappedByteSource, shared by the decoders without copying
+SoundFile loadFromSource(std::shared_ptr<ByteSource> source, const std::string &filename, bool onMemory = false);
+SoundFile loadPlaylist(std::shared_ptr<Playlist> playlist); // plays the playlist as one sound
+
+/* loadFile() on the shared worker pool. The callbacks run on the worker
+ * thread, onError receives what loadFile() would have thrown.
+ */
+std::future<SoundFile> loadFileAsync(const std::string &filename, bool onMemory = false);
+void loadFileAsync(const std::string &filename, std::function<void(SoundFile)> onLoad,
+	std::function<void(std::exception_ptr)> onError = nullptr, bool onMemory = false);
+LoadBatch loadBatch(const std::vector<std::string> &filenames, bool onMemory = false,
+	LoadBatch::Progress progress = nullptr, size_t maxParallel = 0);
 
 SoundFile loadWaveFile(const std::string &filename, bool onMemory = false);
 SoundFile loadWaveStream(std::istream &inp, bool onMemory = false);
@@ -43,10 +73,12 @@ SoundFile loadMP3File(const std::string &filename, bool onMemory = false);
 SoundFile loadMP3Stream(std::istream &inp, bool onMemory = false);
 SoundFile loadFLACFile(const std::string &filename, bool onMemory = false);
 SoundFile loadFLACStream(std::istream &inp, bool onMemory = false);
-SoundFile loadMIDIFile(const std::string &filename);
-SoundFile loadMIDIStream(std::istream &inp);
-SoundFile loadModFile(const std::string &filename);
-SoundFile loadModStream(std::istream &inp);
+SoundFile loadMIDIFile(const std::string &filename, bool preRender = false);
+SoundFile loadMIDIStream(std::istream &inp, bool preRender = false);
+SoundFile loadModFile(const std::string &filename, bool preRender = false);
+SoundFile loadModStream(std::istream &inp, bool preRender = false);
+SoundFile loadQOAFile(const std::string &filename, bool onMemory = false);
+SoundFile loadQOAStream(std::istream &inp, bool onMemory = false);
 
 }
 }
@@ -13,10 +13,12 @@
     along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <memory>
 #include <fstream>
 
 #include "FileWriterSoundImpl.h"
+#include "jukebox/Util/WorkerPool.h"
 
 namespace jukebox {
 
@@ -52,20 +54,25 @@ void FileWriterSoundImpl::play() {
 	waveHeader.numChannels = decoder->getNumChannels();
 	waveHeader.sampleRate = decoder->getSampleRate();
 	waveHeader.bitsPerSample = decoder->getBitsPerSample();
+	if (decoder->getSampleFormat() == SampleFormat::F32)
+		waveHeader.audioFormat = 3; // IEEE float
 	waveHeader.byteRate = waveHeader.sampleRate * waveHeader.numChannels * (waveHeader.bitsPerSample >> 3);
 	waveHeader.blockAlign = waveHeader.numChannels * (waveHeader.bitsPerSample >> 3);
 
 	output.write((char *)&waveHeader, sizeof(WaveHeader));
 
-	int bufSize = waveHeader.blockAlign * 4096;
+	// a second or so per core, decoded in parallel when the decoder allows it, no more than the sound
+	int bufSize = waveHeader.blockAlign * 4096 * 16 * (WorkerPool::getInstance().size() + 1);
+	bufSize = std::max<int>(waveHeader.blockAlign,
+		std::min<int>(bufSize, decoder->getDataSize() / waveHeader.blockAlign * waveHeader.blockAlign));
 	int pos = 0;
 	std::unique_ptr<char []> buf(new char[bufSize]);
 
-	auto len = decoder->getSamples(buf.get(), pos, bufSize);
+	auto len = decoder->getSamplesParallel(buf.get(), pos, bufSize);
 	while (len > 0) {
 		pos += len;
 		output.write(buf.get(), len);
-		len = decoder->getSamples(buf.get(), pos, bufSize);
+		len = decoder->getSamplesParallel(buf.get(), pos, bufSize);
 	}
 	while (!onStopStack.empty()) {
 		onStopStack.back()();
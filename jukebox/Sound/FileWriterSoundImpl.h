@@ -32,7 +32,7 @@ public:
 	void setVolume(int) override;
 	void loop(bool) override;
 	bool playing() const override;
-private:
+protected:
 	std::string filename;
 };
 
@@ -0,0 +1,183 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+#include "LoadBatch.h"
+#include "Factory.h"
+#include "jukebox/Util/WorkerPool.h"
+
+namespace jukebox {
+
+struct LoadBatch::State {
+	std::vector<std::string> filenames;
+	bool onMemory;
+	Progress progress;
+	std::vector<std::unique_ptr<SoundFile>> files;
+	std::vector<std::exception_ptr> errors;
+	size_t next = 0, running = 0, done = 0;
+	bool cancelled = false;
+	bool serial; // made on a worker, loaded by the waiting thread
+	std::mutex mutex;
+	std::condition_variable cond;
+
+	bool finished() const {
+		return running == 0 && (cancelled || next == filenames.size());
+	}
+};
+
+LoadBatch::LoadBatch(const std::vector<std::string> &filenames, bool onMemory,
+	Progress progress, size_t maxParallel) : state(std::make_shared<State>()) {
+
+	state->filenames = filenames;
+	state->onMemory = onMemory;
+	state->progress = std::move(progress);
+	state->files.resize(filenames.size());
+	state->errors.resize(filenames.size());
+	state->serial = WorkerPool::onWorker();
+	if (state->serial)
+		return;
+
+	if (maxParallel == 0)
+		maxParallel = WorkerPool::getInstance().size();
+	for (size_t i = 0; i < maxParallel && i < filenames.size(); ++i)
+		loadNext(state);
+}
+
+LoadBatch::~LoadBatch() {
+	if (state) {
+		cancel();
+		wait();
+	}
+}
+
+// each finished file starts the next one, so the pool isn't held by the batch between files
+void LoadBatch::loadNext(std::shared_ptr<State> state) {
+	size_t i;
+	{
+		std::lock_guard<std::mutex> lock(state->mutex);
+		if (state->cancelled || state->next == state->filenames.size())
+			return;
+		i = state->next++;
+		++state->running;
+	}
+
+	WorkerPool::getInstance().submit([state, i](){
+		load(*state, i);
+		loadNext(state);
+		{
+			std::lock_guard<std::mutex> lock(state->mutex);
+			--state->running;
+		}
+		state->cond.notify_all();
+	});
+}
+
+void LoadBatch::load(State &state, size_t i) {
+	std::unique_ptr<SoundFile> file;
+	std::exception_ptr error;
+	try {
+		file.reset(new SoundFile(factory::loadFile(state.filenames[i], state.onMemory)));
+	} catch (...) {
+		error = std::current_exception();
+	}
+
+	size_t done;
+	{
+		std::lock_guard<std::mutex> lock(state.mutex);
+		state.files[i] = std::move(file);
+		state.errors[i] = error;
+		done = ++state.done;
+	}
+	state.cond.notify_all();
+	// still running, so the batch isn't destroyed while reporting
+	if (state.progress)
+		state.progress(done, state.filenames.size());
+}
+
+// files [next, end) of a serial batch, on this thread
+void LoadBatch::loadSerial(size_t end) {
+	if (!state->serial)
+		return;
+
+	for (;;) {
+		size_t i;
+		{
+			std::lock_guard<std::mutex> lock(state->mutex);
+			if (state->cancelled || state->next >= end)
+				return;
+			i = state->next++;
+			++state->running;
+		}
+		load(*state, i);
+		{
+			std::lock_guard<std::mutex> lock(state->mutex);
+			--state->running;
+		}
+		state->cond.notify_all();
+	}
+}
+
+void LoadBatch::cancel() {
+	std::lock_guard<std::mutex> lock(state->mutex);
+	state->cancelled = true;
+}
+
+void LoadBatch::wait() {
+	loadSerial(size());
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->cond.wait(lock, [this](){ return state->finished(); });
+}
+
+bool LoadBatch::finished() const {
+	std::lock_guard<std::mutex> lock(state->mutex);
+	return state->finished();
+}
+
+size_t LoadBatch::size() const {
+	return state->filenames.size();
+}
+
+size_t LoadBatch::getDone() const {
+	std::lock_guard<std::mutex> lock(state->mutex);
+	return state->done;
+}
+
+SoundFile LoadBatch::get(size_t i) {
+	loadSerial(i + 1);
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->cond.wait(lock, [this, i](){
+		return state->files[i] || state->errors[i] || state->finished();
+	});
+
+	if (state->errors[i])
+		std::rethrow_exception(state->errors[i]);
+	if (!state->files[i])
+		throw std::runtime_error("loading of " + state->filenames[i] + " was cancelled");
+	return *state->files[i];
+}
+
+std::vector<SoundFile> LoadBatch::getAll() {
+	wait();
+	std::vector<SoundFile> files;
+	for (size_t i = 0; i < size(); ++i)
+		files.push_back(get(i));
+	return files;
+}
+
+} /* namespace jukebox */
@@ -0,0 +1,67 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef JUKEBOX_SOUND_LOADBATCH_H_
+#define JUKEBOX_SOUND_LOADBATCH_H_
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include "jukebox/FileFormats/SoundFile.h"
+
+namespace jukebox {
+
+/* Loads a list of files in parallel on the shared worker pool, keeping
+ * at most maxParallel of them (default: the pool size) loading at once.
+ * Files are started in list order; progress is reported on the worker
+ * thread that finished a file, failed ones included. Cancelling skips
+ * the files not started yet. Destroying the batch cancels it and waits
+ * for the files being loaded.
+ * A batch made on a worker thread doesn't use the pool (saturated, it
+ * would never get to the files being waited for): files are loaded
+ * serially by the thread waiting for them, in wait(), get() or getAll().
+ * Don't wait on a worker for a batch made off the pool, its files may be
+ * queued behind the waiting task.
+ */
+class LoadBatch {
+public:
+	using Progress = std::function<void(size_t done, size_t total)>;
+
+	LoadBatch(const std::vector<std::string> &filenames, bool onMemory = false,
+		Progress progress = nullptr, size_t maxParallel = 0);
+	LoadBatch(LoadBatch &&) = default;
+	~LoadBatch();
+	void cancel();
+	void wait(); // until every file is loaded, failed or skipped
+	bool finished() const;
+	size_t size() const;
+	size_t getDone() const;
+	SoundFile get(size_t i); // waits for file i, throws if it failed or was skipped
+	std::vector<SoundFile> getAll(); // waits for all, throws the first failure
+private:
+	struct State;
+	std::shared_ptr<State> state;
+
+	static void loadNext(std::shared_ptr<State> state);
+	static void load(State &state, size_t i);
+	void loadSerial(size_t end);
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_SOUND_LOADBATCH_H_ */
@@ -0,0 +1,275 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include "PCMDiskCache.h"
+#include "Factory.h"
+#include "jukebox/Decoders/Decoder.h"
+#include "jukebox/FileFormats/FormatProbe.h"
+#include "jukebox/FileFormats/WaveFileImpl.h"
+#include "jukebox/Util/ByteSource.h"
+#include "jukebox/Util/WorkerPool.h"
+
+namespace jukebox {
+
+// bump it whenever a decoder changes its output, invalidating every entry
+static const uint32_t cacheVersion = 2;
+
+// an entry starts with it, then the source's filename, the smpl and data chunks follow
+struct CacheHeader {
+	char RIFF[4] = {'R','I','F', 'F'};
+	uint32_t chunkSize;
+	char WAVE[4] = {'W', 'A', 'V', 'E'};
+	char fmt[4] = {'f', 'm', 't', ' '};
+	uint32_t subChunkSize = 0x10;
+
+	uint16_t audioFormat = 1;
+	uint16_t numChannels;
+	uint32_t sampleRate;
+	uint32_t byteRate;
+	uint16_t blockAlign;
+	uint16_t bitsPerSample;
+
+	char key[4] = {'j', 'b', 'x', 'c'}; // skipped by WAVE readers
+	uint32_t keySize;
+	uint32_t version = cacheVersion;
+	uint32_t filenameSize;
+	uint32_t sourceModifiedNanos; // a rewrite within the same second changes it
+	uint64_t sourceSize;
+	int64_t sourceModified;
+};
+static_assert(sizeof(CacheHeader) == 72, "CacheHeader is written as is");
+
+static const uint32_t keyFields = sizeof(CacheHeader) - offsetof(CacheHeader, version);
+
+static bool readHeader(ByteSource &entry, CacheHeader &header, std::string &filename) {
+	if (entry.readAt(0, &header, sizeof(header)) < sizeof(header) ||
+		memcmp(header.RIFF, "RIFF", 4) != 0 || memcmp(header.key, "jbxc", 4) != 0 ||
+		header.version != cacheVersion || header.keySize != keyFields + header.filenameSize)
+		return false;
+
+	filename.resize(header.filenameSize);
+	return entry.readAt(sizeof(header), &filename[0], filename.size()) == filename.size();
+}
+
+static bool sameSource(const CacheHeader &header, const FileStat &source) {
+	return source.exists && header.sourceSize == source.size && header.sourceModified == source.modified &&
+		header.sourceModifiedNanos == source.modifiedNanos;
+}
+
+// its source is still the file it was decoded from
+static bool validEntry(ByteSource &entry, const std::string &filename, const FileStat &source) {
+	CacheHeader header;
+	std::string entryFilename;
+	return readHeader(entry, header, entryFilename) && entryFilename == filename && sameSource(header, source);
+}
+
+PCMDiskCache::PCMDiskCache(const std::string &directory, uint64_t maxSize) :
+	directory(directory),
+	maxSize(maxSize) {
+
+	if (!makeDirectory(directory))
+		throw std::runtime_error("error creating cache directory " + directory);
+}
+
+// FNV-1a of the filename as given
+std::string PCMDiskCache::entryName(const std::string &filename) const {
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (auto c: filename)
+		hash = (hash ^ (uint8_t)c) * 0x100000001b3ull;
+
+	char name[17];
+	snprintf(name, sizeof(name), "%016llx", (unsigned long long)hash);
+	return directory + "/" + name + ".wav";
+}
+
+SoundFile PCMDiskCache::load(const std::string &filename) {
+	auto source = statFile(filename);
+	if (!source.exists)
+		throw std::runtime_error("error opening " + filename);
+
+	auto entry = entryName(filename);
+	if (statFile(entry).exists) {
+		try {
+			auto mapped = std::make_shared<MappedByteSource>(entry);
+			if (validEntry(*mapped, filename, source)) {
+				touchFile(entry);
+				return SoundFile(new WaveFileImpl(mapped, filename, true));
+			}
+		} catch (std::exception &) {
+			// unreadable, stored again
+		}
+	}
+
+	FormatProbe probe(std::make_shared<FileByteSource>(filename));
+	auto file = factory::loadFromSource(probe.getSource(), filename);
+	if (probe.getFormat() == FileFormat::wave || probe.getFormat() == FileFormat::qoa || !store(file, filename, source, entry))
+		return file;
+
+	collectGarbage();
+	try {
+		return SoundFile(new WaveFileImpl(std::make_shared<MappedByteSource>(entry), filename, true));
+	} catch (std::exception &) {
+		return file; // dropped already (larger than maxSize)
+	}
+}
+
+// decodes the file to a temporary name, renamed to the entry when complete
+bool PCMDiskCache::store(SoundFile &file, const std::string &filename, const FileStat &source, const std::string &entry) {
+	static std::atomic<unsigned> counter{0};
+	auto tmpFile = entry + "." +
+		std::to_string(std::chrono::steady_clock::now().time_since_epoch().count() ^
+			std::hash<std::thread::id>()(std::this_thread::get_id())) +
+		"." + std::to_string(counter++) + ".tmp";
+
+	try {
+		Decoder decoder(file);
+		CacheHeader header;
+		header.numChannels = decoder.getNumChannels();
+		header.sampleRate = decoder.getSampleRate();
+		header.bitsPerSample = decoder.getBitsPerSample();
+		if (decoder.getSampleFormat() == SampleFormat::F32)
+			header.audioFormat = 3; // IEEE float
+		header.blockAlign = decoder.getBlockSize();
+		header.byteRate = header.sampleRate * header.blockAlign;
+		header.filenameSize = filename.size();
+		header.keySize = keyFields + header.filenameSize;
+		header.sourceSize = source.size;
+		header.sourceModified = source.modified;
+		header.sourceModifiedNanos = source.modifiedNanos;
+
+		// sampler loop, its end frame is inclusive
+		bool loop = decoder.getLoopEnd() > decoder.getLoopStart();
+		uint32_t smpl[17] = {
+			0x6c706d73, 60, // "smpl"
+			0, 0, 1000000000u / header.sampleRate, 60, 0, 0, 0, 1, 0,
+			0, 0, (uint32_t)decoder.getLoopStart(), (uint32_t)decoder.getLoopEnd() - 1, 0, 0};
+
+		// whole frames only, synthesizers may report a partial one
+		uint32_t dataSize = decoder.getDataSize() / header.blockAlign * header.blockAlign;
+		uint32_t data[2] = {0x61746164, dataSize}; // "data"
+		header.chunkSize = sizeof(header) - 8 + header.filenameSize + (header.filenameSize & 1) +
+			(loop ? sizeof(smpl) : 0) + sizeof(data) + dataSize;
+
+		std::ofstream output(tmpFile, std::ios::binary | std::ios::trunc);
+		output.write((char *)&header, sizeof(header));
+		output.write(filename.data(), filename.size() + (filename.size() & 1)); // the NUL pads it
+		if (loop)
+			output.write((char *)smpl, sizeof(smpl));
+		output.write((char *)data, sizeof(data));
+
+		int bufSize = header.blockAlign * 4096 * 16 * (WorkerPool::getInstance().size() + 1);
+		bufSize = std::max<int>(header.blockAlign, std::min<int>(bufSize, dataSize));
+		std::unique_ptr<char []> buf(new char[bufSize]);
+		uint32_t pos = 0;
+		for (int len; pos < dataSize && (len = decoder.getSamplesParallel(buf.get(), pos, std::min(bufSize, (int)(dataSize - pos)))) > 0; pos += len)
+			output.write(buf.get(), len);
+
+		output.close();
+		auto now = statFile(filename);
+		if (!output || pos != dataSize || now.size != source.size || now.modified != source.modified ||
+			now.modifiedNanos != source.modifiedNanos)
+			throw std::runtime_error("error storing " + filename);
+	} catch (std::exception &) {
+		removeFile(tmpFile);
+		return false;
+	}
+
+	if (!renameFile(tmpFile, entry)) {
+		removeFile(tmpFile);
+		return false;
+	}
+	return true;
+}
+
+static bool isEntry(const std::string &name) {
+	return name.size() == 20 && name.compare(16, 4, ".wav") == 0 &&
+		std::all_of(name.begin(), name.begin() + 16, ::isxdigit);
+}
+
+void PCMDiskCache::collectGarbage() {
+	struct Entry {
+		std::string path;
+		FileStat stat;
+	};
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	std::vector<Entry> entries;
+	for (auto &name: listDirectory(directory)) {
+		auto path = directory + "/" + name;
+		auto st = statFile(path);
+		if (st.directory)
+			continue;
+
+		// left by a crashed store()
+		if (name.size() > 4 && name.compare(name.size() - 4, 4, ".tmp") == 0 && isEntry(name.substr(0, 20))) {
+			if (st.modified < std::time(nullptr) - 3600)
+				removeFile(path);
+			continue;
+		}
+		if (!isEntry(name))
+			continue;
+
+		CacheHeader header;
+		std::string filename;
+		bool valid = false;
+		try {
+			FileByteSource entry(path);
+			valid = readHeader(entry, header, filename);
+		} catch (std::exception &) {
+		}
+		if (!valid || !sameSource(header, statFile(filename)))
+			removeFile(path);
+		else
+			entries.push_back({path, st});
+	}
+
+	// most recently used first
+	std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+		return a.stat.modified > b.stat.modified;
+	});
+
+	uint64_t size = 0;
+	for (auto &entry: entries) {
+		size += entry.stat.size;
+		if (size > maxSize)
+			removeFile(entry.path);
+	}
+}
+
+uint64_t PCMDiskCache::getSize() {
+	uint64_t size = 0;
+	for (auto &name: listDirectory(directory))
+		if (isEntry(name))
+			size += statFile(directory + "/" + name).size;
+	return size;
+}
+
+} /* namespace jukebox */
@@ -0,0 +1,55 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef JUKEBOX_SOUND_PCMDISKCACHE_H_
+#define JUKEBOX_SOUND_PCMDISKCACHE_H_
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include "jukebox/FileFormats/SoundFile.h"
+#include "jukebox/Util/FileSystem.h"
+
+namespace jukebox {
+
+/* Decoded PCM of compressed and synthesized files, kept across runs in
+ * a directory. An entry is a WAVE file (with the loop points as a smpl
+ * chunk) plus a chunk keying it to the source's path, size and write
+ * time and to the cache version; a hit is mapped in memory and played
+ * as is, without decoding. WAVE and QOA (decoding about as fast as
+ * reading) sources are loaded as usual.
+ * Entries are touched when used, the least recently used ones are
+ * dropped beyond maxSize. Several processes may share the directory.
+ */
+class PCMDiskCache {
+public:
+	PCMDiskCache(const std::string &directory, uint64_t maxSize = 1ull << 30);
+	SoundFile load(const std::string &filename); // decodes and stores it on a miss
+	void collectGarbage(); // drops stale (source changed or gone) and least recently used entries
+	uint64_t getSize(); // of the entries, in bytes
+private:
+	std::string directory;
+	uint64_t maxSize;
+	std::mutex cacheMutex;
+
+	std::string entryName(const std::string &filename) const;
+	bool store(SoundFile &file, const std::string &filename, const FileStat &source, const std::string &entry);
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_SOUND_PCMDISKCACHE_H_ */
@@ -0,0 +1,84 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "QOAWriterSoundImpl.h"
+#include "jukebox/Util/QOA.h"
+#include "jukebox/Util/SampleConversion.h"
+#include "jukebox/Util/WorkerPool.h"
+
+namespace jukebox {
+
+QOAWriterSoundImpl::QOAWriterSoundImpl(Decoder *decoder, std::string filename) :
+	FileWriterSoundImpl(decoder, filename) {
+}
+
+void QOAWriterSoundImpl::play() {
+	int numChannels = decoder->getNumChannels();
+	int blockSize = decoder->getBlockSize();
+	if (numChannels > qoa::maxChannels)
+		throw std::runtime_error("error writing " + filename + ". QOA holds up to 8 channels");
+
+	std::fstream output(filename, std::ios::binary|std::ios::trunc|std::ios::out);
+	uint8_t fileHeader[qoa::fileHeaderSize];
+	qoa::writeFileHeader(fileHeader, decoder->getDataSize() / blockSize);
+	output.write((char *)fileHeader, sizeof(fileHeader));
+
+	// whole QOA frames, decoded in parallel when the decoder allows it and encoded in order
+	int bufFrames = qoa::frameLen * 8 * (WorkerPool::getInstance().size() + 1);
+	int dataFrames = decoder->getDataSize() / blockSize;
+	bufFrames = std::max(qoa::frameLen, std::min(bufFrames, (dataFrames + qoa::frameLen - 1) / qoa::frameLen * qoa::frameLen));
+	int bufSize = bufFrames * blockSize;
+	std::unique_ptr<char []> buf(new char[bufSize]);
+	std::vector<int16_t> samples(decoder->getSampleFormat() == SampleFormat::S16 ? 0 : bufFrames * numChannels);
+	std::vector<uint8_t> frame(qoa::frameSize(numChannels, qoa::frameLen));
+	qoa::LMS lms[qoa::maxChannels];
+	int pos = 0;
+
+	for (;;) {
+		// a short read is topped up, only the last QOA frame may be short (seeking relies on it)
+		int len = 0;
+		for (int n; len < bufSize && (n = decoder->getSamplesParallel(buf.get() + len, pos + len, bufSize - len)) > 0;)
+			len += n;
+		if (len == 0)
+			break;
+		pos += len;
+		int frames = len / blockSize;
+		auto s16 = (int16_t *)buf.get();
+		if (!samples.empty()) {
+			convertSamples(buf.get(), decoder->getSampleFormat(), samples.data(), SampleFormat::S16, frames * numChannels);
+			s16 = samples.data();
+		}
+
+		for (int i = 0; i < frames; i += qoa::frameLen) {
+			auto size = qoa::encodeFrame(s16 + i * numChannels, numChannels, decoder->getSampleRate(),
+				std::min(qoa::frameLen, frames - i), lms, frame.data());
+			output.write((char *)frame.data(), size);
+		}
+	}
+	while (!onStopStack.empty()) {
+		onStopStack.back()();
+		onStopStack.pop_back();
+	}
+}
+
+} /* namespace jukebox */
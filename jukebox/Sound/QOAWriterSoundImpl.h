@@ -0,0 +1,38 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef JUKEBOX_SOUND_QOAWRITERSOUNDIMPL_H_
+#define JUKEBOX_SOUND_QOAWRITERSOUNDIMPL_H_
+
+#include "FileWriterSoundImpl.h"
+
+namespace jukebox {
+
+/* Writes the sound as a QOA file instead of WAVE, for converting assets
+ * offline: 16 bit samples (other formats are converted) of up to 8
+ * channels, about a fifth of their size.
+ */
+class QOAWriterSoundImpl: public FileWriterSoundImpl {
+public:
+	QOAWriterSoundImpl(Decoder *, std::string filename);
+	virtual ~QOAWriterSoundImpl() = default;
+	void play() override;
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_SOUND_QOAWRITERSOUNDIMPL_H_ */
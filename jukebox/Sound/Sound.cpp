@@ -14,6 +14,7 @@
  */
 
 #include <algorithm>
+#include <cmath>
 #include "Sound.h"
 #include "Factory.h"
 #include "jukebox/Decoders/Decoder.h"
@@ -23,6 +24,9 @@
 #include "jukebox/Decoders/Decorators/DistortionImpl.h"
 #include "jukebox/Decoders/Decorators/JointStereoImpl.h"
 #include "jukebox/Decoders/Decorators/MovingAverageImpl.h"
+#include "jukebox/Decoders/Decorators/ConvolutionImpl.h"
+#include "jukebox/Decoders/Decorators/FilterImpl.h"
+#include "jukebox/Decoders/Decorators/DynamicsImpl.h"
 #include "Decorators/FadeOnStopSoundImpl.h"
 
 namespace {
@@ -44,6 +48,8 @@ class DummyImpl: public SoundImpl {
 	bool playing() const override { return false; }
 	int getPosition() const override { return 0; }
 	void setPosition(int pos) override {}
+	void addTimedEventCallback(size_t, std::function<void(void)>) override {}
+	void addFrameEventCallback(size_t, std::function<void(void)>) override {}
 public:
 	DummyImpl(): SoundImpl(0) {}
 };
@@ -62,12 +68,14 @@ Sound& Sound::play() {
 
 Sound& Sound::restart() {
 	loop(looping);
+	impl->clearSchedule();
 	impl->restart();
 	return *this;
 }
 
 Sound& Sound::pause() {
 	impl->loop(false);
+	impl->clearSchedule();
 	impl->pause();
 	return *this;
 }
@@ -88,6 +96,11 @@ Sound& Sound::loop(bool l) {
 	return *this;
 }
 
+Sound& Sound::setLoopPoints(size_t start, size_t end) {
+	impl->setLoopPoints(start, end);
+	return *this;
+}
+
 int Sound::getPosition() const {
 	return impl->getPosition();
 }
@@ -124,6 +137,33 @@ Sound &Sound::addTimedEventCallback(size_t seconds, std::function<void(void)> te
 	return *this;
 }
 
+Sound &Sound::addTimedEventCallback(std::chrono::nanoseconds when, std::function<void(void)> te) {
+	auto frame = std::llround(std::chrono::duration<double>(when).count() * getSampleRate());
+	return addFrameEventCallback(std::max(0ll, frame), te);
+}
+
+Sound &Sound::addFrameEventCallback(size_t frame, std::function<void(void)> te) {
+	impl->addFrameEventCallback(frame, te);
+	return *this;
+}
+
+Sound &Sound::playAt(uint64_t frame) {
+	impl->clearSchedule();
+	impl->scheduleStart(frame);
+	if (!impl->playing())
+		return play();
+
+	// rescheduled from the beginning, the playing thread only reads the start when it begins
+	loop(looping);
+	impl->restart();
+	return *this;
+}
+
+Sound &Sound::stopAt(uint64_t frame) {
+	impl->scheduleStop(frame);
+	return *this;
+}
+
 Sound& Sound::reverb(float delay, float decay, size_t numDelays) {
 	impl->getDecoder().wrap<ReverbImpl>(delay, decay, numDelays);
 	return *this;
@@ -185,6 +225,7 @@ const std::string& Sound::getFilename() const {
 
 Sound& Sound::stop() {
 	impl->loop(false);
+	impl->clearSchedule();
 	impl->stop();
 	return *this;
 }
@@ -201,6 +242,21 @@ Sound& Sound::movingAverage(float len) {
 	return *this;
 }
 
+Sound& Sound::convolution(SoundFile impulseResponse, float wet) {
+	impl->getDecoder().wrap<ConvolutionImpl>(impulseResponse, wet);
+	return *this;
+}
+
+Sound& Sound::filter(std::shared_ptr<FilterBank> bank) {
+	impl->getDecoder().wrap<FilterImpl>(bank);
+	return *this;
+}
+
+Sound& Sound::dynamics(const Dynamics::Settings &settings) {
+	impl->getDecoder().wrap<DynamicsImpl>(settings);
+	return *this;
+}
+
 double Sound::getDuration() const {
 	return impl->getDecoder().getDuration();
 }
@@ -16,10 +16,13 @@
 #ifndef LIBJUKEBOX_SOUND_2017_12_17_H_
 #define LIBJUKEBOX_SOUND_2017_12_17_H_
 
+#include <chrono>
 #include <memory>
 
 #include "SoundImpl.h"
 #include "jukebox/FileFormats/SoundFile.h"
+#include "jukebox/Util/Biquad.h"
+#include "jukebox/Util/Dynamics.h"
 
 namespace jukebox {
 
@@ -52,9 +55,25 @@ public:
 	bool onStopStackEmpty();
 
 	/*
-	 * one shot timed event, callback removed after execution. Resolution in seconds.
+	 * one shot timed event, callback removed after execution. Callbacks
+	 * run on a dispatcher thread when that point of the sound is heard,
+	 * frame accurate (the duration is rounded to the nearest frame).
+	 * Up to 4096 events may be pending per sound, beyond that it throws.
 	 * */
 	Sound &addTimedEventCallback(size_t seconds, std::function<void(void)>);
+	Sound &addTimedEventCallback(std::chrono::nanoseconds when, std::function<void(void)>);
+	Sound &addFrameEventCallback(size_t frame, std::function<void(void)>);
+
+	/*
+	 * sample accurate start/stop at a frame of the shared AudioClock, at
+	 * this sound's sample rate (e.g. AudioClock::now(rate) + rate/10 is
+	 * 100ms from now). A late start skips into the sound, keeping it
+	 * aligned to the clock. playAt() on a playing sound restarts it from
+	 * the beginning at that frame. stop(), pause() and restart() drop a
+	 * pending start/stop, and so does the sound ending.
+	 * */
+	Sound &playAt(uint64_t frame);
+	Sound &stopAt(uint64_t frame);
 
 	Sound &reverb(float delay, float decay, size_t numDelays);
 	Sound &distortion(float gain);
@@ -63,8 +82,18 @@ public:
 	Sound &fadeOnStop(int fadeOutSecs);
 	Sound &setVolume(int);
 	Sound &loop(bool);
+	/*
+	 * loop region in frames (end exclusive) replacing the one embedded in
+	 * the file (WAV smpl chunk, Vorbis LOOPSTART/LOOPLENGTH), if any, and
+	 * the whole sound otherwise; (0, 0) goes back to those. A looping sound
+	 * plays the intro before the start once, then wraps sample accurately.
+	 * */
+	Sound &setLoopPoints(size_t start, size_t end);
 	Sound &jointStereo();
 	Sound &movingAverage(float len);
+	Sound &convolution(SoundFile impulseResponse, float wet);
+	Sound &filter(std::shared_ptr<FilterBank> bank);
+	Sound &dynamics(const Dynamics::Settings &settings);
 	Sound &peelDecoder();
 
 	Sound prototype();
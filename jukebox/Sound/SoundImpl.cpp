@@ -13,6 +13,7 @@
     along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include "SoundImpl.h"
 
 namespace jukebox {
@@ -48,25 +49,130 @@ bool SoundImpl::onStopStackEmpty() {
 }
 
 void SoundImpl::addTimedEventCallback(size_t seconds, std::function<void(void)> te) {
-	std::lock_guard<std::recursive_mutex> lock(timedEventsMutex);
+	addFrameEventCallback(seconds * decoder->getSampleRate(), te);
+}
+
+void SoundImpl::addFrameEventCallback(size_t frame, std::function<void(void)> te) {
+	timedEvents.schedule(frame, te);
+}
+
+void SoundImpl::scheduleStart(uint64_t frame) {
+	startFrame = frame;
+}
+
+void SoundImpl::scheduleStop(uint64_t frame) {
+	stopFrame = frame;
+}
+
+void SoundImpl::clearSchedule() {
+	startFrame = noFrame;
+	stopFrame = noFrame;
+}
 
-	timedEvents[seconds] = te;
+void SoundImpl::setLoopPoints(size_t start, size_t end) {
+	loopStart = start;
+	loopEnd = end;
 }
 
 Decoder& SoundImpl::getDecoder() {
 	return *decoder;
 }
 
-void SoundImpl::processTimedEvents() {
-	std::lock_guard<std::recursive_mutex> lock(timedEventsMutex);
+void SoundImpl::processTimedEvents(size_t frames, size_t delay) {
+	timedEvents.process(position / decoder->getBlockSize(), frames, delay, decoder->getSampleRate());
+}
+
+bool SoundImpl::startScheduled() const {
+	return startFrame != noFrame;
+}
+
+size_t SoundImpl::startPadding(size_t delay) {
+	auto frame = startFrame.exchange(noFrame);
+	if (frame == noFrame)
+		return 0;
+
+	// clock frame heard when the next queued one plays
+	auto next = AudioClock::now(decoder->getSampleRate()) + delay;
+	if (frame >= next)
+		return frame - next;
+
+	auto blockSize = decoder->getBlockSize();
+	auto skip = std::min<uint64_t>(next - frame, (decoder->getDataSize() - position) / blockSize);
+	setPosition(position + skip * blockSize);
+	return 0;
+}
+
+size_t SoundImpl::framesBeforeStop(size_t frames, size_t delay) {
+	auto frame = stopFrame.load();
+	if (frame == noFrame)
+		return frames;
+
+	auto first = AudioClock::now(decoder->getSampleRate()) + delay;
+	if (frame >= first + frames)
+		return frames;
+
+	stopFrame.compare_exchange_strong(frame, noFrame);
+	return frame > first ? frame - first : 0;
+}
+
+int SoundImpl::readBlock(char *buf, int len, bool looping) {
+	int blockSize = decoder->getBlockSize();
+	int dataSize = decoder->getDataSize();
+	int start = 0, end = dataSize;
+
+	if (looping) {
+		// set by the client, otherwise the file's, otherwise the whole sound
+		size_t first = loopStart, last = loopEnd;
+		if (last == 0) {
+			first = decoder->getLoopStart();
+			last = decoder->getLoopEnd();
+		}
+		if (first < last && first * blockSize < static_cast<size_t>(dataSize)) {
+			start = first * blockSize;
+			end = std::min<size_t>(last * blockSize, dataSize);
+		}
+		if (position >= end)
+			setPosition(start);
+	}
+
+	len = std::min(len, end - position) / blockSize * blockSize;
+	if (len <= 0)
+		return 0;
+
+	if (!looping)
+		return decoder->getSamples(buf, position, len);
+
+	if (loopHeadStart != start || loopHeadEnd != end || loopHeadRevision != decoder->getRevision()) {
+		loopHead.clear();
+		loopHeadStart = start;
+		loopHeadEnd = end;
+		loopHeadRevision = decoder->getRevision();
+		loopHeadDone = false;
+	}
+
+	bool cacheHead = !decoder->decorated();
+	int headEnd = start + loopHead.size();
+	if (cacheHead && loopHeadDone && position >= start && position < headEnd) {
+		len = std::min(len, headEnd - position);
+		std::copy_n(loopHead.data() + (position - start), len, buf);
+		return len;
+	}
+
+	auto bytes = decoder->getSamples(buf, position, len);
+	if (bytes <= 0 && position > start) {
+		// the decoder came short of its data size, wrap there
+		setPosition(start);
+		return readBlock(buf, len, looping);
+	}
 
-	size_t seconds = position / (decoder->getBlockSize() * decoder->getSampleRate());
-	auto top = timedEvents.begin();
-	while (top != timedEvents.end() && seconds >= top->first) {
-		top->second();
-		timedEvents.erase(top);
-		top = timedEvents.begin();
+	// keep a quarter of a second from the first pass through the loop start
+	if (cacheHead && !loopHeadDone && bytes > 0 && position == headEnd) {
+		int headSize = std::min(end - start, decoder->getSampleRate() / 4 * blockSize);
+		loopHead.reserve(headSize);
+		loopHead.insert(loopHead.end(), buf, buf + std::min<int>(bytes, headSize - loopHead.size()));
+		loopHeadDone = static_cast<int>(loopHead.size()) == headSize;
 	}
+	return bytes;
 }
 
 } /* namespace jukebox */
@@ -16,12 +16,14 @@
 #ifndef LIBJUKEBOX_SOUNDIMPL_2017_12_17_H_
 #define LIBJUKEBOX_SOUNDIMPL_2017_12_17_H_
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <functional>
-#include <map>
-#include <mutex>
 #include <vector>
 #include "jukebox/Decoders/Decoder.h"
+#include "jukebox/Util/AudioClock.h"
+#include "jukebox/Util/EventScheduler.h"
 
 namespace jukebox {
 
@@ -44,14 +46,50 @@ public:
 	virtual void clearOnStopStack();
 	virtual bool onStopStackEmpty();
 	virtual void addTimedEventCallback(size_t seconds, std::function<void(void)>);
+	virtual void addFrameEventCallback(size_t frame, std::function<void(void)>);
+	virtual void scheduleStart(uint64_t frame);
+	virtual void scheduleStop(uint64_t frame);
+	virtual void clearSchedule(); // drops a pending scheduled start and stop
+	virtual void setLoopPoints(size_t start, size_t end);
 	virtual Decoder &getDecoder();
-	void processTimedEvents();
+	/*
+	 * called by the playing thread to read up to 'len' bytes at the
+	 * current position. When looping, reads stop at the loop end and the
+	 * position wraps to the loop start. The first frames after the loop
+	 * start are kept from the first pass, so a wrap neither decodes nor seeks,
+	 * unless the decoder is decorated: decorators (reverb, filters...) carry
+	 * state from block to block, so every pass goes through them.
+	 */
+	int readBlock(char *buf, int len, bool looping);
+	/*
+	 * called by the playing thread after queueing 'frames' frames from
+	 * the current position, 'delay' frames ahead of what is being heard.
+	 */
+	void processTimedEvents(size_t frames, size_t delay);
+	/*
+	 * scheduled start/stop (AudioClock frames), also used by the playing
+	 * thread with its device delay: startPadding() returns the frames of
+	 * silence to queue before the sound (skipping into it when late),
+	 * framesBeforeStop() how many of the next 'frames' play before the stop.
+	 */
+	bool startScheduled() const;
+	size_t startPadding(size_t delay);
+	size_t framesBeforeStop(size_t frames, size_t delay);
 protected:
 	int position = 0;
 	std::unique_ptr<Decoder> decoder;
 	std::vector<std::function<void (void)>> onStopStack;
-	std::recursive_mutex timedEventsMutex;
-	std::map<size_t, std::function<void (void)> > timedEvents;
+	EventScheduler timedEvents;
+	static constexpr uint64_t noFrame = UINT64_MAX;
+	std::atomic<uint64_t> startFrame{noFrame};
+	std::atomic<uint64_t> stopFrame{noFrame};
+	std::atomic<size_t> loopStart{0};
+	std::atomic<size_t> loopEnd{0};
+private:
+	// loop head, only touched by the playing thread
+	std::vector<char> loopHead;
+	int loopHeadStart = -1, loopHeadEnd = -1, loopHeadRevision = 0;
+	bool loopHeadDone = false;
 };
 
 } /* namespace jukebox */
@@ -0,0 +1,47 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "AudioClock.h"
+
+namespace jukebox {
+
+AudioClock::Clock::time_point AudioClock::epoch() {
+	static const auto start = Clock::now();
+	return start;
+}
+
+uint64_t AudioClock::now(int sampleRate) {
+	return toFrame(Clock::now(), sampleRate);
+}
+
+uint64_t AudioClock::toFrame(Clock::time_point time, int sampleRate) {
+	if (time <= epoch())
+		return 0;
+
+	// split in whole seconds so that frame * 10^9 can't overflow
+	auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(time - epoch()).count();
+	uint64_t secs = elapsed / 1000000000, nanos = elapsed % 1000000000;
+	return secs * sampleRate + nanos * sampleRate / 1000000000;
+}
+
+AudioClock::Clock::time_point AudioClock::toTime(uint64_t frame, int sampleRate) {
+	// rounded up, so that toFrame(toTime(frame)) == frame
+	uint64_t secs = frame / sampleRate, rest = frame % sampleRate;
+	return epoch() + std::chrono::duration_cast<Clock::duration>(
+			std::chrono::nanoseconds(secs * 1000000000 + (rest * 1000000000 + sampleRate - 1) / sampleRate));
+}
+
+} /* namespace jukebox */
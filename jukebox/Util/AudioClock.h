@@ -0,0 +1,45 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef JUKEBOX_UTIL_AUDIOCLOCK_H_
+#define JUKEBOX_UTIL_AUDIOCLOCK_H_
+
+#include <chrono>
+#include <cstdint>
+
+namespace jukebox {
+
+/*
+ * Process wide transport clock, counting frames since its epoch (the
+ * first use) at a given sample rate. Sounds with the same sample rate
+ * share the same frame grid, so scheduling them at the same frame
+ * starts/stops them on the same sample. Each output aligns to it using
+ * its own device delay.
+ */
+class AudioClock {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	static uint64_t now(int sampleRate);
+	static uint64_t toFrame(Clock::time_point time, int sampleRate);
+	static Clock::time_point toTime(uint64_t frame, int sampleRate);
+private:
+	static Clock::time_point epoch();
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_UTIL_AUDIOCLOCK_H_ */
@@ -0,0 +1,106 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "Biquad.h"
+
+namespace jukebox {
+
+Biquad Biquad::design(FilterType type, float frequency, float q, float gainDb, int sampleRate) {
+	const double pi = std::acos(-1.0);
+	double f = std::max(1.0, std::min((double)frequency, 0.49*sampleRate));
+	double w0 = 2*pi*f/sampleRate;
+	double cosw = std::cos(w0);
+	double alpha = std::sin(w0)/(2*std::max((double)q, 0.01));
+	double A = std::pow(10.0, gainDb/40.0);
+	double sqrtA2alpha = 2*std::sqrt(A)*alpha;
+	double b0, b1, b2, a0, a1, a2;
+
+	switch (type) {
+	case FilterType::LowPass:
+		b0 = b2 = (1 - cosw)/2; b1 = 1 - cosw;
+		a0 = 1 + alpha; a1 = -2*cosw; a2 = 1 - alpha;
+		break;
+	case FilterType::HighPass:
+		b0 = b2 = (1 + cosw)/2; b1 = -(1 + cosw);
+		a0 = 1 + alpha; a1 = -2*cosw; a2 = 1 - alpha;
+		break;
+	case FilterType::BandPass:
+		b0 = alpha; b1 = 0; b2 = -alpha;
+		a0 = 1 + alpha; a1 = -2*cosw; a2 = 1 - alpha;
+		break;
+	case FilterType::Notch:
+		b0 = b2 = 1; b1 = -2*cosw;
+		a0 = 1 + alpha; a1 = -2*cosw; a2 = 1 - alpha;
+		break;
+	case FilterType::Peak:
+		b0 = 1 + alpha*A; b1 = -2*cosw; b2 = 1 - alpha*A;
+		a0 = 1 + alpha/A; a1 = -2*cosw; a2 = 1 - alpha/A;
+		break;
+	case FilterType::LowShelf:
+		b0 = A*((A + 1) - (A - 1)*cosw + sqrtA2alpha);
+		b1 = 2*A*((A - 1) - (A + 1)*cosw);
+		b2 = A*((A + 1) - (A - 1)*cosw - sqrtA2alpha);
+		a0 = (A + 1) + (A - 1)*cosw + sqrtA2alpha;
+		a1 = -2*((A - 1) + (A + 1)*cosw);
+		a2 = (A + 1) + (A - 1)*cosw - sqrtA2alpha;
+		break;
+	case FilterType::HighShelf:
+		b0 = A*((A + 1) + (A - 1)*cosw + sqrtA2alpha);
+		b1 = -2*A*((A - 1) + (A + 1)*cosw);
+		b2 = A*((A + 1) + (A - 1)*cosw - sqrtA2alpha);
+		a0 = (A + 1) - (A - 1)*cosw + sqrtA2alpha;
+		a1 = 2*((A - 1) - (A + 1)*cosw);
+		a2 = (A + 1) - (A - 1)*cosw - sqrtA2alpha;
+		break;
+	default:
+		throw std::runtime_error("invalid filter type.");
+	}
+
+	Biquad bq;
+	bq.b0 = b0/a0; bq.b1 = b1/a0; bq.b2 = b2/a0;
+	bq.a1 = a1/a0; bq.a2 = a2/a0;
+	return bq;
+}
+
+size_t FilterBank::addBand(FilterType type, float frequency, float q, float gainDb) {
+	std::lock_guard<std::mutex> lock(mutex);
+	bands.push_back({type, frequency, q, gainDb});
+	++version;
+	return bands.size() - 1;
+}
+
+void FilterBank::setBand(size_t band, FilterType type, float frequency, float q, float gainDb) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (band >= bands.size())
+		throw std::runtime_error("invalid filter band.");
+	bands[band] = {type, frequency, q, gainDb};
+	++version;
+}
+
+std::vector<FilterBank::Band> FilterBank::getBands() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return bands;
+}
+
+unsigned FilterBank::getVersion() const {
+	return version;
+}
+
+} /* namespace jukebox */
@@ -0,0 +1,71 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef JUKEBOX_UTIL_BIQUAD_H_
+#define JUKEBOX_UTIL_BIQUAD_H_
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace jukebox {
+
+enum class FilterType {
+	LowPass,
+	HighPass,
+	BandPass, // 0dB at the center frequency
+	Notch,
+	Peak, // parametric EQ band
+	LowShelf,
+	HighShelf
+};
+
+// normalized (a0 = 1) biquad coefficients, from the RBJ audio EQ cookbook
+struct Biquad {
+	float b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+
+	// gainDb is only used by Peak and the shelves
+	static Biquad design(FilterType type, float frequency, float q, float gainDb, int sampleRate);
+};
+
+/*
+ * Filter settings, shared by the client and the FilterImpl decorators
+ * using them. Bands can be added and changed while the sound is playing:
+ * the decorators pick up the new settings on their next block and ramp
+ * their coefficients towards them across it. A flat Peak band (0dB)
+ * passes the signal through unchanged.
+ */
+class FilterBank {
+public:
+	struct Band {
+		FilterType type;
+		float frequency, q, gainDb;
+	};
+
+	size_t addBand(FilterType type, float frequency, float q = 0.7071f, float gainDb = 0); // returns the band index
+	void setBand(size_t band, FilterType type, float frequency, float q = 0.7071f, float gainDb = 0);
+	std::vector<Band> getBands() const;
+	unsigned getVersion() const; // changes every time the settings do
+private:
+	mutable std::mutex mutex;
+	std::vector<Band> bands;
+	std::atomic<unsigned> version{0};
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_UTIL_BIQUAD_H_ */
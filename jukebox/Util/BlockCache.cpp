@@ -0,0 +1,69 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "BlockCache.h"
+
+namespace jukebox {
+
+BlockCache::BlockCache(size_t capacity) :
+		capacity(capacity) {
+}
+
+BlockCache::Block BlockCache::get(int i) {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = index.find(i);
+	if (it == index.end())
+		return nullptr;
+
+	blocks.splice(blocks.begin(), blocks, it->second);
+	return it->second->second;
+}
+
+void BlockCache::put(int i, Block block) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (capacity == 0)
+		return;
+
+	auto it = index.find(i);
+	if (it != index.end()) { // decoded meanwhile by another decoder
+		blocks.splice(blocks.begin(), blocks, it->second);
+		return;
+	}
+
+	blocks.emplace_front(i, block);
+	index[i] = blocks.begin();
+	evict();
+}
+
+void BlockCache::setCapacity(size_t capacity) {
+	std::lock_guard<std::mutex> lock(mutex);
+	this->capacity = capacity;
+	evict();
+}
+
+size_t BlockCache::getCapacity() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return capacity;
+}
+
+void BlockCache::evict() {
+	while (blocks.size() > capacity) {
+		index.erase(blocks.back().first);
+		blocks.pop_back();
+	}
+}
+
+} /* namespace jukebox */
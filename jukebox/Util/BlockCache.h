@@ -0,0 +1,57 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef JUKEBOX_UTIL_BLOCKCACHE_H_
+#define JUKEBOX_UTIL_BLOCKCACHE_H_
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace jukebox {
+
+/*
+ * Least recently used decoded blocks of a file, keyed by block index and
+ * shared by all of its decoders. Blocks are immutable once stored, so a
+ * decoder may keep copying from one after it has been evicted.
+ */
+class BlockCache {
+public:
+	using Block = std::shared_ptr<const std::vector<char>>;
+
+	BlockCache(size_t capacity = 64); // in blocks
+	Block get(int index); // nullptr when it isn't cached
+	void put(int index, Block block);
+	void setCapacity(size_t capacity); // 0 disables it
+	size_t getCapacity() const;
+private:
+	BlockCache(const BlockCache &) = delete;
+	BlockCache &operator=(const BlockCache &) = delete;
+
+	mutable std::mutex mutex;
+	size_t capacity;
+	std::list<std::pair<int, Block>> blocks; // most recently used first
+	std::unordered_map<int, std::list<std::pair<int, Block>>::iterator> index;
+
+	void evict();
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_UTIL_BLOCKCACHE_H_ */
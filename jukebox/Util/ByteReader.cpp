@@ -0,0 +1,163 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <algorithm>
+#include <cstring>
+#include "ByteReader.h"
+#include "WorkerPool.h"
+
+namespace jukebox {
+
+namespace {
+
+// a single thread, so the disk sees one sequential reader per stream
+WorkerPool &ioThread() {
+	static WorkerPool instance(1);
+	return instance;
+}
+
+}
+
+ByteReader::ByteReader(std::shared_ptr<ByteSource> source, size_t blockSize) :
+		source(source),
+		memory(source->data()),
+		blockSize(blockSize) {
+}
+
+ByteReader::~ByteReader() {
+	if (next.valid() && nextTaken->exchange(true))
+		next.wait(); // being read, into this
+}
+
+size_t ByteReader::read(void *buf, size_t len) {
+	auto out = static_cast<char *>(buf);
+	auto total = std::min<uint64_t>(len, position < size() ? size() - position : 0);
+
+	if (memory) {
+		memcpy(out, memory + position, total);
+		position += total;
+		return total;
+	}
+
+	size_t done = 0;
+	while (done < total) {
+		if (position - base >= current.size() && !fill(position))
+			break;
+		auto n = std::min<uint64_t>(total - done, current.size() - (position - base));
+		memcpy(out + done, current.data() + (position - base), n);
+		position += n;
+		done += n;
+	}
+	return done;
+}
+
+bool ByteReader::seek(int64_t offset, int origin) {
+	int64_t target = offset;
+	if (origin == SEEK_CUR)
+		target += position;
+	else if (origin == SEEK_END)
+		target += size();
+
+	if (target < 0)
+		return false;
+	position = target; // read lazily, a seek is often followed by another one
+	return true;
+}
+
+uint64_t ByteReader::tell() const {
+	return position;
+}
+
+uint64_t ByteReader::size() const {
+	return source->size();
+}
+
+// makes the block at offset current, from the prefetched one when it matches
+bool ByteReader::fill(uint64_t offset) {
+	Block block;
+	if (next.valid() && nextTaken->exchange(true)) {
+		block = next.get();
+		if (block.offset != offset)
+			block = readAt(std::move(block.data), offset);
+	} else // nothing prefetched, or still queued
+		block = readAt(std::move(spare), offset);
+	next = std::future<Block>();
+
+	spare = std::move(current);
+	current = std::move(block.data);
+	base = offset;
+
+	prefetch(offset + current.size());
+	return !current.empty();
+}
+
+void ByteReader::prefetch(uint64_t offset) {
+	if (offset >= size())
+		return;
+
+	auto data = std::make_shared<std::vector<char>>(std::move(spare));
+	auto taken = nextTaken = std::make_shared<std::atomic<bool>>(false);
+	next = ioThread().submit([this, data, taken, offset]() {
+		if (taken->exchange(true))
+			return Block{}; // the reader got to it first, it may be gone
+		return readAt(std::move(*data), offset);
+	});
+}
+
+ByteReader::Block ByteReader::readAt(std::vector<char> data, uint64_t offset) {
+	data.resize(blockSize);
+	data.resize(source->readAt(offset, data.data(), data.size()));
+	return Block{std::move(data), offset};
+}
+
+ByteSourceStream::Buffer::Buffer(std::shared_ptr<ByteSource> source) :
+		reader(source) {
+	setg(buf, buf, buf);
+}
+
+ByteSourceStream::Buffer::int_type ByteSourceStream::Buffer::underflow() {
+	if (gptr() == egptr()) {
+		auto n = reader.read(buf, sizeof(buf));
+		setg(buf, buf, buf + n);
+		if (n == 0)
+			return traits_type::eof();
+	}
+	return traits_type::to_int_type(*gptr());
+}
+
+ByteSourceStream::Buffer::pos_type ByteSourceStream::Buffer::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode) {
+	if (dir == std::ios_base::cur)
+		off -= egptr() - gptr(); // the reader is past the buffered bytes
+
+	if (!reader.seek(off, dir == std::ios_base::beg ? SEEK_SET : dir == std::ios_base::cur ? SEEK_CUR : SEEK_END))
+		return pos_type(off_type(-1));
+	setg(buf, buf, buf);
+	return pos_type(reader.tell());
+}
+
+ByteSourceStream::Buffer::pos_type ByteSourceStream::Buffer::seekpos(pos_type pos, std::ios_base::openmode which) {
+	return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+ByteSourceStream::ByteSourceStream(std::shared_ptr<ByteSource> source) :
+		std::istream(nullptr),
+		buf(source) {
+
+	rdbuf(&buf);
+}
+
+} /* namespace jukebox */
@@ -0,0 +1,102 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef JUKEBOX_UTIL_BYTEREADER_H_
+#define JUKEBOX_UTIL_BYTEREADER_H_
+
+#include <atomic>
+#include <cstdio>
+#include <future>
+#include <istream>
+#include <memory>
+#include <vector>
+#include "ByteSource.h"
+
+namespace jukebox {
+
+/*
+ * Cursor over a ByteSource for the decoders' read/seek callbacks, one per
+ * decoder handle. A source that isn't in memory is read in large blocks,
+ * the next one prefetched by a background I/O thread while the current one
+ * is consumed, so small reads and near seeks never touch the disk from the
+ * playing thread. Only a seek outside the buffered data reads in place.
+ *
+ * Readers share nothing but the source, so any number of them may stream
+ * one file concurrently (e.g. prototypes of a sound). The I/O thread is
+ * shared as well: a reader whose prefetch is still queued behind the other
+ * readers' takes it back and reads the block itself rather than waiting.
+ */
+class ByteReader {
+public:
+	ByteReader(std::shared_ptr<ByteSource> source, size_t blockSize = 1 << 18);
+	~ByteReader();
+	size_t read(void *buf, size_t len);
+	bool seek(int64_t offset, int origin); // SEEK_SET, SEEK_CUR or SEEK_END
+	uint64_t tell() const;
+	uint64_t size() const;
+
+	int get() { // fgetc
+		if (position - base < current.size())
+			return static_cast<uint8_t>(current[position++ - base]);
+		uint8_t c;
+		return read(&c, 1) == 1 ? c : EOF;
+	}
+private:
+	ByteReader(const ByteReader &) = delete;
+	ByteReader &operator=(const ByteReader &) = delete;
+
+	struct Block {
+		std::vector<char> data;
+		uint64_t offset;
+	};
+
+	std::shared_ptr<ByteSource> source;
+	const uint8_t *memory;
+	size_t blockSize;
+	uint64_t position = 0;
+	uint64_t base = 0; // source offset of current
+	std::vector<char> current, spare;
+	std::future<Block> next;
+	std::shared_ptr<std::atomic<bool>> nextTaken; // by the I/O thread or by the reader
+
+	bool fill(uint64_t offset);
+	void prefetch(uint64_t offset);
+	Block readAt(std::vector<char> data, uint64_t offset);
+};
+
+/* istream over a ByteSource, for code that parses streams */
+class ByteSourceStream : public std::istream {
+public:
+	ByteSourceStream(std::shared_ptr<ByteSource> source);
+private:
+	class Buffer : public std::streambuf {
+	public:
+		Buffer(std::shared_ptr<ByteSource> source);
+	protected:
+		int_type underflow() override;
+		pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode) override;
+		pos_type seekpos(pos_type pos, std::ios_base::openmode) override;
+	private:
+		ByteReader reader;
+		char buf[4096];
+	};
+
+	Buffer buf;
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_UTIL_BYTEREADER_H_ */
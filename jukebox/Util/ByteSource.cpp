@@ -0,0 +1,243 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "ByteSource.h"
+
+namespace jukebox {
+
+const uint8_t *ByteSource::data() const {
+	return nullptr;
+}
+
+#ifdef _WIN32
+
+FileByteSource::FileByteSource(const std::string &filename) {
+	handle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	LARGE_INTEGER len;
+	if (handle == INVALID_HANDLE_VALUE || !GetFileSizeEx(handle, &len)) {
+		if (handle != INVALID_HANDLE_VALUE)
+			CloseHandle(handle);
+		throw std::runtime_error("error opening " + filename);
+	}
+	fileSize = len.QuadPart;
+}
+
+FileByteSource::~FileByteSource() {
+	CloseHandle(handle);
+}
+
+size_t FileByteSource::readAt(uint64_t offset, void *buf, size_t len) {
+	size_t total = 0;
+	while (total < len && offset + total < fileSize) {
+		OVERLAPPED at = {};
+		at.Offset = (DWORD)(offset + total);
+		at.OffsetHigh = (DWORD)((offset + total) >> 32);
+		DWORD n = 0;
+		if (!ReadFile(handle, (char *)buf + total, (DWORD)std::min<size_t>(len - total, 1 << 30), &n, &at) || n == 0)
+			break;
+		total += n;
+	}
+	return total;
+}
+
+MappedByteSource::MappedByteSource(const std::string &filename) {
+	FileByteSource file(filename);
+	fileSize = file.size();
+	if (fileSize == 0)
+		return;
+
+	auto mapping = CreateFileMappingA(file.handle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping != NULL) {
+		memory = (const uint8_t *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping); // the view keeps the mapping
+	}
+	if (memory == nullptr)
+		throw std::runtime_error("error mapping " + filename);
+}
+
+MappedByteSource::~MappedByteSource() {
+	if (memory)
+		UnmapViewOfFile(memory);
+}
+
+#else
+
+FileByteSource::FileByteSource(const std::string &filename) {
+	auto fd = open(filename.c_str(), O_RDONLY);
+	struct stat st;
+	if (fd < 0 || fstat(fd, &st) != 0) {
+		if (fd >= 0)
+			close(fd);
+		throw std::runtime_error("error opening " + filename);
+	}
+	posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+	handle = reinterpret_cast<void *>(static_cast<intptr_t>(fd));
+	fileSize = st.st_size;
+}
+
+FileByteSource::~FileByteSource() {
+	close(static_cast<int>(reinterpret_cast<intptr_t>(handle)));
+}
+
+size_t FileByteSource::readAt(uint64_t offset, void *buf, size_t len) {
+	auto fd = static_cast<int>(reinterpret_cast<intptr_t>(handle));
+	size_t total = 0;
+	while (total < len) {
+		auto n = pread(fd, (char *)buf + total, len - total, offset + total);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			break;
+		total += n;
+	}
+	return total;
+}
+
+MappedByteSource::MappedByteSource(const std::string &filename) {
+	FileByteSource file(filename);
+	fileSize = file.size();
+	if (fileSize == 0)
+		return;
+
+	auto fd = static_cast<int>(reinterpret_cast<intptr_t>(file.handle));
+	auto addr = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0); // the mapping outlives the fd
+	if (addr == MAP_FAILED)
+		throw std::runtime_error("error mapping " + filename);
+	memory = static_cast<const uint8_t *>(addr);
+}
+
+MappedByteSource::~MappedByteSource() {
+	if (memory)
+		munmap(const_cast<uint8_t *>(memory), fileSize);
+}
+
+#endif
+
+uint64_t FileByteSource::size() const {
+	return fileSize;
+}
+
+size_t MappedByteSource::readAt(uint64_t offset, void *buf, size_t len) {
+	if (offset >= fileSize)
+		return 0;
+	len = std::min<uint64_t>(len, fileSize - offset);
+	memcpy(buf, memory + offset, len);
+	return len;
+}
+
+uint64_t MappedByteSource::size() const {
+	return fileSize;
+}
+
+const uint8_t *MappedByteSource::data() const {
+	return memory;
+}
+
+MemoryByteSource::MemoryByteSource(std::unique_ptr<uint8_t[]> memory, uint64_t size) :
+		memory(std::move(memory)),
+		memorySize(size) {
+}
+
+MemoryByteSource::MemoryByteSource(ByteSource &source) :
+		memory(new uint8_t[source.size()]),
+		memorySize(source.size()) {
+
+	memorySize = source.readAt(0, memory.get(), memorySize);
+}
+
+size_t MemoryByteSource::readAt(uint64_t offset, void *buf, size_t len) {
+	if (offset >= memorySize)
+		return 0;
+	len = std::min<uint64_t>(len, memorySize - offset);
+	memcpy(buf, memory.get() + offset, len);
+	return len;
+}
+
+uint64_t MemoryByteSource::size() const {
+	return memorySize;
+}
+
+const uint8_t *MemoryByteSource::data() const {
+	return memory.get();
+}
+
+PrefixByteSource::PrefixByteSource(std::shared_ptr<ByteSource> source, std::vector<uint8_t> prefix) :
+		source(source),
+		prefix(std::move(prefix)) {
+}
+
+size_t PrefixByteSource::readAt(uint64_t offset, void *buf, size_t len) {
+	size_t fromPrefix = 0;
+	if (offset < prefix.size()) {
+		fromPrefix = std::min<uint64_t>(len, prefix.size() - offset);
+		memcpy(buf, prefix.data() + offset, fromPrefix);
+		if (fromPrefix == len)
+			return len;
+	}
+	return fromPrefix + source->readAt(offset + fromPrefix, (uint8_t *)buf + fromPrefix, len - fromPrefix);
+}
+
+uint64_t PrefixByteSource::size() const {
+	return source->size();
+}
+
+const uint8_t *PrefixByteSource::data() const {
+	return source->data();
+}
+
+StreamByteSource::StreamByteSource(std::istream &inp) :
+		inp(inp) {
+
+	start = std::max<std::streamoff>(inp.tellg(), 0);
+	if (inp.seekg(0, std::ios::end))
+		streamSize = std::max<std::streamoff>(inp.tellg() - start, 0);
+	inp.clear();
+	inp.seekg(start, std::ios::beg);
+}
+
+size_t StreamByteSource::readAt(uint64_t offset, void *buf, size_t len) {
+	std::lock_guard<std::mutex> lock(streamMutex);
+	inp.clear();
+	inp.seekg(start + offset, std::ios::beg);
+	auto n = inp.read((char *)buf, len).gcount();
+	inp.clear();
+	return n;
+}
+
+uint64_t StreamByteSource::size() const {
+	return streamSize;
+}
+
+} /* namespace jukebox */
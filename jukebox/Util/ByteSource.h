@@ -0,0 +1,118 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef JUKEBOX_UTIL_BYTESOURCE_H_
+#define JUKEBOX_UTIL_BYTESOURCE_H_
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace jukebox {
+
+/*
+ * Read only random access bytes. readAt() takes its offset, there is no
+ * shared cursor, so several readers (see ByteReader) may use one source
+ * from different threads.
+ */
+class ByteSource {
+public:
+	virtual ~ByteSource() = default;
+	virtual size_t readAt(uint64_t offset, void *buf, size_t len) = 0; // short at the end
+	virtual uint64_t size() const = 0;
+	virtual const uint8_t *data() const; // the whole source when it is in memory, nullptr otherwise
+};
+
+/* positioned reads (pread) from a file */
+class FileByteSource : public ByteSource {
+public:
+	FileByteSource(const std::string &filename);
+	~FileByteSource();
+	size_t readAt(uint64_t offset, void *buf, size_t len) override;
+	uint64_t size() const override;
+private:
+	FileByteSource(const FileByteSource &) = delete;
+	FileByteSource &operator=(const FileByteSource &) = delete;
+	friend class MappedByteSource;
+
+	void *handle;
+	uint64_t fileSize = 0;
+};
+
+/* a file mapped in memory, paged in by the OS as it is read */
+class MappedByteSource : public ByteSource {
+public:
+	MappedByteSource(const std::string &filename);
+	~MappedByteSource();
+	size_t readAt(uint64_t offset, void *buf, size_t len) override;
+	uint64_t size() const override;
+	const uint8_t *data() const override;
+private:
+	MappedByteSource(const MappedByteSource &) = delete;
+	MappedByteSource &operator=(const MappedByteSource &) = delete;
+
+	const uint8_t *memory = nullptr;
+	uint64_t fileSize = 0;
+};
+
+/* bytes held in memory, e.g. a whole file read from another source */
+class MemoryByteSource : public ByteSource {
+public:
+	MemoryByteSource(std::unique_ptr<uint8_t[]> memory, uint64_t size);
+	MemoryByteSource(ByteSource &source);
+	size_t readAt(uint64_t offset, void *buf, size_t len) override;
+	uint64_t size() const override;
+	const uint8_t *data() const override;
+private:
+	std::unique_ptr<uint8_t[]> memory;
+	uint64_t memorySize;
+};
+
+/* a source whose first bytes were already read (e.g. to probe its format),
+ * serving them from memory
+ */
+class PrefixByteSource : public ByteSource {
+public:
+	PrefixByteSource(std::shared_ptr<ByteSource> source, std::vector<uint8_t> prefix);
+	size_t readAt(uint64_t offset, void *buf, size_t len) override;
+	uint64_t size() const override;
+	const uint8_t *data() const override;
+private:
+	std::shared_ptr<ByteSource> source;
+	std::vector<uint8_t> prefix;
+};
+
+/* adapter for client streams: reads are serialized on the stream, whose
+ * position at construction is offset 0
+ */
+class StreamByteSource : public ByteSource {
+public:
+	StreamByteSource(std::istream &inp);
+	size_t readAt(uint64_t offset, void *buf, size_t len) override;
+	uint64_t size() const override;
+private:
+	std::istream &inp;
+	std::mutex streamMutex;
+	std::streamoff start = 0;
+	uint64_t streamSize = 0;
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_UTIL_BYTESOURCE_H_ */
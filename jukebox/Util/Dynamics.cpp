@@ -0,0 +1,186 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <cmath>
+
+#include "Dynamics.h"
+#include "Gain.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JUKEBOX_DYNAMICS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace jukebox {
+
+constexpr size_t Dynamics::blockSize;
+
+namespace {
+
+float fromDb(float db) {
+	return std::pow(10.0f, db/20.0f);
+}
+
+float toDb(float v) {
+	return 20.0f*std::log10(std::max(v, 1e-9f));
+}
+
+// one pole smoothing coefficient, per block
+float coefficient(float ms, int sampleRate) {
+	return ms > 0 ? std::exp(-(float)Dynamics::blockSize/(ms*0.001f*sampleRate)) : 0;
+}
+
+float peakOf(const float *samples, size_t count) {
+	size_t i = 0;
+	float peak = 0;
+
+#ifdef JUKEBOX_DYNAMICS_SSE2
+	auto sign = _mm_set1_ps(-0.0f), max = _mm_setzero_ps();
+	for (; i + 4 <= count; i += 4)
+		max = _mm_max_ps(max, _mm_andnot_ps(sign, _mm_loadu_ps(samples + i)));
+	max = _mm_max_ps(max, _mm_shuffle_ps(max, max, _MM_SHUFFLE(1, 0, 3, 2)));
+	max = _mm_max_ps(max, _mm_shuffle_ps(max, max, _MM_SHUFFLE(2, 3, 0, 1)));
+	peak = _mm_cvtss_f32(max);
+#endif
+
+	for (; i < count; ++i)
+		peak = std::max(peak, std::fabs(samples[i]));
+
+	return peak;
+}
+
+}
+
+Dynamics::Dynamics(int sampleRate, int channels, const Settings &settings) :
+		settings(settings),
+		numChannels(channels),
+		lookaheadBlocks(std::max((size_t)2, // see detect()
+			(size_t)std::ceil(settings.lookaheadMs*0.001f*sampleRate/blockSize))),
+		attack(coefficient(settings.attackMs, sampleRate)),
+		release(coefficient(settings.releaseMs, sampleRate)),
+		limiterRelease(coefficient(settings.limiterReleaseMs, sampleRate)),
+		makeup(fromDb(settings.makeupDb)),
+		ceiling(fromDb(settings.ceilingDb)),
+		detectors(channels) {
+
+	reset();
+}
+
+size_t Dynamics::getLatency() const {
+	return lookaheadBlocks*blockSize;
+}
+
+void Dynamics::reset() {
+	delayLine.assign(getLatency()*numChannels, 0);
+	blocks.assign(lookaheadBlocks, {0, makeup});
+	position = inputBlock = 0;
+	peak = reduction = 0;
+	limiterGain = 1;
+	gainFrom = gainTo = makeup;
+	for (auto &detector: detectors)
+		detector.reset();
+}
+
+/*
+ * inter-sample peaks are estimated on the 2x upsampled signal. The
+ * upsampler lags Halfband::taps frames behind, so the first few
+ * upsampled frames of a block may belong to the previous one, which is
+ * then updated; at least 2 blocks of lookahead leave time for that to
+ * be taken into account before that block is output.
+ */
+void Dynamics::detect(const float *samples, size_t frames) {
+	size_t pos = position % blockSize;
+	size_t late = pos < Halfband::taps ? 2*std::min(Halfband::taps - pos, frames) : 0;
+	float previousPeak = 0;
+
+	peak = std::max(peak, peakOf(samples, frames*numChannels));
+
+	channel.resize(frames);
+	upsampled.resize(2*frames);
+	for (size_t c = 0; c < numChannels; ++c) {
+		for (size_t i = 0; i < frames; ++i)
+			channel[i] = samples[i*numChannels + c];
+		detectors[c].upsample(channel.data(), upsampled.data(), frames);
+
+		previousPeak = std::max(previousPeak, peakOf(upsampled.data(), late));
+		peak = std::max(peak, peakOf(upsampled.data() + late, 2*frames - late));
+	}
+
+	auto &previous = blocks[(inputBlock + lookaheadBlocks - 1) % lookaheadBlocks];
+	previous.peak = std::max(previous.peak, previousPeak);
+}
+
+void Dynamics::endInputBlock() {
+	float over = toDb(peak) - settings.thresholdDb;
+	float target = over > 0 && settings.ratio > 1 ? over*(1 - 1/settings.ratio) : 0; // reduction, in dB
+	reduction = target + (reduction - target)*(target > reduction ? attack : release);
+
+	blocks[inputBlock % lookaheadBlocks] = {peak, makeup*fromDb(-reduction)};
+	++inputBlock;
+	peak = 0;
+}
+
+/*
+ * the block leaving the delay line gets the compressor's gain, held down
+ * by the limiter's (recovering with its release time). Each upcoming
+ * block j, d blocks ahead, must start (and end) with a gain that keeps
+ * its peak under the ceiling: it's approached linearly, so it's reached
+ * exactly when block j comes out.
+ */
+void Dynamics::startOutputBlock() {
+	auto &outgoing = blocks[inputBlock % lookaheadBlocks]; // inputBlock - lookaheadBlocks
+	float previous = gainTo;
+	float gain = outgoing.gain*(1 - (1 - limiterGain)*limiterRelease);
+
+	gain = std::min(gain, ceiling/std::max(outgoing.peak, 1e-9f));
+	for (size_t d = 1; d < lookaheadBlocks; ++d) {
+		float cap = ceiling/std::max(blocks[(inputBlock + d) % lookaheadBlocks].peak, 1e-9f);
+		gain = std::min(gain, previous + (cap - previous)/d);
+	}
+
+	limiterGain = std::min(1.0f, gain/outgoing.gain);
+	gainFrom = previous;
+	gainTo = gain;
+}
+
+void Dynamics::process(float *samples, size_t frames) {
+	auto length = getLatency();
+
+	for (size_t done = 0; done < frames;) {
+		size_t pos = position % blockSize;
+		size_t n = std::min(blockSize - pos, frames - done);
+		float *in = samples + done*numChannels;
+
+		if (pos == 0)
+			startOutputBlock();
+
+		detect(in, n);
+
+		// the input goes into the delay line, the delayed signal comes out
+		std::swap_ranges(in, in + n*numChannels, delayLine.begin() + position*numChannels);
+
+		float step = (gainTo - gainFrom)/blockSize;
+		gain::apply(in, n, numChannels, gainFrom + step*pos, gainFrom + step*(pos + n));
+
+		position = (position + n) % length;
+		done += n;
+		if (pos + n == blockSize)
+			endInputBlock();
+	}
+}
+
+} /* namespace jukebox */
@@ -0,0 +1,88 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef JUKEBOX_UTIL_DYNAMICS_H_
+#define JUKEBOX_UTIL_DYNAMICS_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "Halfband.h"
+
+namespace jukebox {
+
+/*
+ * Compressor followed by a lookahead peak limiter, for interleaved float
+ * samples. Not tied to a decoder, so it can sit on a decorator as well as
+ * on a mix of several sounds.
+ *
+ * Levels are detected per block of blockSize frames, on the (2x
+ * oversampled) peak of all channels. The compressor smooths its gain
+ * reduction with attack/release; the limiter looks ahead 'lookahead' ms
+ * (the signal is delayed by that much) and ramps the gain down so it
+ * arrives at the right value when a peak does, keeping the output below
+ * the ceiling. The gain is ramped linearly across each block.
+ */
+class Dynamics {
+public:
+	struct Settings {
+		// compressor
+		float thresholdDb = -12; // peak level (dBFS) above which it compresses
+		float ratio = 1; // input dB above the threshold per output dB, 1 disables compression
+		float attackMs = 5; // time to reach a higher gain reduction
+		float releaseMs = 100; // time to let go of it
+		float makeupDb = 0; // gain added after compression
+		// limiter
+		float ceilingDb = -1; // peak output level (dBFS), never exceeded
+		float lookaheadMs = 5; // how early it sees peaks, also the delay added
+		float limiterReleaseMs = 50; // time to recover after a peak
+	};
+
+	Dynamics(int sampleRate, int channels, const Settings &settings);
+	void process(float *samples, size_t frames); // in place
+	void reset();
+	size_t getLatency() const; // in frames
+
+	static constexpr size_t blockSize = 32;
+private:
+	struct Block {
+		float peak, gain; // input peak, compressor + makeup gain
+	};
+
+	Settings settings;
+	size_t numChannels, lookaheadBlocks;
+	float attack, release, limiterRelease; // per block smoothing coefficients
+	float makeup, ceiling;
+
+	std::vector<float> delayLine;
+	std::vector<Block> blocks; // the last lookaheadBlocks input blocks
+	size_t position = 0; // frames processed, modulo the delay line length
+	size_t inputBlock = 0;
+	float peak = 0, reduction = 0; // of the current input block, compressor's (dB)
+	float limiterGain = 1;
+	float gainFrom = 1, gainTo = 1; // ramp of the block being output
+
+	std::vector<Halfband> detectors;
+	std::vector<float> channel, upsampled;
+
+	void detect(const float *samples, size_t frames);
+	void endInputBlock();
+	void startOutputBlock();
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_UTIL_DYNAMICS_H_ */
@@ -0,0 +1,169 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include "EventScheduler.h"
+
+namespace jukebox {
+
+namespace {
+
+using Event = EventScheduler::Event;
+
+void push(std::atomic<Event *> &stack, Event *event) {
+	event->next = stack.load(std::memory_order_relaxed);
+	while (!stack.compare_exchange_weak(event->next, event,
+			std::memory_order_release, std::memory_order_relaxed));
+}
+
+void deleteAll(Event *event) {
+	while (event) {
+		auto next = event->next;
+		delete event;
+		event = next;
+	}
+}
+
+bool laterFrame(const Event *a, const Event *b) {
+	return a->frame != b->frame ? a->frame > b->frame : a->seq > b->seq;
+}
+
+bool laterDeadline(const Event *a, const Event *b) {
+	return a->deadline != b->deadline ? a->deadline > b->deadline : a->seq > b->seq;
+}
+
+/*
+ * One thread shared by all sounds, it sleeps until the earliest deadline.
+ * The audio thread notifies without taking the mutex; should a wakeup be
+ * lost in between the predicate check and the wait, the bounded idle wait
+ * picks the event up (the device delay usually covers it).
+ */
+class EventDispatcher {
+public:
+	static EventDispatcher &getInstance() {
+		static EventDispatcher instance;
+		return instance;
+	}
+
+	void post(Event *event) {
+		push(incoming, event);
+		cond.notify_one();
+	}
+
+	~EventDispatcher() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		cond.notify_one();
+		thread.join();
+		deleteAll(incoming.exchange(nullptr));
+		for (auto event : due)
+			delete event;
+	}
+private:
+	std::atomic<Event *> incoming{nullptr};
+	std::vector<Event *> due; // min heap on (deadline, seq)
+	std::mutex mutex;
+	std::condition_variable cond;
+	bool stopping = false;
+	std::thread thread;
+
+	EventDispatcher() : thread([this]() { run(); }) {}
+
+	void run() {
+		std::unique_lock<std::mutex> lock(mutex);
+		while (!stopping) {
+			for (auto event = incoming.exchange(nullptr, std::memory_order_acquire); event;) {
+				auto next = event->next;
+				due.push_back(event);
+				std::push_heap(due.begin(), due.end(), laterDeadline);
+				event = next;
+			}
+
+			auto now = EventScheduler::Clock::now();
+			if (!due.empty() && due.front()->deadline <= now) {
+				std::pop_heap(due.begin(), due.end(), laterDeadline);
+				std::unique_ptr<Event> event(due.back());
+				due.pop_back();
+				lock.unlock();
+				event->callback();
+				lock.lock();
+				continue;
+			}
+
+			auto wakeup = now + std::chrono::milliseconds(10); // idle wait
+			if (!due.empty())
+				wakeup = std::min(wakeup, due.front()->deadline);
+			cond.wait_until(lock, wakeup, [this]() {
+				return stopping || incoming.load(std::memory_order_relaxed) != nullptr;
+			});
+		}
+	}
+};
+
+}
+
+constexpr size_t EventScheduler::maxPending;
+
+EventScheduler::EventScheduler() {
+	pending.reserve(maxPending);
+	EventDispatcher::getInstance(); // don't start the thread from the audio thread
+}
+
+EventScheduler::~EventScheduler() {
+	deleteAll(incoming.exchange(nullptr));
+	for (auto event : pending)
+		delete event;
+}
+
+void EventScheduler::schedule(size_t frame, Callback callback) {
+	if (scheduled.fetch_add(1) >= maxPending) {
+		--scheduled;
+		throw std::runtime_error("too many timed events pending");
+	}
+	push(incoming, new Event{frame, seq++, {}, std::move(callback), nullptr});
+}
+
+void EventScheduler::process(size_t first, size_t frames, size_t delay, int sampleRate) {
+	for (auto event = incoming.exchange(nullptr, std::memory_order_acquire); event;) {
+		auto next = event->next;
+		pending.push_back(event); // within the capacity reserved, schedule() saw to it
+		std::push_heap(pending.begin(), pending.end(), laterFrame);
+		event = next;
+	}
+
+	auto now = Clock::now();
+	auto last = first + frames;
+	while (!pending.empty() && pending.front()->frame < last) {
+		std::pop_heap(pending.begin(), pending.end(), laterFrame);
+		auto event = pending.back();
+		pending.pop_back();
+
+		auto offset = delay + (event->frame > first ? event->frame - first : 0);
+		event->deadline = now + std::chrono::duration_cast<Clock::duration>(
+				std::chrono::duration<double>(static_cast<double>(offset) / sampleRate));
+		EventDispatcher::getInstance().post(event);
+		--scheduled;
+	}
+}
+
+} /* namespace jukebox */
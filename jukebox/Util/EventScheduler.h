@@ -0,0 +1,71 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef JUKEBOX_UTIL_EVENTSCHEDULER_H_
+#define JUKEBOX_UTIL_EVENTSCHEDULER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace jukebox {
+
+/*
+ * Frame accurate one shot events. Any thread may schedule(); the audio
+ * thread calls process() for each block it hands to the device. Due events
+ * are posted to a shared dispatcher thread, which runs each callback when
+ * its frame is expected to be heard, so the audio thread never locks,
+ * allocates or runs user code.
+ */
+class EventScheduler {
+public:
+	using Callback = std::function<void(void)>;
+	using Clock = std::chrono::steady_clock;
+
+	EventScheduler();
+	~EventScheduler();
+	void schedule(size_t frame, Callback callback); // throws beyond maxPending events not yet due
+	/*
+	 * frames [first, first + frames) were just queued to the device, 'delay'
+	 * frames ahead of the one being played now. Events scheduled before
+	 * 'first' (e.g. after a seek) fire right away.
+	 */
+	void process(size_t first, size_t frames, size_t delay, int sampleRate);
+
+	struct Event {
+		size_t frame;
+		uint64_t seq;
+		Clock::time_point deadline;
+		Callback callback;
+		Event *next;
+	};
+private:
+	EventScheduler(const EventScheduler &) = delete;
+	EventScheduler &operator=(const EventScheduler &) = delete;
+
+	static constexpr size_t maxPending = 4096;
+
+	std::atomic<Event *> incoming{nullptr}; // lock free MPSC stack
+	std::atomic<uint64_t> seq{0};
+	std::atomic<size_t> scheduled{0}; // not yet posted, bounds pending
+	std::vector<Event *> pending; // min heap on (frame, seq), audio thread only, never grows
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_UTIL_EVENTSCHEDULER_H_ */
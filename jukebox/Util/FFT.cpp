@@ -0,0 +1,119 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <cmath>
+#include <stdexcept>
+
+#include "FFT.h"
+
+namespace jukebox {
+
+FFT::FFT(size_t size) :
+		n(size),
+		half(size/2),
+		twiddles(half/2),
+		realTwiddles(half + 1),
+		bitReverse(half),
+		work(half) {
+
+	if (size < 4 || (size & (size - 1)) != 0)
+		throw std::runtime_error("FFT size must be a power of two.");
+
+	const double pi = std::acos(-1.0);
+
+	for (size_t i = 0; i < twiddles.size(); ++i)
+		twiddles[i] = std::polar(1.0, -2.0*pi*i/half);
+
+	for (size_t i = 0; i < realTwiddles.size(); ++i)
+		realTwiddles[i] = std::polar(1.0, -2.0*pi*i/n);
+
+	size_t bits = 0;
+	while (((size_t)1 << bits) < half)
+		++bits;
+	for (size_t i = 0; i < half; ++i) {
+		size_t r = 0;
+		for (size_t b = 0; b < bits; ++b)
+			r |= ((i >> b) & 1) << (bits - 1 - b);
+		bitReverse[i] = r;
+	}
+}
+
+size_t FFT::size() const {
+	return n;
+}
+
+// in place, forward, unscaled; data must already be in bit reversed order
+void FFT::transform(std::complex<float> *data) {
+	for (size_t len = 2; len <= half; len <<= 1) {
+		size_t step = half/len;
+		for (size_t i = 0; i < half; i += len) {
+			auto *a = data + i, *b = data + i + len/2;
+			for (size_t j = 0; j < len/2; ++j) {
+				auto w = twiddles[j*step];
+				float re = b[j].real()*w.real() - b[j].imag()*w.imag();
+				float im = b[j].real()*w.imag() + b[j].imag()*w.real();
+				b[j] = {a[j].real() - re, a[j].imag() - im};
+				a[j] = {a[j].real() + re, a[j].imag() + im};
+			}
+		}
+	}
+}
+
+/*
+ * even samples go in the real part and odd ones in the imaginary part of
+ * a half size complex transform, whose output is then split into the
+ * spectra of both halves and merged (X[k] = E[k] + W^k*O[k]).
+ */
+void FFT::forward(const float *in, std::complex<float> *out) {
+	for (size_t i = 0; i < half; ++i)
+		work[bitReverse[i]] = {in[2*i], in[2*i + 1]};
+	transform(work.data());
+
+	for (size_t k = 0; k <= half; ++k) {
+		auto z = work[k == half ? 0 : k];
+		auto zc = std::conj(work[k == 0 ? 0 : half - k]);
+		std::complex<float> even((z.real() + zc.real())*0.5f, (z.imag() + zc.imag())*0.5f);
+		std::complex<float> odd((z.imag() - zc.imag())*0.5f, (zc.real() - z.real())*0.5f); // (z - zc)/2i
+		auto w = realTwiddles[k];
+		out[k] = {
+			even.real() + odd.real()*w.real() - odd.imag()*w.imag(),
+			even.imag() + odd.real()*w.imag() + odd.imag()*w.real()};
+	}
+}
+
+void FFT::inverse(const std::complex<float> *in, float *out) {
+	for (size_t k = 0; k < half; ++k) {
+		auto x = in[k];
+		auto xc = std::conj(in[half - k]);
+		std::complex<float> even((x.real() + xc.real())*0.5f, (x.imag() + xc.imag())*0.5f);
+		std::complex<float> diff((x.real() - xc.real())*0.5f, (x.imag() - xc.imag())*0.5f);
+		auto w = std::conj(realTwiddles[k]);
+		std::complex<float> odd( // diff/W^k
+			diff.real()*w.real() - diff.imag()*w.imag(),
+			diff.real()*w.imag() + diff.imag()*w.real());
+		// inverse through the forward transform: conj(FFT(conj(Z)))
+		work[bitReverse[k]] = {even.real() - odd.imag(), -(even.imag() + odd.real())};
+	}
+	transform(work.data());
+
+	float scale = 1.0f/(float)half;
+	for (size_t i = 0; i < half; ++i) {
+		out[2*i] = work[i].real()*scale;
+		out[2*i + 1] = -work[i].imag()*scale;
+	}
+}
+
+} /* namespace jukebox */
@@ -0,0 +1,48 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef JUKEBOX_UTIL_FFT_H_
+#define JUKEBOX_UTIL_FFT_H_
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace jukebox {
+
+/* Radix-2 FFT of real signals. size must be a power of two (>= 4);
+ * a real transform is computed with a complex one of half the size.
+ * The spectrum of a real signal of 'size' samples has size/2 + 1 bins.
+ */
+class FFT {
+public:
+	FFT(size_t size);
+	size_t size() const;
+	void forward(const float *in, std::complex<float> *out);
+	void inverse(const std::complex<float> *in, float *out); // scaled by 1/size, inverse(forward(x)) == x
+private:
+	size_t n, half;
+	std::vector<std::complex<float> > twiddles; // complex transform (half points)
+	std::vector<std::complex<float> > realTwiddles; // split/merge of the real transform
+	std::vector<size_t> bitReverse;
+	std::vector<std::complex<float> > work;
+
+	void transform(std::complex<float> *data);
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_UTIL_FFT_H_ */
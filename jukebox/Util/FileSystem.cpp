@@ -0,0 +1,134 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <cstdio>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#include <utime.h>
+#endif
+
+#include "FileSystem.h"
+
+namespace jukebox {
+
+#ifdef _WIN32
+
+FileStat statFile(const std::string &path) {
+	FileStat st;
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if (GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &data)) {
+		st.exists = true;
+		st.directory = data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY;
+		st.link = data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT;
+		st.size = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+		auto time = ((int64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+		st.modified = (time - 116444736000000000ll) / 10000000; // 100ns units since 1601
+		st.modifiedNanos = (time % 10000000) * 100;
+	}
+	return st;
+}
+
+std::vector<std::string> listDirectory(const std::string &path) {
+	std::vector<std::string> names;
+	WIN32_FIND_DATAA entry;
+	auto handle = FindFirstFileA((path + "\\*").c_str(), &entry);
+	if (handle == INVALID_HANDLE_VALUE)
+		return names;
+	do {
+		std::string name = entry.cFileName;
+		if (name != "." && name != "..")
+			names.push_back(name);
+	} while (FindNextFileA(handle, &entry));
+	FindClose(handle);
+	return names;
+}
+
+bool makeDirectory(const std::string &path) {
+	return CreateDirectoryA(path.c_str(), NULL) || GetLastError() == ERROR_ALREADY_EXISTS;
+}
+
+bool renameFile(const std::string &from, const std::string &to) {
+	return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING);
+}
+
+void touchFile(const std::string &path) {
+	auto handle = CreateFileA(path.c_str(), FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (handle == INVALID_HANDLE_VALUE)
+		return;
+	FILETIME now;
+	GetSystemTimeAsFileTime(&now);
+	SetFileTime(handle, NULL, NULL, &now);
+	CloseHandle(handle);
+}
+
+#else
+
+FileStat statFile(const std::string &path) {
+	FileStat st;
+	struct stat data;
+	if (stat(path.c_str(), &data) == 0) {
+		st.exists = true;
+		st.directory = S_ISDIR(data.st_mode);
+		st.size = data.st_size;
+		st.id = ((uint64_t)data.st_dev << 32) ^ data.st_ino;
+		st.modified = data.st_mtime;
+		st.modifiedNanos = data.st_mtim.tv_nsec;
+	}
+	return st;
+}
+
+std::vector<std::string> listDirectory(const std::string &path) {
+	std::vector<std::string> names;
+	auto dir = opendir(path.c_str());
+	if (dir == nullptr)
+		return names;
+	while (auto entry = readdir(dir)) {
+		std::string name = entry->d_name;
+		if (name != "." && name != "..")
+			names.push_back(name);
+	}
+	closedir(dir);
+	return names;
+}
+
+bool makeDirectory(const std::string &path) {
+	return mkdir(path.c_str(), 0777) == 0 || statFile(path).directory;
+}
+
+bool renameFile(const std::string &from, const std::string &to) {
+	return std::rename(from.c_str(), to.c_str()) == 0;
+}
+
+void touchFile(const std::string &path) {
+	utime(path.c_str(), nullptr);
+}
+
+#endif
+
+bool removeFile(const std::string &path) {
+	return std::remove(path.c_str()) == 0;
+}
+
+} /* namespace jukebox */
@@ -0,0 +1,44 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef JUKEBOX_UTIL_FILESYSTEM_H_
+#define JUKEBOX_UTIL_FILESYSTEM_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace jukebox {
+
+struct FileStat {
+	bool exists = false, directory = false, link = false; // link: a reparse point (Windows)
+	uint64_t size = 0;
+	uint64_t id = 0; // device and inode, 0 where there are none
+	int64_t modified = 0; // last write time, seconds since the epoch
+	uint32_t modifiedNanos = 0; // and nanoseconds past it, as fine as the file system keeps it
+};
+
+FileStat statFile(const std::string &path);
+std::vector<std::string> listDirectory(const std::string &path); // names, without . and ..
+bool makeDirectory(const std::string &path); // true if it exists afterwards
+bool removeFile(const std::string &path);
+bool renameFile(const std::string &from, const std::string &to); // replacing to
+void touchFile(const std::string &path); // sets its write time to now
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_UTIL_FILESYSTEM_H_ */
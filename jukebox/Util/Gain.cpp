@@ -0,0 +1,294 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <cmath>
+#include <algorithm>
+
+#include "Gain.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JUKEBOX_GAIN_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(JUKEBOX_GAIN_SSE2) && defined(__GNUC__)
+#define JUKEBOX_GAIN_AVX2
+#include <immintrin.h>
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace jukebox {
+namespace gain {
+
+namespace {
+
+/* The gain of sample i is from + step * (i / channels + 1), computed the
+ * same way by every kernel so the vector paths and the scalar tail agree.
+ * The vector ramps find the frame of each lane as (i + 0.5) / channels
+ * truncated, exact for the blocks this is used on (below 2^20 samples).
+ */
+
+uint8_t scale(uint8_t s, float g) {
+	long v = std::lrint(static_cast<float>(s - 128) * g) + 128;
+	return static_cast<uint8_t>(std::min(std::max(v, 0L), 255L));
+}
+
+int16_t scale(int16_t s, float g) {
+	long v = std::lrint(static_cast<float>(s) * g);
+	return static_cast<int16_t>(std::min(std::max(v, -32768L), 32767L));
+}
+
+Int24 scale(Int24 s, float g) {
+	long v = std::lrint(static_cast<float>(s) * g);
+	return std::min(std::max(v, -8388608L), 8388607L);
+}
+
+int32_t scale(int32_t s, float g) {
+	double v = std::min(std::max(static_cast<double>(s) * static_cast<double>(g), -2147483648.0), 2147483647.0);
+	return static_cast<int32_t>(std::lrint(v));
+}
+
+float scale(float s, float g) {
+	return s * g;
+}
+
+template<typename T>
+void scalarKernel(T *buf, size_t begin, size_t end, size_t channels, float from, float step) {
+	for (auto i = begin; i < end; ++i)
+		buf[i] = scale(buf[i], from + step * static_cast<float>(i / channels + 1));
+}
+
+#ifdef JUKEBOX_GAIN_SSE2
+
+struct Ramp4 {
+	Ramp4(float from, float step, size_t channels) :
+		from(_mm_set1_ps(from)),
+		step(_mm_set1_ps(step)),
+		perSample(_mm_set1_ps(1.0f / static_cast<float>(channels))),
+		idx(_mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f)) {};
+
+	__m128 next() {
+		auto frame = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(idx, perSample)));
+		auto g = _mm_add_ps(from, _mm_mul_ps(step, _mm_add_ps(frame, _mm_set1_ps(1))));
+		idx = _mm_add_ps(idx, _mm_set1_ps(4));
+		return g;
+	}
+
+	__m128 from, step, perSample, idx;
+};
+
+size_t sse2Kernel(uint8_t *buf, size_t count, size_t channels, float from, float step) {
+	Ramp4 ramp(from, step, channels);
+	auto zero = _mm_setzero_si128();
+	auto bias = _mm_set1_epi16(128);
+	size_t n = count & ~static_cast<size_t>(15);
+
+	for (size_t i = 0; i < n; i += 16) {
+		auto x = _mm_loadu_si128(reinterpret_cast<__m128i *>(buf + i));
+		auto lo = _mm_sub_epi16(_mm_unpacklo_epi8(x, zero), bias);
+		auto hi = _mm_sub_epi16(_mm_unpackhi_epi8(x, zero), bias);
+		__m128i v[4] = {
+			_mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 16),
+			_mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 16),
+			_mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 16),
+			_mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 16)};
+		for (auto &w : v)
+			w = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(w), ramp.next()));
+		lo = _mm_adds_epi16(_mm_packs_epi32(v[0], v[1]), bias);
+		hi = _mm_adds_epi16(_mm_packs_epi32(v[2], v[3]), bias);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(buf + i), _mm_packus_epi16(lo, hi));
+	}
+	return n;
+}
+
+size_t sse2Kernel(int16_t *buf, size_t count, size_t channels, float from, float step) {
+	Ramp4 ramp(from, step, channels);
+	size_t n = count & ~static_cast<size_t>(7);
+
+	for (size_t i = 0; i < n; i += 8) {
+		auto x = _mm_loadu_si128(reinterpret_cast<__m128i *>(buf + i));
+		auto lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+		auto hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16));
+		lo = _mm_mul_ps(lo, ramp.next());
+		hi = _mm_mul_ps(hi, ramp.next());
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(buf + i),
+			_mm_packs_epi32(_mm_cvtps_epi32(lo), _mm_cvtps_epi32(hi)));
+	}
+	return n;
+}
+
+size_t sse2Kernel(int32_t *buf, size_t count, size_t channels, float from, float step) {
+	Ramp4 ramp(from, step, channels);
+	auto minVal = _mm_set1_pd(-2147483648.0);
+	auto maxVal = _mm_set1_pd(2147483647.0);
+	size_t n = count & ~static_cast<size_t>(3);
+
+	for (size_t i = 0; i < n; i += 4) {
+		auto x = _mm_loadu_si128(reinterpret_cast<__m128i *>(buf + i));
+		auto g = ramp.next();
+		auto lo = _mm_mul_pd(_mm_cvtepi32_pd(x), _mm_cvtps_pd(g));
+		auto hi = _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(x, 8)), _mm_cvtps_pd(_mm_movehl_ps(g, g)));
+		lo = _mm_min_pd(_mm_max_pd(lo, minVal), maxVal);
+		hi = _mm_min_pd(_mm_max_pd(hi, minVal), maxVal);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(buf + i),
+			_mm_unpacklo_epi64(_mm_cvtpd_epi32(lo), _mm_cvtpd_epi32(hi)));
+	}
+	return n;
+}
+
+size_t sse2Kernel(float *buf, size_t count, size_t channels, float from, float step) {
+	Ramp4 ramp(from, step, channels);
+	size_t n = count & ~static_cast<size_t>(3);
+
+	for (size_t i = 0; i < n; i += 4)
+		_mm_storeu_ps(buf + i, _mm_mul_ps(_mm_loadu_ps(buf + i), ramp.next()));
+	return n;
+}
+
+#endif
+
+#ifdef JUKEBOX_GAIN_AVX2
+
+const bool hasAVX2 = __builtin_cpu_supports("avx2");
+
+struct Ramp8 {
+	AVX2_TARGET Ramp8(float from, float step, size_t channels) :
+		from(_mm256_set1_ps(from)),
+		step(_mm256_set1_ps(step)),
+		perSample(_mm256_set1_ps(1.0f / static_cast<float>(channels))),
+		idx(_mm256_set_ps(7.5f, 6.5f, 5.5f, 4.5f, 3.5f, 2.5f, 1.5f, 0.5f)) {};
+
+	AVX2_TARGET __m256 next() {
+		auto frame = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(_mm256_mul_ps(idx, perSample)));
+		auto g = _mm256_add_ps(from, _mm256_mul_ps(step, _mm256_add_ps(frame, _mm256_set1_ps(1))));
+		idx = _mm256_add_ps(idx, _mm256_set1_ps(8));
+		return g;
+	}
+
+	__m256 from, step, perSample, idx;
+};
+
+AVX2_TARGET size_t avx2Kernel(uint8_t *buf, size_t count, size_t channels, float from, float step) {
+	Ramp8 ramp(from, step, channels);
+	auto bias32 = _mm256_set1_epi32(128);
+	auto bias16 = _mm256_set1_epi16(128);
+	size_t n = count & ~static_cast<size_t>(15);
+
+	for (size_t i = 0; i < n; i += 16) {
+		auto x = _mm_loadu_si128(reinterpret_cast<__m128i *>(buf + i));
+		auto lo = _mm256_sub_epi32(_mm256_cvtepu8_epi32(x), bias32);
+		auto hi = _mm256_sub_epi32(_mm256_cvtepu8_epi32(_mm_srli_si128(x, 8)), bias32);
+		lo = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(lo), ramp.next()));
+		hi = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(hi), ramp.next()));
+		auto v = _mm256_adds_epi16(_mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xD8), bias16);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(buf + i),
+			_mm_packus_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+	}
+	return n;
+}
+
+AVX2_TARGET size_t avx2Kernel(int16_t *buf, size_t count, size_t channels, float from, float step) {
+	Ramp8 ramp(from, step, channels);
+	size_t n = count & ~static_cast<size_t>(15);
+
+	for (size_t i = 0; i < n; i += 16) {
+		auto x = _mm256_loadu_si256(reinterpret_cast<__m256i *>(buf + i));
+		auto lo = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(x)));
+		auto hi = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(x, 1)));
+		lo = _mm256_mul_ps(lo, ramp.next());
+		hi = _mm256_mul_ps(hi, ramp.next());
+		auto v = _mm256_packs_epi32(_mm256_cvtps_epi32(lo), _mm256_cvtps_epi32(hi));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(buf + i), _mm256_permute4x64_epi64(v, 0xD8));
+	}
+	return n;
+}
+
+AVX2_TARGET size_t avx2Kernel(int32_t *buf, size_t count, size_t channels, float from, float step) {
+	Ramp8 ramp(from, step, channels);
+	auto minVal = _mm256_set1_pd(-2147483648.0);
+	auto maxVal = _mm256_set1_pd(2147483647.0);
+	size_t n = count & ~static_cast<size_t>(7);
+
+	for (size_t i = 0; i < n; i += 8) {
+		auto x = _mm256_loadu_si256(reinterpret_cast<__m256i *>(buf + i));
+		auto g = ramp.next();
+		auto lo = _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(x)), _mm256_cvtps_pd(_mm256_castps256_ps128(g)));
+		auto hi = _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(x, 1)), _mm256_cvtps_pd(_mm256_extractf128_ps(g, 1)));
+		lo = _mm256_min_pd(_mm256_max_pd(lo, minVal), maxVal);
+		hi = _mm256_min_pd(_mm256_max_pd(hi, minVal), maxVal);
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(buf + i),
+			_mm256_set_m128i(_mm256_cvtpd_epi32(hi), _mm256_cvtpd_epi32(lo)));
+	}
+	return n;
+}
+
+AVX2_TARGET size_t avx2Kernel(float *buf, size_t count, size_t channels, float from, float step) {
+	Ramp8 ramp(from, step, channels);
+	size_t n = count & ~static_cast<size_t>(7);
+
+	for (size_t i = 0; i < n; i += 8)
+		_mm256_storeu_ps(buf + i, _mm256_mul_ps(_mm256_loadu_ps(buf + i), ramp.next()));
+	return n;
+}
+
+#endif
+
+template<typename T>
+void run(T *buf, size_t frames, size_t channels, float from, float to) {
+	if (frames == 0)
+		return;
+
+	auto count = frames * channels;
+	auto step = (to - from) / static_cast<float>(frames);
+	size_t done = 0;
+
+#ifdef JUKEBOX_GAIN_AVX2
+	if (hasAVX2)
+		done = avx2Kernel(buf, count, channels, from, step);
+	else
+#endif
+#ifdef JUKEBOX_GAIN_SSE2
+		done = sse2Kernel(buf, count, channels, from, step);
+#endif
+
+	scalarKernel(buf, done, count, channels, from, step);
+}
+
+}
+
+void apply(uint8_t *buf, size_t frames, size_t channels, float from, float to) {
+	run(buf, frames, channels, from, to);
+}
+
+void apply(int16_t *buf, size_t frames, size_t channels, float from, float to) {
+	run(buf, frames, channels, from, to);
+}
+
+void apply(Int24 *buf, size_t frames, size_t channels, float from, float to) {
+	if (frames > 0)
+		scalarKernel(buf, 0, frames * channels, channels, from, (to - from) / static_cast<float>(frames));
+}
+
+void apply(int32_t *buf, size_t frames, size_t channels, float from, float to) {
+	run(buf, frames, channels, from, to);
+}
+
+void apply(float *buf, size_t frames, size_t channels, float from, float to) {
+	run(buf, frames, channels, from, to);
+}
+
+}
+} /* namespace jukebox */
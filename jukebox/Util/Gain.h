@@ -0,0 +1,46 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef JUKEBOX_UTIL_GAIN_H_
+#define JUKEBOX_UTIL_GAIN_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "SampleTypes.h"
+
+namespace jukebox {
+namespace gain {
+
+/* Scales frames of interleaved samples in place, ramping linearly from
+ * gain 'from' to gain 'to' across the block (the last frame gets 'to').
+ * The ramp advances once per frame, every channel of a frame gets the
+ * same gain. Use from == to for a constant gain. Unsigned 8 bit samples are scaled around their
+ * silence level (128), integer results are rounded and saturated.
+ *
+ * The kernels are vectorized (SSE2, or AVX2 when the CPU supports it),
+ * except for packed 24 bit samples.
+ */
+void apply(uint8_t *buf, size_t frames, size_t channels, float from, float to);
+void apply(int16_t *buf, size_t frames, size_t channels, float from, float to);
+void apply(Int24 *buf, size_t frames, size_t channels, float from, float to);
+void apply(int32_t *buf, size_t frames, size_t channels, float from, float to);
+void apply(float *buf, size_t frames, size_t channels, float from, float to);
+
+}
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_UTIL_GAIN_H_ */
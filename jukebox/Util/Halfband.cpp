@@ -0,0 +1,201 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "Halfband.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JUKEBOX_HALFBAND_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace jukebox {
+
+constexpr size_t Halfband::taps;
+
+namespace {
+
+// odd taps 1, 3, 5... of the (symmetric) filter, normalized to unity DC gain
+std::array<float, Halfband::taps> makeCoefficients() {
+	std::array<float, Halfband::taps> c;
+	const double pi = std::acos(-1.0);
+	const double half = 2*Halfband::taps; // window half length
+	double sum = 0;
+
+	for (size_t k = 0; k < c.size(); ++k) {
+		double m = 2*k + 1;
+		double window = 0.42 + 0.5*std::cos(pi*m/half) + 0.08*std::cos(2*pi*m/half);
+		c[k] = std::sin(pi*m/2)/(pi*m)*window;
+		sum += c[k];
+	}
+	for (auto &v: c) // center tap is 0.5, so each side must add up to 0.25
+		v *= 0.25/sum;
+
+	return c;
+}
+
+const std::array<float, Halfband::taps> sharpCoefficients = makeCoefficients();
+
+// minimax design for a -74dB stopband from 0.387, odd taps as above
+constexpr size_t wideTaps = 4;
+const std::array<float, wideTaps> wideCoefficients = {0.30435962f, -0.07003481f, 0.018722672f, -0.0030474845f};
+
+// sum of c[k]*(desc[-k] + asc[k]), the filter folded around its center
+template<size_t Taps>
+inline float symmetricSum(const float *desc, const float *asc, const float *c) {
+	float sum = 0;
+	for (size_t k = 0; k < Taps; ++k)
+		sum += c[k]*(desc[-(int)k] + asc[k]);
+	return sum;
+}
+
+#ifdef JUKEBOX_HALFBAND_SSE2
+// same, for 4 consecutive outputs; two accumulators to shorten the dependency chain
+template<size_t Taps>
+inline __m128 symmetricSum4(const float *desc, const float *asc, const __m128 *c) {
+	static_assert(Taps % 2 == 0, "taps are summed in pairs");
+	auto a = _mm_setzero_ps(), b = _mm_setzero_ps();
+	for (size_t k = 0; k < Taps; k += 2) {
+		a = _mm_add_ps(a, _mm_mul_ps(c[k],
+			_mm_add_ps(_mm_loadu_ps(desc - k), _mm_loadu_ps(asc + k))));
+		b = _mm_add_ps(b, _mm_mul_ps(c[k + 1],
+			_mm_add_ps(_mm_loadu_ps(desc - k - 1), _mm_loadu_ps(asc + k + 1))));
+	}
+	return _mm_add_ps(a, b);
+}
+#endif
+
+/*
+ * even outputs are the (delayed) input samples themselves, odd ones are
+ * interpolated from the 2*Taps input samples around them (times 2, to
+ * make up for the zero stuffed samples). x starts with 2*Taps of history.
+ */
+template<size_t Taps>
+void upsampleBlock(const float *x, const float *coefficients, float *out, size_t count) {
+	size_t n = 0;
+
+#ifdef JUKEBOX_HALFBAND_SSE2
+	__m128 c[Taps];
+	for (size_t k = 0; k < Taps; ++k)
+		c[k] = _mm_set1_ps(2*coefficients[k]);
+
+	for (; n + 8 <= count; n += 8) { // two independent blocks of 4 per iteration
+		auto odd0 = symmetricSum4<Taps>(x + n + Taps, x + n + Taps + 1, c);
+		auto odd1 = symmetricSum4<Taps>(x + n + 4 + Taps, x + n + 4 + Taps + 1, c);
+		auto even0 = _mm_loadu_ps(x + n + Taps), even1 = _mm_loadu_ps(x + n + 4 + Taps);
+		_mm_storeu_ps(out + 2*n, _mm_unpacklo_ps(even0, odd0));
+		_mm_storeu_ps(out + 2*n + 4, _mm_unpackhi_ps(even0, odd0));
+		_mm_storeu_ps(out + 2*n + 8, _mm_unpacklo_ps(even1, odd1));
+		_mm_storeu_ps(out + 2*n + 12, _mm_unpackhi_ps(even1, odd1));
+	}
+#endif
+
+	for (; n < count; ++n) {
+		out[2*n] = x[n + Taps];
+		out[2*n + 1] = 2*symmetricSum<Taps>(x + n + Taps, x + n + Taps + 1, coefficients);
+	}
+}
+
+/*
+ * only the kept outputs are computed. They're centered on even input
+ * samples, so the (non zero) taps only ever see odd ones: the input is
+ * split in even and odd samples and both are filtered at the output rate.
+ * Both start with 2*Taps of history.
+ */
+template<size_t Taps>
+void downsampleBlock(const float *even, const float *odd, const float *coefficients, float *out, size_t count) {
+	size_t n = 0;
+	even += Taps;
+
+#ifdef JUKEBOX_HALFBAND_SSE2
+	__m128 c[Taps], half = _mm_set1_ps(0.5f);
+	for (size_t k = 0; k < Taps; ++k)
+		c[k] = _mm_set1_ps(coefficients[k]);
+
+	for (; n + 8 <= count; n += 8) {
+		auto sum0 = symmetricSum4<Taps>(odd + n + Taps - 1, odd + n + Taps, c);
+		auto sum1 = symmetricSum4<Taps>(odd + n + 4 + Taps - 1, odd + n + 4 + Taps, c);
+		_mm_storeu_ps(out + n, _mm_add_ps(sum0, _mm_mul_ps(half, _mm_loadu_ps(even + n))));
+		_mm_storeu_ps(out + n + 4, _mm_add_ps(sum1, _mm_mul_ps(half, _mm_loadu_ps(even + n + 4))));
+	}
+#endif
+
+	for (; n < count; ++n)
+		out[n] = 0.5f*even[n] + symmetricSum<Taps>(odd + n + Taps - 1, odd + n + Taps, coefficients);
+}
+
+}
+
+Halfband::Halfband(Response response) :
+	coefficients(response == Response::sharp ? sharpCoefficients.data() : wideCoefficients.data()),
+	numTaps(response == Response::sharp ? taps : wideTaps) {
+
+	reset();
+}
+
+// histories of 2*numTaps input samples (even/odd pairs, downsampling)
+void Halfband::reset() {
+	upBuffer.assign(2*numTaps, 0);
+	evenBuffer.assign(2*numTaps, 0);
+	oddBuffer.assign(2*numTaps, 0);
+}
+
+void Halfband::upsample(const float *in, float *out, size_t count) {
+	auto history = 2*numTaps;
+	upBuffer.resize(history + count);
+	std::copy(in, in + count, upBuffer.begin() + history);
+
+	if (numTaps == taps)
+		upsampleBlock<taps>(upBuffer.data(), coefficients, out, count);
+	else
+		upsampleBlock<wideTaps>(upBuffer.data(), coefficients, out, count);
+
+	std::copy(upBuffer.end() - history, upBuffer.end(), upBuffer.begin());
+}
+
+void Halfband::downsample(const float *in, float *out, size_t count) {
+	auto history = 2*numTaps;
+	evenBuffer.resize(history + count);
+	oddBuffer.resize(history + count);
+	auto even = evenBuffer.data() + history, odd = oddBuffer.data() + history;
+	size_t i = 0;
+
+#ifdef JUKEBOX_HALFBAND_SSE2
+	for (; i + 4 <= count; i += 4) {
+		auto a = _mm_loadu_ps(in + 2*i), b = _mm_loadu_ps(in + 2*i + 4);
+		_mm_storeu_ps(even + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+		_mm_storeu_ps(odd + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+	}
+#endif
+
+	for (; i < count; ++i) {
+		even[i] = in[2*i];
+		odd[i] = in[2*i + 1];
+	}
+
+	if (numTaps == taps)
+		downsampleBlock<taps>(evenBuffer.data(), oddBuffer.data(), coefficients, out, count);
+	else
+		downsampleBlock<wideTaps>(evenBuffer.data(), oddBuffer.data(), coefficients, out, count);
+
+	std::copy(evenBuffer.end() - history, evenBuffer.end(), evenBuffer.begin());
+	std::copy(oddBuffer.end() - history, oddBuffer.end(), oddBuffer.begin());
+}
+
+} /* namespace jukebox */
@@ -0,0 +1,56 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef JUKEBOX_UTIL_HALFBAND_H_
+#define JUKEBOX_UTIL_HALFBAND_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace jukebox {
+
+/* 2x up/downsampler for a single channel, using a halfband FIR (every
+ * other tap is zero). The sharp response is a 31 tap Blackman windowed
+ * sinc. The wide one is a 15 tap equiripple filter, flat only up to
+ * 0.113 of the higher rate and -74dB from 0.387 on (as deep as the sharp
+ * one): enough for the second stage of a 4x cascade, whose input holds
+ * nothing above the first stage's band, at half the cost.
+ * Each direction keeps its own history, so blocks of any size can be
+ * streamed through it. Upsampling and then downsampling delays the
+ * signal by twice the non zero taps on a side (16 samples at the lower
+ * rate for the sharp response). Both directions are vectorized with SSE2.
+ */
+class Halfband {
+public:
+	enum class Response { sharp, wide };
+
+	Halfband(Response response = Response::sharp);
+	void upsample(const float *in, float *out, size_t count); // count samples in, 2*count out
+	void downsample(const float *in, float *out, size_t count); // 2*count samples in, count out
+	void reset();
+
+	static constexpr size_t taps = 8; // non zero taps on each side of the center one, sharp response
+private:
+	const float *coefficients;
+	size_t numTaps;
+
+	// history followed by the block being filtered
+	std::vector<float> upBuffer, evenBuffer, oddBuffer;
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_UTIL_HALFBAND_H_ */
@@ -0,0 +1,221 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <algorithm>
+#include <cstring>
+
+#include "QOA.h"
+
+namespace jukebox {
+namespace qoa {
+
+static const int scaleFactors[16] = {1, 7, 21, 45, 84, 138, 211, 304, 421, 562, 731, 928, 1157, 1419, 1715, 2048};
+
+// ((1 << 16) + sf - 1) / sf, so dividing by a scale factor is a multiply
+static const int reciprocals[16] = {65536, 9363, 3121, 1457, 781, 475, 311, 216, 156, 117, 90, 71, 57, 47, 39, 32};
+
+// quantized residual (-8..8, offset by 8) to its 3 bit code
+static const int quantized[17] = {7, 7, 7, 5, 5, 3, 3, 1, 0, 0, 2, 2, 4, 4, 6, 6, 6};
+
+// round(sf * {0.75, -0.75, 2.5, -2.5, 4.5, -4.5, 7, -7}) per scale factor
+static const int dequantized[16][8] = {
+	{1, -1, 3, -3, 5, -5, 7, -7},
+	{5, -5, 18, -18, 32, -32, 49, -49},
+	{16, -16, 53, -53, 95, -95, 147, -147},
+	{34, -34, 113, -113, 203, -203, 315, -315},
+	{63, -63, 210, -210, 378, -378, 588, -588},
+	{104, -104, 345, -345, 621, -621, 966, -966},
+	{158, -158, 528, -528, 950, -950, 1477, -1477},
+	{228, -228, 760, -760, 1368, -1368, 2128, -2128},
+	{316, -316, 1053, -1053, 1895, -1895, 2947, -2947},
+	{422, -422, 1405, -1405, 2529, -2529, 3934, -3934},
+	{548, -548, 1828, -1828, 3290, -3290, 5117, -5117},
+	{696, -696, 2320, -2320, 4176, -4176, 6496, -6496},
+	{868, -868, 2893, -2893, 5207, -5207, 8099, -8099},
+	{1064, -1064, 3548, -3548, 6386, -6386, 9933, -9933},
+	{1286, -1286, 4288, -4288, 7718, -7718, 12005, -12005},
+	{1536, -1536, 5120, -5120, 9216, -9216, 14336, -14336},
+};
+
+static uint64_t read64(const uint8_t *p) {
+	uint64_t v = 0;
+	for (int i = 0; i < 8; ++i)
+		v = (v << 8) | p[i];
+	return v;
+}
+
+static void write64(uint8_t *p, uint64_t v) {
+	for (int i = 7; i >= 0; --i, v >>= 8)
+		p[i] = v & 0xff;
+}
+
+static int clampS16(int v) {
+	return v < -32768 ? -32768 : v > 32767 ? 32767 : v;
+}
+
+static int predict(const LMS &lms) {
+	int64_t prediction = 0;
+	for (int i = 0; i < 4; ++i)
+		prediction += (int64_t)lms.weights[i] * lms.history[i];
+	return prediction >> 13;
+}
+
+static void update(LMS &lms, int sample, int residual) {
+	int delta = residual >> 4;
+	for (int i = 0; i < 4; ++i)
+		lms.weights[i] += lms.history[i] < 0 ? -delta : delta;
+
+	lms.history[0] = lms.history[1];
+	lms.history[1] = lms.history[2];
+	lms.history[2] = lms.history[3];
+	lms.history[3] = sample;
+}
+
+// v / scaleFactors[sf], rounded away from zero
+static int divide(int v, int sf) {
+	int n = ((int64_t)v * reciprocals[sf] + (1 << 15)) >> 16;
+	return n + ((v > 0) - (v < 0)) - ((n > 0) - (n < 0));
+}
+
+size_t frameSize(int numChannels, int frames) {
+	return frameHeaderSize + numChannels * (16 + (frames + sliceLen - 1) / sliceLen * 8);
+}
+
+bool readFileHeader(const uint8_t *p, uint32_t &frames) {
+	if (memcmp(p, "qoaf", 4) != 0)
+		return false;
+	frames = (p[4] << 24) | (p[5] << 16) | (p[6] << 8) | p[7];
+	return true;
+}
+
+void writeFileHeader(uint8_t *p, uint32_t frames) {
+	write64(p, ((uint64_t)0x716f6166 << 32) | frames); // "qoaf"
+}
+
+bool readFrameHeader(const uint8_t *p, FrameHeader &header) {
+	auto v = read64(p);
+	header.numChannels = v >> 56;
+	header.sampleRate = (v >> 32) & 0xffffff;
+	header.frames = (v >> 16) & 0xffff;
+	header.size = v & 0xffff;
+	return header.numChannels > 0 && header.numChannels <= maxChannels && header.sampleRate > 0 &&
+		header.frames > 0 && header.frames <= frameLen && header.size == frameSize(header.numChannels, header.frames);
+}
+
+int decodeFrame(const uint8_t *p, size_t size, int16_t *samples) {
+	FrameHeader header;
+	if (size < frameHeaderSize || !readFrameHeader(p, header) || size < header.size)
+		return 0;
+
+	auto channels = header.numChannels;
+	LMS lms[maxChannels];
+	p += frameHeaderSize;
+	for (int c = 0; c < channels; ++c, p += 16) {
+		auto history = read64(p), weights = read64(p + 8);
+		for (int i = 0; i < 4; ++i) {
+			lms[c].history[i] = (int16_t)(history >> 48);
+			lms[c].weights[i] = (int16_t)(weights >> 48);
+			history <<= 16;
+			weights <<= 16;
+		}
+	}
+
+	// slices of the channels are interleaved
+	for (int start = 0; start < header.frames; start += sliceLen) {
+		auto end = std::min(start + sliceLen, header.frames);
+		for (int c = 0; c < channels; ++c, p += 8) {
+			auto slice = read64(p);
+			auto &table = dequantized[slice >> 60];
+			for (int i = start; i < end; ++i) {
+				auto residual = table[(slice >> 57) & 7];
+				auto sample = clampS16(predict(lms[c]) + residual);
+				samples[i * channels + c] = sample;
+				update(lms[c], sample, residual);
+				slice <<= 3;
+			}
+		}
+	}
+	return header.frames;
+}
+
+size_t encodeFrame(const int16_t *samples, int numChannels, int sampleRate, int frames, LMS *lms, uint8_t *p) {
+	auto size = frameSize(numChannels, frames);
+	write64(p, ((uint64_t)numChannels << 56) | ((uint64_t)sampleRate << 32) | ((uint64_t)frames << 16) | size);
+	p += frameHeaderSize;
+
+	// stored as 16 bits, the encoder goes on from what the decoder reads
+	for (int c = 0; c < numChannels; ++c, p += 16) {
+		uint64_t history = 0, weights = 0;
+		for (int i = 0; i < 4; ++i) {
+			lms[c].weights[i] = (int16_t)lms[c].weights[i];
+			history = (history << 16) | (lms[c].history[i] & 0xffff);
+			weights = (weights << 16) | (lms[c].weights[i] & 0xffff);
+		}
+		write64(p, history);
+		write64(p + 8, weights);
+	}
+
+	int previous[maxChannels] = {0}; // scale factors, where the search starts
+	for (int start = 0; start < frames; start += sliceLen) {
+		auto end = std::min(start + sliceLen, frames);
+		for (int c = 0; c < numChannels; ++c, p += 8) {
+			// the scale factor with the least squared error, penalizing filters about to blow up
+			uint64_t bestError = UINT64_MAX, bestSlice = 0;
+			int bestScaleFactor = 0;
+			LMS bestLMS;
+			for (int i = 0; i < 16; ++i) {
+				auto sf = (i + previous[c]) % 16;
+				auto current = lms[c];
+				uint64_t slice = sf, error = 0;
+				for (int j = start; j < end && error < bestError; ++j) {
+					int sample = samples[j * numChannels + c];
+					auto prediction = predict(current);
+					auto scaled = std::max(-8, std::min(8, divide(sample - prediction, sf)));
+					auto code = quantized[scaled + 8];
+					auto residual = dequantized[sf][code];
+					auto reconstructed = clampS16(prediction + residual);
+
+					int64_t penalty = (((int64_t)current.weights[0] * current.weights[0] +
+						(int64_t)current.weights[1] * current.weights[1] +
+						(int64_t)current.weights[2] * current.weights[2] +
+						(int64_t)current.weights[3] * current.weights[3]) >> 18) - 0x8ff;
+					penalty = std::max<int64_t>(penalty, 0);
+					int64_t diff = sample - reconstructed;
+					error += diff * diff + penalty * penalty;
+
+					update(current, reconstructed, residual);
+					slice = (slice << 3) | code;
+				}
+				if (error < bestError) {
+					bestError = error;
+					bestSlice = slice;
+					bestScaleFactor = sf;
+					bestLMS = current;
+				}
+			}
+
+			previous[c] = bestScaleFactor;
+			lms[c] = bestLMS;
+			// a short last slice is left aligned, its unused residuals are zero
+			write64(p, bestSlice << ((sliceLen - (end - start)) * 3));
+		}
+	}
+	return size;
+}
+
+}
+} /* namespace jukebox */
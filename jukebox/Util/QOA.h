@@ -0,0 +1,71 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef JUKEBOX_UTIL_QOA_H_
+#define JUKEBOX_UTIL_QOA_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace jukebox {
+namespace qoa {
+
+/* The Quite OK Audio format (qoaformat.org): 16 bit PCM at 3.2 bits per
+ * sample, predicted by a sign-sign LMS filter per channel. A file is the
+ * "qoaf" magic and its length (frames per channel, big endian) followed
+ * by frames of up to frameLen frames each. A frame holds its own LMS
+ * state, so it decodes on its own, and every frame but the last one of a
+ * file has the same size: frame n starts at
+ * fileHeaderSize + n * frameSize(channels, frameLen).
+ */
+const size_t fileHeaderSize = 8;
+const size_t frameHeaderSize = 8;
+const int sliceLen = 20; // frames per slice, 20 3 bit residuals of one channel
+const int slicesPerFrame = 256;
+const int frameLen = sliceLen * slicesPerFrame;
+const int maxChannels = 8;
+
+struct LMS {
+	int history[4] = {0, 0, 0, 0};
+	int weights[4] = {0, 0, -(1 << 13), 1 << 14}; // as the encoder starts
+};
+
+struct FrameHeader {
+	int numChannels, sampleRate, frames;
+	size_t size; // in bytes, this header included
+};
+
+size_t frameSize(int numChannels, int frames);
+bool readFileHeader(const uint8_t *p, uint32_t &frames); // false if it isn't "qoaf"
+void writeFileHeader(uint8_t *p, uint32_t frames);
+bool readFrameHeader(const uint8_t *p, FrameHeader &header);
+
+/* Decodes a frame of size bytes to interleaved samples, returning the
+ * number of frames (0 if it is invalid or truncated).
+ */
+int decodeFrame(const uint8_t *p, size_t size, int16_t *samples);
+
+/* Encodes up to frameLen interleaved frames, lms[] (numChannels of them)
+ * carries the filter state across the frames of a file. Returns the size
+ * written, frameSize(numChannels, frames).
+ */
+size_t encodeFrame(const int16_t *samples, int numChannels, int sampleRate, int frames, LMS *lms, uint8_t *p);
+
+}
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_UTIL_QOA_H_ */
@@ -0,0 +1,496 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "SampleConversion.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JUKEBOX_CONVERSION_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace jukebox {
+
+namespace {
+
+constexpr float scaleU8 = 128.0f;
+constexpr float scaleS16 = 32768.0f;
+constexpr float scaleS24 = 8388608.0f;
+constexpr float scaleS32 = 2147483648.0f;
+constexpr float maxS32 = 2147483520.0f; // largest float below 2^31
+
+/* Scalar conversions. The vector kernels compute exactly the same thing
+ * and use these for the samples that don't fill a whole register.
+ */
+
+int32_t getS24(const uint8_t *p) {
+	return static_cast<int32_t>(
+		static_cast<uint32_t>(p[0]) << 8 |
+		static_cast<uint32_t>(p[1]) << 16 |
+		static_cast<uint32_t>(p[2]) << 24) >> 8;
+}
+
+void putS24(uint8_t *p, int32_t v) {
+	p[0] = v & 0xff;
+	p[1] = (v >> 8) & 0xff;
+	p[2] = (v >> 16) & 0xff;
+}
+
+float clip(float v) {
+	return std::min(std::max(v, -1.0f), 1.0f);
+}
+
+long toInt(float v, float scale, long maxValue) {
+	return std::min(std::lrint(clip(v) * scale), maxValue);
+}
+
+void u8ToS32(const uint8_t *in, int32_t *out, size_t begin, size_t end) {
+	for (auto i = begin; i < end; ++i)
+		out[i] = static_cast<int32_t>(static_cast<uint32_t>(in[i] ^ 0x80) << 24);
+}
+
+void s16ToS32(const int16_t *in, int32_t *out, size_t begin, size_t end) {
+	for (auto i = begin; i < end; ++i)
+		out[i] = static_cast<int32_t>(static_cast<uint32_t>(in[i]) << 16);
+}
+
+void s24ToS32(const uint8_t *in, int32_t *out, size_t begin, size_t end) {
+	for (auto i = begin; i < end; ++i)
+		out[i] = static_cast<int32_t>(static_cast<uint32_t>(getS24(in + i*3)) << 8);
+}
+
+void s24_4ToS32(const int32_t *in, int32_t *out, size_t begin, size_t end) {
+	for (auto i = begin; i < end; ++i)
+		out[i] = static_cast<int32_t>(static_cast<uint32_t>(in[i]) << 8);
+}
+
+void s32ToU8(const int32_t *in, uint8_t *out, size_t begin, size_t end) {
+	for (auto i = begin; i < end; ++i)
+		out[i] = static_cast<uint8_t>((in[i] >> 24) + 128);
+}
+
+void s32ToS16(const int32_t *in, int16_t *out, size_t begin, size_t end) {
+	for (auto i = begin; i < end; ++i)
+		out[i] = static_cast<int16_t>(in[i] >> 16);
+}
+
+void s32ToS24(const int32_t *in, uint8_t *out, size_t begin, size_t end) {
+	for (auto i = begin; i < end; ++i)
+		putS24(out + i*3, in[i] >> 8);
+}
+
+void s32ToS24_4(const int32_t *in, int32_t *out, size_t begin, size_t end) {
+	for (auto i = begin; i < end; ++i)
+		out[i] = in[i] >> 8;
+}
+
+void u8ToF32(const uint8_t *in, float *out, size_t begin, size_t end) {
+	for (auto i = begin; i < end; ++i)
+		out[i] = static_cast<float>(in[i] - 128) * (1.0f / scaleU8);
+}
+
+void s16ToF32(const int16_t *in, float *out, size_t begin, size_t end) {
+	for (auto i = begin; i < end; ++i)
+		out[i] = static_cast<float>(in[i]) * (1.0f / scaleS16);
+}
+
+void s24ToF32(const uint8_t *in, float *out, size_t begin, size_t end) {
+	for (auto i = begin; i < end; ++i)
+		out[i] = static_cast<float>(getS24(in + i*3)) * (1.0f / scaleS24);
+}
+
+void s32ToF32(const int32_t *in, float *out, size_t begin, size_t end) {
+	for (auto i = begin; i < end; ++i)
+		out[i] = static_cast<float>(in[i]) * (1.0f / scaleS32);
+}
+
+void s24_4ToF32(const int32_t *in, float *out, size_t begin, size_t end) {
+	for (auto i = begin; i < end; ++i)
+		out[i] = static_cast<float>(static_cast<int32_t>(static_cast<uint32_t>(in[i]) << 8) >> 8) * (1.0f / scaleS24);
+}
+
+void f32ToU8(const float *in, uint8_t *out, size_t begin, size_t end) {
+	for (auto i = begin; i < end; ++i)
+		out[i] = static_cast<uint8_t>(toInt(in[i], scaleU8, 127) + 128);
+}
+
+void f32ToS16(const float *in, int16_t *out, size_t begin, size_t end) {
+	for (auto i = begin; i < end; ++i)
+		out[i] = static_cast<int16_t>(toInt(in[i], scaleS16, 32767));
+}
+
+void f32ToS24(const float *in, uint8_t *out, size_t begin, size_t end) {
+	for (auto i = begin; i < end; ++i)
+		putS24(out + i*3, static_cast<int32_t>(toInt(in[i], scaleS24, 8388607)));
+}
+
+void f32ToS24_4(const float *in, int32_t *out, size_t begin, size_t end) {
+	for (auto i = begin; i < end; ++i)
+		out[i] = static_cast<int32_t>(toInt(in[i], scaleS24, 8388607));
+}
+
+void f32ToS32(const float *in, int32_t *out, size_t begin, size_t end) {
+	for (auto i = begin; i < end; ++i)
+		out[i] = static_cast<int32_t>(std::lrint(std::min(clip(in[i]) * scaleS32, maxS32)));
+}
+
+/* Vector kernels, they return how many samples were converted */
+
+#ifdef JUKEBOX_CONVERSION_SSE2
+
+__m128i loadi(const void *p) {
+	return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+}
+
+void storei(void *p, __m128i v) {
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+}
+
+// 16 u8 samples to 4 vectors of int32 in [-128, 127]
+void unpackU8(__m128i x, __m128i v[4]) {
+	auto s = _mm_xor_si128(x, _mm_set1_epi8(-128));
+	auto lo = _mm_srai_epi16(_mm_unpacklo_epi8(s, s), 8);
+	auto hi = _mm_srai_epi16(_mm_unpackhi_epi8(s, s), 8);
+	v[0] = _mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 16);
+	v[1] = _mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 16);
+	v[2] = _mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 16);
+	v[3] = _mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 16);
+}
+
+// 4 vectors of int32 in [-128, 127] (saturated otherwise) to 16 u8 samples
+__m128i packU8(const __m128i v[4]) {
+	auto s = _mm_packs_epi16(_mm_packs_epi32(v[0], v[1]), _mm_packs_epi32(v[2], v[3]));
+	return _mm_xor_si128(s, _mm_set1_epi8(-128));
+}
+
+__m128i floatToInt(__m128 x, __m128 scale) {
+	x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+	return _mm_cvtps_epi32(_mm_mul_ps(x, scale));
+}
+
+size_t u8ToS32(const uint8_t *in, int32_t *out, size_t count) {
+	size_t n = count & ~static_cast<size_t>(15);
+	__m128i v[4];
+	for (size_t i = 0; i < n; i += 16) {
+		unpackU8(loadi(in + i), v);
+		for (int j = 0; j < 4; ++j)
+			storei(out + i + j*4, _mm_slli_epi32(v[j], 24));
+	}
+	return n;
+}
+
+size_t s16ToS32(const int16_t *in, int32_t *out, size_t count) {
+	size_t n = count & ~static_cast<size_t>(7);
+	auto zero = _mm_setzero_si128();
+	for (size_t i = 0; i < n; i += 8) {
+		auto x = loadi(in + i);
+		storei(out + i, _mm_unpacklo_epi16(zero, x));
+		storei(out + i + 4, _mm_unpackhi_epi16(zero, x));
+	}
+	return n;
+}
+
+size_t s24_4ToS32(const int32_t *in, int32_t *out, size_t count) {
+	size_t n = count & ~static_cast<size_t>(3);
+	for (size_t i = 0; i < n; i += 4)
+		storei(out + i, _mm_slli_epi32(loadi(in + i), 8));
+	return n;
+}
+
+size_t s32ToU8(const int32_t *in, uint8_t *out, size_t count) {
+	size_t n = count & ~static_cast<size_t>(15);
+	__m128i v[4];
+	for (size_t i = 0; i < n; i += 16) {
+		for (int j = 0; j < 4; ++j)
+			v[j] = _mm_srai_epi32(loadi(in + i + j*4), 24);
+		storei(out + i, packU8(v));
+	}
+	return n;
+}
+
+size_t s32ToS16(const int32_t *in, int16_t *out, size_t count) {
+	size_t n = count & ~static_cast<size_t>(7);
+	for (size_t i = 0; i < n; i += 8) {
+		auto lo = _mm_srai_epi32(loadi(in + i), 16);
+		auto hi = _mm_srai_epi32(loadi(in + i + 4), 16);
+		storei(out + i, _mm_packs_epi32(lo, hi));
+	}
+	return n;
+}
+
+size_t s32ToS24_4(const int32_t *in, int32_t *out, size_t count) {
+	size_t n = count & ~static_cast<size_t>(3);
+	for (size_t i = 0; i < n; i += 4)
+		storei(out + i, _mm_srai_epi32(loadi(in + i), 8));
+	return n;
+}
+
+size_t u8ToF32(const uint8_t *in, float *out, size_t count) {
+	size_t n = count & ~static_cast<size_t>(15);
+	auto scale = _mm_set1_ps(1.0f / scaleU8);
+	__m128i v[4];
+	for (size_t i = 0; i < n; i += 16) {
+		unpackU8(loadi(in + i), v);
+		for (int j = 0; j < 4; ++j)
+			_mm_storeu_ps(out + i + j*4, _mm_mul_ps(_mm_cvtepi32_ps(v[j]), scale));
+	}
+	return n;
+}
+
+size_t s16ToF32(const int16_t *in, float *out, size_t count) {
+	size_t n = count & ~static_cast<size_t>(7);
+	auto scale = _mm_set1_ps(1.0f / scaleS16);
+	for (size_t i = 0; i < n; i += 8) {
+		auto x = loadi(in + i);
+		auto lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+		auto hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16));
+		_mm_storeu_ps(out + i, _mm_mul_ps(lo, scale));
+		_mm_storeu_ps(out + i + 4, _mm_mul_ps(hi, scale));
+	}
+	return n;
+}
+
+size_t s32ToF32(const int32_t *in, float *out, size_t count) {
+	size_t n = count & ~static_cast<size_t>(3);
+	auto scale = _mm_set1_ps(1.0f / scaleS32);
+	for (size_t i = 0; i < n; i += 4)
+		_mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(loadi(in + i)), scale));
+	return n;
+}
+
+size_t s24_4ToF32(const int32_t *in, float *out, size_t count) {
+	size_t n = count & ~static_cast<size_t>(3);
+	auto scale = _mm_set1_ps(1.0f / scaleS24);
+	for (size_t i = 0; i < n; i += 4) {
+		auto x = _mm_srai_epi32(_mm_slli_epi32(loadi(in + i), 8), 8);
+		_mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(x), scale));
+	}
+	return n;
+}
+
+size_t f32ToU8(const float *in, uint8_t *out, size_t count) {
+	size_t n = count & ~static_cast<size_t>(15);
+	auto scale = _mm_set1_ps(scaleU8);
+	__m128i v[4];
+	for (size_t i = 0; i < n; i += 16) {
+		for (int j = 0; j < 4; ++j)
+			v[j] = floatToInt(_mm_loadu_ps(in + i + j*4), scale);
+		storei(out + i, packU8(v));
+	}
+	return n;
+}
+
+size_t f32ToS16(const float *in, int16_t *out, size_t count) {
+	size_t n = count & ~static_cast<size_t>(7);
+	auto scale = _mm_set1_ps(scaleS16);
+	for (size_t i = 0; i < n; i += 8) {
+		auto lo = floatToInt(_mm_loadu_ps(in + i), scale);
+		auto hi = floatToInt(_mm_loadu_ps(in + i + 4), scale);
+		storei(out + i, _mm_packs_epi32(lo, hi));
+	}
+	return n;
+}
+
+size_t f32ToS24_4(const float *in, int32_t *out, size_t count) {
+	size_t n = count & ~static_cast<size_t>(3);
+	auto scale = _mm_set1_ps(scaleS24);
+	auto maxValue = _mm_set1_epi32(8388607);
+	for (size_t i = 0; i < n; i += 4) {
+		auto v = floatToInt(_mm_loadu_ps(in + i), scale);
+		// only +1.0 overshoots, to 2^23
+		storei(out + i, _mm_sub_epi32(v, _mm_and_si128(_mm_cmpgt_epi32(v, maxValue), _mm_set1_epi32(1))));
+	}
+	return n;
+}
+
+size_t f32ToS32(const float *in, int32_t *out, size_t count) {
+	size_t n = count & ~static_cast<size_t>(3);
+	auto scale = _mm_set1_ps(scaleS32);
+	auto maxValue = _mm_set1_ps(maxS32);
+	for (size_t i = 0; i < n; i += 4) {
+		auto x = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i), _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+		storei(out + i, _mm_cvtps_epi32(_mm_min_ps(_mm_mul_ps(x, scale), maxValue)));
+	}
+	return n;
+}
+
+#else
+
+size_t u8ToS32(const uint8_t *, int32_t *, size_t) { return 0; }
+size_t s16ToS32(const int16_t *, int32_t *, size_t) { return 0; }
+size_t s24_4ToS32(const int32_t *, int32_t *, size_t) { return 0; }
+size_t s32ToU8(const int32_t *, uint8_t *, size_t) { return 0; }
+size_t s32ToS16(const int32_t *, int16_t *, size_t) { return 0; }
+size_t s32ToS24_4(const int32_t *, int32_t *, size_t) { return 0; }
+size_t u8ToF32(const uint8_t *, float *, size_t) { return 0; }
+size_t s16ToF32(const int16_t *, float *, size_t) { return 0; }
+size_t s32ToF32(const int32_t *, float *, size_t) { return 0; }
+size_t s24_4ToF32(const int32_t *, float *, size_t) { return 0; }
+size_t f32ToU8(const float *, uint8_t *, size_t) { return 0; }
+size_t f32ToS16(const float *, int16_t *, size_t) { return 0; }
+size_t f32ToS24_4(const float *, int32_t *, size_t) { return 0; }
+size_t f32ToS32(const float *, int32_t *, size_t) { return 0; }
+
+#endif
+
+// 24 bit samples have no vector kernel
+size_t s24ToS32(const uint8_t *, int32_t *, size_t) { return 0; }
+size_t s32ToS24(const int32_t *, uint8_t *, size_t) { return 0; }
+size_t s24ToF32(const uint8_t *, float *, size_t) { return 0; }
+size_t f32ToS24(const float *, uint8_t *, size_t) { return 0; }
+
+template<typename T, typename U>
+void run(
+	size_t (*vector)(const T *, U *, size_t),
+	void (*scalar)(const T *, U *, size_t, size_t),
+	const void *in,
+	void *out,
+	size_t count) {
+
+	auto inp = reinterpret_cast<const T *>(in);
+	auto outp = reinterpret_cast<U *>(out);
+	scalar(inp, outp, vector(inp, outp, count), count);
+}
+
+// integer formats to s32 and back, float to/from anything
+void toS32(const void *in, SampleFormat format, int32_t *out, size_t count) {
+	switch (format) {
+	case SampleFormat::U8:
+		return run<uint8_t, int32_t>(u8ToS32, u8ToS32, in, out, count);
+	case SampleFormat::S16:
+		return run<int16_t, int32_t>(s16ToS32, s16ToS32, in, out, count);
+	case SampleFormat::S24:
+		return run<uint8_t, int32_t>(s24ToS32, s24ToS32, in, out, count);
+	case SampleFormat::S32:
+		std::memmove(out, in, count*sizeof(int32_t));
+		return;
+	case SampleFormat::F32:
+		return run<float, int32_t>(f32ToS32, f32ToS32, in, out, count);
+	case SampleFormat::S24_4:
+		return run<int32_t, int32_t>(s24_4ToS32, s24_4ToS32, in, out, count);
+	}
+}
+
+void fromS32(const int32_t *in, void *out, SampleFormat format, size_t count) {
+	switch (format) {
+	case SampleFormat::U8:
+		return run<int32_t, uint8_t>(s32ToU8, s32ToU8, in, out, count);
+	case SampleFormat::S16:
+		return run<int32_t, int16_t>(s32ToS16, s32ToS16, in, out, count);
+	case SampleFormat::S24:
+		return run<int32_t, uint8_t>(s32ToS24, s32ToS24, in, out, count);
+	case SampleFormat::S32:
+		std::memmove(out, in, count*sizeof(int32_t));
+		return;
+	case SampleFormat::F32:
+		return run<int32_t, float>(s32ToF32, s32ToF32, in, out, count);
+	case SampleFormat::S24_4:
+		return run<int32_t, int32_t>(s32ToS24_4, s32ToS24_4, in, out, count);
+	}
+}
+
+void toF32(const void *in, SampleFormat format, float *out, size_t count) {
+	switch (format) {
+	case SampleFormat::U8:
+		return run<uint8_t, float>(u8ToF32, u8ToF32, in, out, count);
+	case SampleFormat::S16:
+		return run<int16_t, float>(s16ToF32, s16ToF32, in, out, count);
+	case SampleFormat::S24:
+		return run<uint8_t, float>(s24ToF32, s24ToF32, in, out, count);
+	case SampleFormat::S32:
+		return run<int32_t, float>(s32ToF32, s32ToF32, in, out, count);
+	case SampleFormat::F32:
+		std::memmove(out, in, count*sizeof(float));
+		return;
+	case SampleFormat::S24_4:
+		return run<int32_t, float>(s24_4ToF32, s24_4ToF32, in, out, count);
+	}
+}
+
+void fromF32(const float *in, void *out, SampleFormat format, size_t count) {
+	switch (format) {
+	case SampleFormat::U8:
+		return run<float, uint8_t>(f32ToU8, f32ToU8, in, out, count);
+	case SampleFormat::S16:
+		return run<float, int16_t>(f32ToS16, f32ToS16, in, out, count);
+	case SampleFormat::S24:
+		return run<float, uint8_t>(f32ToS24, f32ToS24, in, out, count);
+	case SampleFormat::S32:
+		return run<float, int32_t>(f32ToS32, f32ToS32, in, out, count);
+	case SampleFormat::F32:
+		std::memmove(out, in, count*sizeof(float));
+		return;
+	case SampleFormat::S24_4:
+		return run<float, int32_t>(f32ToS24_4, f32ToS24_4, in, out, count);
+	}
+}
+
+}
+
+SampleFormat sampleFormat(short bitsPerSample) {
+	switch (bitsPerSample) {
+	case 8:
+		return SampleFormat::U8;
+	case 16:
+		return SampleFormat::S16;
+	case 24:
+		return SampleFormat::S24;
+	case 32:
+		return SampleFormat::S32;
+	default:
+		throw std::runtime_error("unsupported sample resolution: " + std::to_string(bitsPerSample));
+	}
+}
+
+int sampleSize(SampleFormat format) {
+	static const int size[] = {1, 2, 3, 4, 4, 4};
+	return size[static_cast<int>(format)];
+}
+
+void convertSamples(const void *in, SampleFormat inFormat, void *out, SampleFormat outFormat, size_t count) {
+	if (inFormat == SampleFormat::F32)
+		fromF32(reinterpret_cast<const float *>(in), out, outFormat, count);
+	else if (outFormat == SampleFormat::F32)
+		toF32(in, inFormat, reinterpret_cast<float *>(out), count);
+	else if (inFormat == SampleFormat::S32)
+		fromS32(reinterpret_cast<const int32_t *>(in), out, outFormat, count);
+	else if (outFormat == SampleFormat::S32)
+		toS32(in, inFormat, reinterpret_cast<int32_t *>(out), count);
+	else if (inFormat == outFormat)
+		std::memmove(out, in, count*sampleSize(inFormat));
+	else {
+		// integer to integer, through a small s32 buffer
+		const size_t chunk = 1024;
+		int32_t tmp[chunk];
+		auto inp = reinterpret_cast<const char *>(in);
+		auto outp = reinterpret_cast<char *>(out);
+		auto inSize = sampleSize(inFormat), outSize = sampleSize(outFormat);
+
+		for (size_t i = 0; i < count; i += chunk) {
+			auto n = std::min(chunk, count - i);
+			toS32(inp + i*inSize, inFormat, tmp, n);
+			fromS32(tmp, outp + i*outSize, outFormat, n);
+		}
+	}
+}
+
+} /* namespace jukebox */
@@ -0,0 +1,49 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef JUKEBOX_UTIL_SAMPLECONVERSION_H_
+#define JUKEBOX_UTIL_SAMPLECONVERSION_H_
+
+#include <cstddef>
+
+namespace jukebox {
+
+enum class SampleFormat : int {
+	U8 = 0,  // unsigned 8 bit, silence at 128
+	S16 = 1, // signed 16 bit
+	S24 = 2, // signed 24 bit, packed in 3 bytes (little endian)
+	S32 = 3, // signed 32 bit
+	F32 = 4, // 32 bit float, [-1.0, 1.0]
+	S24_4 = 5 // signed 24 bit in the low bytes of 32 bit words (ALSA's S24_LE)
+};
+
+// integer format for a bit depth (8, 16, 24 or 32), throws otherwise
+SampleFormat sampleFormat(short bitsPerSample);
+int sampleSize(SampleFormat format);
+
+/* Converts count samples between any two formats. Integer formats are
+ * widened and narrowed by shifting (so the conversion round-trips),
+ * float is scaled by the integer full scale and clipped to it on the
+ * way back. out may alias in when the output sample isn't larger
+ * than the input one.
+ *
+ * All kernels but the packed 24 bit ones are vectorized with SSE2.
+ */
+void convertSamples(const void *in, SampleFormat inFormat, void *out, SampleFormat outFormat, size_t count);
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_UTIL_SAMPLECONVERSION_H_ */
@@ -0,0 +1,66 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef JUKEBOX_UTIL_SAMPLETYPES_H_
+#define JUKEBOX_UTIL_SAMPLETYPES_H_
+
+#include <cstdint>
+#include <limits>
+
+namespace jukebox {
+
+/* Packed 24 bit sample (S24_3LE), so the templated sample loops
+ * can walk 24 bit buffers like any other sample type.
+ */
+#pragma pack(push, 1)
+class Int24 {
+public:
+	Int24() = default;
+	Int24(int32_t v) :
+		b{static_cast<uint8_t>(v), static_cast<uint8_t>(v >> 8), static_cast<uint8_t>(v >> 16)} {};
+
+	operator int32_t() const {
+		return static_cast<int32_t>(
+			static_cast<uint32_t>(b[0]) << 8 |
+			static_cast<uint32_t>(b[1]) << 16 |
+			static_cast<uint32_t>(b[2]) << 24) >> 8;
+	}
+private:
+	uint8_t b[3];
+};
+#pragma pack(pop)
+
+static_assert(sizeof(Int24) == 3, "Int24 must be packed");
+
+// full scale of each sample type
+template<typename T>
+struct SampleTraits {
+	static constexpr float max() { return static_cast<float>(std::numeric_limits<T>::max()); }
+};
+
+template<>
+struct SampleTraits<Int24> {
+	static constexpr float max() { return 8388607.0f; }
+};
+
+template<>
+struct SampleTraits<float> {
+	static constexpr float max() { return 1.0f; }
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_UTIL_SAMPLETYPES_H_ */
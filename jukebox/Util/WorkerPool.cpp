@@ -0,0 +1,78 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include "WorkerPool.h"
+
+namespace jukebox {
+
+WorkerPool::WorkerPool(size_t numThreads) {
+	numThreads = std::max<size_t>(numThreads, 1);
+	for (size_t i = 0; i < numThreads; ++i)
+		workers.emplace_back([this](){ run(); });
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lock(jobsMutex);
+		stopping = true;
+	}
+	jobsCond.notify_all();
+	for (auto &worker: workers)
+		worker.join();
+}
+
+size_t WorkerPool::size() const {
+	return workers.size();
+}
+
+static thread_local bool workerThread = false;
+
+bool WorkerPool::onWorker() {
+	return workerThread;
+}
+
+WorkerPool &WorkerPool::getInstance() {
+	static WorkerPool instance(std::thread::hardware_concurrency());
+	return instance;
+}
+
+void WorkerPool::enqueue(std::function<void()> job) {
+	{
+		std::lock_guard<std::mutex> lock(jobsMutex);
+		jobs.emplace_back(std::move(job));
+	}
+	jobsCond.notify_one();
+}
+
+// pending jobs are still executed on shutdown, so no future is left without a value
+void WorkerPool::run() {
+	workerThread = true;
+	while (true) {
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(jobsMutex);
+			jobsCond.wait(lock, [this](){ return stopping || !jobs.empty(); });
+			if (jobs.empty())
+				return;
+			job = std::move(jobs.front());
+			jobs.pop_front();
+		}
+		job();
+	}
+}
+
+} /* namespace jukebox */
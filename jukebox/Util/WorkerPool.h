@@ -0,0 +1,69 @@
+/*
+    Copyright 2026 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef JUKEBOX_UTIL_WORKERPOOL_H_
+#define JUKEBOX_UTIL_WORKERPOOL_H_
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <deque>
+#include <vector>
+
+namespace jukebox {
+
+/* Fixed size thread pool for background work (pre-rendering,
+ * loading, etc). Jobs run in submission order.
+ */
+class WorkerPool {
+public:
+	WorkerPool(size_t numThreads);
+	~WorkerPool();
+
+	template<typename F>
+	auto submit(F &&job) -> std::future<decltype(job())> {
+		auto task = std::make_shared<std::packaged_task<decltype(job())()>>(std::forward<F>(job));
+		auto result = task->get_future();
+		enqueue([task](){ (*task)(); });
+		return result;
+	}
+
+	size_t size() const;
+	static WorkerPool &getInstance(); // shared pool, one thread per core
+	/* the calling thread is a worker of some pool: a job that waits for
+	 * others it submits may deadlock once every worker does the same
+	 */
+	static bool onWorker();
+private:
+	WorkerPool(const WorkerPool &) = delete;
+	WorkerPool &operator=(const WorkerPool &) = delete;
+
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()>> jobs;
+	std::mutex jobsMutex;
+	std::condition_variable jobsCond;
+	bool stopping = false;
+
+	void enqueue(std::function<void()> job);
+	void run();
+};
+
+} /* namespace jukebox */
+
+#endif /* JUKEBOX_UTIL_WORKERPOOL_H_ */
@@ -0,0 +1,68 @@
+/*
+    Copyright 2019 Roberto Panerai Velloso.
+    This file is part of libjukebox.
+    libjukebox is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    libjukebox is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include "jukebox/Sound/Factory.h"
+#include "jukebox/Sound/FileWriterSoundImpl.h"
+
+/* Loops a region of a sound twice, through SoundImpl::readBlock and its
+ * loop head cache, and checks both passes against a fresh decode of the
+ * region. Synthesized formats that aren't pre-rendered (Mod) must seek
+ * when the cache skips the first block of the loop.
+ */
+int main(int argc, char **argv) {
+	if (argc < 2) {
+		std::cout << "usage: " << argv[0] << " <audio file>" << std::endl;
+		return 1;
+	}
+
+	auto file = jukebox::factory::loadFile(argv[1]);
+	auto decoder = new jukebox::Decoder(file);
+	auto blockSize = decoder->getBlockSize();
+	auto rate = decoder->getSampleRate();
+	size_t loopStart = rate, loopEnd = 3 * rate; // frames
+	size_t loopSize = (loopEnd - loopStart) * blockSize;
+
+	jukebox::FileWriterSoundImpl sound(decoder, ""); // never played, nothing is written
+	sound.setLoopPoints(loopStart, loopEnd);
+
+	std::vector<char> output, buffer(4096 * blockSize);
+	while (output.size() < loopStart * blockSize + 2 * loopSize) {
+		auto len = sound.readBlock(buffer.data(), buffer.size(), true);
+		if (len <= 0)
+			break;
+		sound.setPosition(sound.getPosition() + len);
+		output.insert(output.end(), buffer.begin(), buffer.begin() + len);
+	}
+
+	jukebox::Decoder fresh(file);
+	std::vector<char> region(loopSize);
+	if (fresh.getSamples(region.data(), loopStart * blockSize, loopSize) != static_cast<int>(loopSize) ||
+		output.size() < loopStart * blockSize + 2 * loopSize) {
+		std::cout << "short read" << std::endl;
+		return 1;
+	}
+
+	for (int pass = 0; pass < 2; ++pass) {
+		auto first = output.begin() + loopStart * blockSize + pass * loopSize;
+		if (!std::equal(region.begin(), region.end(), first)) {
+			std::cout << "loop pass " << pass + 1 << " differs from a fresh decode" << std::endl;
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -16,10 +16,14 @@
 #ifndef _LIBJUKEBOX_H
 #define _LIBJUKEBOX_H
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <istream>
 #include <functional>
+#include <future>
 #include <map>
 #include <mutex>
 #include <vector>
@@ -49,6 +53,131 @@ private:
 }
 namespace jukebox {
 
+enum class SampleFormat : int {
+ U8 = 0,
+ S16 = 1,
+ S24 = 2,
+ S32 = 3,
+ F32 = 4,
+ S24_4 = 5
+};
+
+
+SampleFormat sampleFormat(short bitsPerSample);
+int sampleSize(SampleFormat format);
+void convertSamples(const void *in, SampleFormat inFormat, void *out, SampleFormat outFormat, size_t count);
+
+}
+namespace jukebox {
+
+
+
+
+
+
+class ByteSource {
+public:
+ virtual ~ByteSource() = default;
+ virtual size_t readAt(uint64_t offset, void *buf, size_t len) = 0;
+ virtual uint64_t size() const = 0;
+ virtual const uint8_t *data() const;
+};
+
+
+class FileByteSource : public ByteSource {
+public:
+ FileByteSource(const std::string &filename);
+ ~FileByteSource();
+ size_t readAt(uint64_t offset, void *buf, size_t len) override;
+ uint64_t size() const override;
+private:
+ FileByteSource(const FileByteSource &) = delete;
+ FileByteSource &operator=(const FileByteSource &) = delete;
+ friend class MappedByteSource;
+
+ void *handle;
+ uint64_t fileSize = 0;
+};
+
+
+class MappedByteSource : public ByteSource {
+public:
+ MappedByteSource(const std::string &filename);
+ ~MappedByteSource();
+ size_t readAt(uint64_t offset, void *buf, size_t len) override;
+ uint64_t size() const override;
+ const uint8_t *data() const override;
+private:
+ MappedByteSource(const MappedByteSource &) = delete;
+ MappedByteSource &operator=(const MappedByteSource &) = delete;
+
+ const uint8_t *memory = nullptr;
+ uint64_t fileSize = 0;
+};
+
+
+class MemoryByteSource : public ByteSource {
+public:
+ MemoryByteSource(std::unique_ptr<uint8_t[]> memory, uint64_t size);
+ MemoryByteSource(ByteSource &source);
+ size_t readAt(uint64_t offset, void *buf, size_t len) override;
+ uint64_t size() const override;
+ const uint8_t *data() const override;
+private:
+ std::unique_ptr<uint8_t[]> memory;
+ uint64_t memorySize;
+};
+
+
+
+
+class PrefixByteSource : public ByteSource {
+public:
+ PrefixByteSource(std::shared_ptr<ByteSource> source, std::vector<uint8_t> prefix);
+ size_t readAt(uint64_t offset, void *buf, size_t len) override;
+ uint64_t size() const override;
+ const uint8_t *data() const override;
+private:
+ std::shared_ptr<ByteSource> source;
+ std::vector<uint8_t> prefix;
+};
+
+
+
+
+class StreamByteSource : public ByteSource {
+public:
+ StreamByteSource(std::istream &inp);
+ size_t readAt(uint64_t offset, void *buf, size_t len) override;
+ uint64_t size() const override;
+private:
+ std::istream &inp;
+ std::mutex streamMutex;
+ std::streamoff start = 0;
+ uint64_t streamSize = 0;
+};
+
+}
+namespace jukebox {
+
+struct FileStat {
+ bool exists = false, directory = false, link = false;
+ uint64_t size = 0;
+ uint64_t id = 0;
+ int64_t modified = 0;
+ uint32_t modifiedNanos = 0;
+};
+
+FileStat statFile(const std::string &path);
+std::vector<std::string> listDirectory(const std::string &path);
+bool makeDirectory(const std::string &path);
+bool removeFile(const std::string &path);
+bool renameFile(const std::string &from, const std::string &to);
+void touchFile(const std::string &path);
+
+}
+namespace jukebox {
+
 class SoundFileImpl;
 
 class DecoderImpl {
@@ -60,6 +189,7 @@ public:
  virtual short getNumChannels() const;
  virtual int getSampleRate() const;
  virtual short getBitsPerSample() const;
+ virtual SampleFormat getSampleFormat() const;
  virtual int getDataSize() const;
  virtual int silenceLevel() const;
  SoundFileImpl &getFileImpl() const;
@@ -81,11 +211,21 @@ public:
  Decoder(Decoder &&) = default;
  Decoder &operator=(Decoder &&) = default;
  int getSamples(char *buf, int pos, int len);
+
+
+
+
+
+
+ int getSamplesParallel(char *buf, int pos, int len);
  short getNumChannels() const;
  int getSampleRate() const;
  short getBitsPerSample() const;
+ SampleFormat getSampleFormat() const;
  int getDataSize() const;
  int getBlockSize() const;
+ size_t getLoopStart() const;
+ size_t getLoopEnd() const;
  const std::string &getFilename() const;
  double getDuration() const;
  int silenceLevel() const;
@@ -94,10 +234,14 @@ public:
  template<typename T, typename ...Params>
  Decoder &wrap(Params&&... params) {
   impl.reset(new T(impl.release(), std::forward<Params>(params)...));
+  ++revision;
+  ++decorators;
         return *this;
  }
 
  Decoder &peel();
+ int getRevision() const;
+ bool decorated() const;
 private:
  Decoder(std::shared_ptr<SoundFileImpl> soundFileImpl);
  Decoder(const Decoder &) = delete;
@@ -105,6 +249,8 @@ private:
 
  std::shared_ptr<SoundFileImpl> soundFileImpl;
  std::unique_ptr<DecoderImpl> impl;
+ int revision = 0;
+ int decorators = 0;
 };
 
 }
@@ -127,6 +273,8 @@ private:
 }
 namespace jukebox {
 
+class BlockCache;
+
 extern size_t dr_libs_read_callback(void *stream, void *outBuf, size_t len);
 extern uint32_t dr_libs_seek_callback(void *stream, int offset, int origin);
 
@@ -137,13 +285,20 @@ public:
  virtual short getNumChannels() const = 0;
  virtual int getSampleRate() const = 0;
  virtual short getBitsPerSample() const = 0;
+ virtual SampleFormat getSampleFormat() const;
  virtual const std::string &getFilename() const = 0;
  virtual DecoderImpl *makeDecoder() = 0;
  virtual int silenceLevel() const;
  virtual void truncAt(int pos);
  virtual int getDataSize() const;
+ virtual size_t getLoopStart() const;
+ virtual size_t getLoopEnd() const;
+ virtual bool exactSeek() const;
+ void setBlockCacheSize(size_t blocks);
 protected:
  int dataSize = 0;
+ size_t loopStart = 0, loopEnd = 0;
+ std::shared_ptr<BlockCache> blockCache;
 };
 
 }
@@ -158,7 +313,11 @@ public:
  short getNumChannels() const;
  int getSampleRate() const;
  short getBitsPerSample() const;
+ SampleFormat getSampleFormat() const;
  int getDataSize() const;
+ size_t getLoopStart() const;
+ size_t getLoopEnd() const;
+ void setBlockCacheSize(size_t blocks);
  const std::string &getFilename() const;
  double getDuration() const;
  void truncAt(int pos);
@@ -168,6 +327,229 @@ private:
  std::shared_ptr<SoundFileImpl> impl;
 };
 
+}
+namespace jukebox {
+class Playlist {
+public:
+ struct Track {
+  SoundFile file;
+  size_t start;
+  size_t frames;
+  size_t fadeIn;
+  size_t fadeOut;
+ };
+
+ Playlist(float crossfadeSecs = 0);
+ Playlist &add(SoundFile file);
+ size_t size() const;
+ Track getTrack(size_t i) const;
+ void getTracks(size_t first, size_t count, std::vector<std::pair<size_t, Track>> &tracks) const;
+ size_t getNumFrames() const;
+ short getNumChannels() const;
+ int getSampleRate() const;
+ short getBitsPerSample() const;
+ SampleFormat getSampleFormat() const;
+private:
+ float crossfadeSecs;
+ mutable std::mutex tracksMutex;
+ std::vector<Track> tracks;
+ std::atomic<size_t> numFrames{0};
+ short numChannels = 0;
+ int sampleRate = 0;
+ short bitsPerSample = 0;
+ SampleFormat format = SampleFormat::S16;
+};
+
+}
+namespace jukebox {
+
+
+
+
+
+struct MediaInfo {
+ std::string filename;
+ std::string format;
+ uint64_t fileSize = 0;
+ int64_t modified = 0;
+ short numChannels = 0;
+ int sampleRate = 0;
+ short bitsPerSample = 0;
+ double duration = 0;
+ std::map<std::string, std::string> tags;
+};
+class MediaScanner {
+public:
+ using Progress = std::function<void(size_t files)>;
+
+ static MediaInfo probe(const std::string &filename);
+ bool load(const std::string &indexFile);
+ void save(const std::string &indexFile) const;
+
+
+
+
+ size_t scan(const std::vector<std::string> &paths, Progress progress = nullptr);
+ const std::vector<MediaInfo> &getEntries() const;
+private:
+ std::vector<MediaInfo> entries;
+};
+
+}
+namespace jukebox {
+
+enum class FilterType {
+ LowPass,
+ HighPass,
+ BandPass,
+ Notch,
+ Peak,
+ LowShelf,
+ HighShelf
+};
+
+
+struct Biquad {
+ float b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+
+
+ static Biquad design(FilterType type, float frequency, float q, float gainDb, int sampleRate);
+};
+class FilterBank {
+public:
+ struct Band {
+  FilterType type;
+  float frequency, q, gainDb;
+ };
+
+ size_t addBand(FilterType type, float frequency, float q = 0.7071f, float gainDb = 0);
+ void setBand(size_t band, FilterType type, float frequency, float q = 0.7071f, float gainDb = 0);
+ std::vector<Band> getBands() const;
+ unsigned getVersion() const;
+private:
+ mutable std::mutex mutex;
+ std::vector<Band> bands;
+ std::atomic<unsigned> version{0};
+};
+
+}
+namespace jukebox {
+class Halfband {
+public:
+ enum class Response { sharp, wide };
+
+ Halfband(Response response = Response::sharp);
+ void upsample(const float *in, float *out, size_t count);
+ void downsample(const float *in, float *out, size_t count);
+ void reset();
+
+ static constexpr size_t taps = 8;
+private:
+ const float *coefficients;
+ size_t numTaps;
+
+
+ std::vector<float> upBuffer, evenBuffer, oddBuffer;
+};
+
+}
+namespace jukebox {
+class Dynamics {
+public:
+ struct Settings {
+
+  float thresholdDb = -12;
+  float ratio = 1;
+  float attackMs = 5;
+  float releaseMs = 100;
+  float makeupDb = 0;
+
+  float ceilingDb = -1;
+  float lookaheadMs = 5;
+  float limiterReleaseMs = 50;
+ };
+
+ Dynamics(int sampleRate, int channels, const Settings &settings);
+ void process(float *samples, size_t frames);
+ void reset();
+ size_t getLatency() const;
+
+ static constexpr size_t blockSize = 32;
+private:
+ struct Block {
+  float peak, gain;
+ };
+
+ Settings settings;
+ size_t numChannels, lookaheadBlocks;
+ float attack, release, limiterRelease;
+ float makeup, ceiling;
+
+ std::vector<float> delayLine;
+ std::vector<Block> blocks;
+ size_t position = 0;
+ size_t inputBlock = 0;
+ float peak = 0, reduction = 0;
+ float limiterGain = 1;
+ float gainFrom = 1, gainTo = 1;
+
+ std::vector<Halfband> detectors;
+ std::vector<float> channel, upsampled;
+
+ void detect(const float *samples, size_t frames);
+ void endInputBlock();
+ void startOutputBlock();
+};
+
+}
+namespace jukebox {
+class AudioClock {
+public:
+ using Clock = std::chrono::steady_clock;
+
+ static uint64_t now(int sampleRate);
+ static uint64_t toFrame(Clock::time_point time, int sampleRate);
+ static Clock::time_point toTime(uint64_t frame, int sampleRate);
+private:
+ static Clock::time_point epoch();
+};
+
+}
+namespace jukebox {
+class EventScheduler {
+public:
+ using Callback = std::function<void(void)>;
+ using Clock = std::chrono::steady_clock;
+
+ EventScheduler();
+ ~EventScheduler();
+ void schedule(size_t frame, Callback callback);
+
+
+
+
+
+ void process(size_t first, size_t frames, size_t delay, int sampleRate);
+
+ struct Event {
+  size_t frame;
+  uint64_t seq;
+  Clock::time_point deadline;
+  Callback callback;
+  Event *next;
+ };
+private:
+ EventScheduler(const EventScheduler &) = delete;
+ EventScheduler &operator=(const EventScheduler &) = delete;
+
+ static constexpr size_t maxPending = 4096;
+
+ std::atomic<Event *> incoming{nullptr};
+ std::atomic<uint64_t> seq{0};
+ std::atomic<size_t> scheduled{0};
+ std::vector<Event *> pending;
+};
+
 }
 namespace jukebox {
 
@@ -190,14 +572,42 @@ public:
  virtual void clearOnStopStack();
  virtual bool onStopStackEmpty();
  virtual void addTimedEventCallback(size_t seconds, std::function<void(void)>);
+ virtual void addFrameEventCallback(size_t frame, std::function<void(void)>);
+ virtual void scheduleStart(uint64_t frame);
+ virtual void scheduleStop(uint64_t frame);
+ virtual void clearSchedule();
+ virtual void setLoopPoints(size_t start, size_t end);
  virtual Decoder &getDecoder();
- void processTimedEvents();
+ int readBlock(char *buf, int len, bool looping);
+
+
+
+
+ void processTimedEvents(size_t frames, size_t delay);
+
+
+
+
+
+
+ bool startScheduled() const;
+ size_t startPadding(size_t delay);
+ size_t framesBeforeStop(size_t frames, size_t delay);
 protected:
  int position = 0;
  std::unique_ptr<Decoder> decoder;
  std::vector<std::function<void (void)>> onStopStack;
- std::recursive_mutex timedEventsMutex;
- std::map<size_t, std::function<void (void)> > timedEvents;
+ EventScheduler timedEvents;
+ static constexpr uint64_t noFrame = UINT64_MAX;
+ std::atomic<uint64_t> startFrame{noFrame};
+ std::atomic<uint64_t> stopFrame{noFrame};
+ std::atomic<size_t> loopStart{0};
+ std::atomic<size_t> loopEnd{0};
+private:
+
+ std::vector<char> loopHead;
+ int loopHeadStart = -1, loopHeadEnd = -1, loopHeadRevision = 0;
+ bool loopHeadDone = false;
 };
 
 }
@@ -234,7 +644,14 @@ public:
 
 
 
+
+
+
  Sound &addTimedEventCallback(size_t seconds, std::function<void(void)>);
+ Sound &addTimedEventCallback(std::chrono::nanoseconds when, std::function<void(void)>);
+ Sound &addFrameEventCallback(size_t frame, std::function<void(void)>);
+ Sound &playAt(uint64_t frame);
+ Sound &stopAt(uint64_t frame);
 
  Sound &reverb(float delay, float decay, size_t numDelays);
  Sound &distortion(float gain);
@@ -243,8 +660,18 @@ public:
  Sound &fadeOnStop(int fadeOutSecs);
  Sound &setVolume(int);
  Sound &loop(bool);
+
+
+
+
+
+
+ Sound &setLoopPoints(size_t start, size_t end);
  Sound &jointStereo();
  Sound &movingAverage(float len);
+ Sound &convolution(SoundFile impulseResponse, float wet);
+ Sound &filter(std::shared_ptr<FilterBank> bank);
+ Sound &dynamics(const Dynamics::Settings &settings);
  Sound &peelDecoder();
 
  Sound prototype();
@@ -264,6 +691,49 @@ private:
  bool looping = false;
 };
 
+}
+namespace jukebox {
+class LoadBatch {
+public:
+ using Progress = std::function<void(size_t done, size_t total)>;
+
+ LoadBatch(const std::vector<std::string> &filenames, bool onMemory = false,
+  Progress progress = nullptr, size_t maxParallel = 0);
+ LoadBatch(LoadBatch &&) = default;
+ ~LoadBatch();
+ void cancel();
+ void wait();
+ bool finished() const;
+ size_t size() const;
+ size_t getDone() const;
+ SoundFile get(size_t i);
+ std::vector<SoundFile> getAll();
+private:
+ struct State;
+ std::shared_ptr<State> state;
+
+ static void loadNext(std::shared_ptr<State> state);
+ static void load(State &state, size_t i);
+ void loadSerial(size_t end);
+};
+
+}
+namespace jukebox {
+class PCMDiskCache {
+public:
+ PCMDiskCache(const std::string &directory, uint64_t maxSize = 1ull << 30);
+ SoundFile load(const std::string &filename);
+ void collectGarbage();
+ uint64_t getSize();
+private:
+ std::string directory;
+ uint64_t maxSize;
+ std::mutex cacheMutex;
+
+ std::string entryName(const std::string &filename) const;
+ bool store(SoundFile &file, const std::string &filename, const FileStat &source, const std::string &entry);
+};
+
 }
 namespace jukebox {
 namespace factory {
@@ -271,13 +741,28 @@ namespace factory {
 Sound makeSound(SoundFile &file);
 Sound makeSound(const std::string &filename, bool onMemory = false);
 Sound makeSound(std::istream &inp, const std::string &filename, bool onMemory = false);
+Sound makeSound(std::shared_ptr<Playlist> playlist);
 Sound makeSoundOutputToFile(SoundFile &file, const std::string &filename);
 Sound makeSoundOutputToFile(const std::string &inputFile, const std::string &filename, bool onMemory = false);
-SoundImpl *makeSoundImpl(Decoder *decoder);
 
+Sound makeSoundOutputToQOAFile(SoundFile &file, const std::string &filename);
+Sound makeSoundOutputToQOAFile(const std::string &inputFile, const std::string &filename, bool onMemory = false);
+SoundImpl *makeSoundImpl(Decoder *decoder);
 SoundFile loadFile(const std::string &filename, bool onMemory = false);
 SoundFile loadFromStream(std::istream &inp, const std::string &filename, bool onMemory = false);
 
+SoundFile loadFromSource(std::shared_ptr<ByteSource> source, const std::string &filename, bool onMemory = false);
+SoundFile loadPlaylist(std::shared_ptr<Playlist> playlist);
+
+
+
+
+std::future<SoundFile> loadFileAsync(const std::string &filename, bool onMemory = false);
+void loadFileAsync(const std::string &filename, std::function<void(SoundFile)> onLoad,
+ std::function<void(std::exception_ptr)> onError = nullptr, bool onMemory = false);
+LoadBatch loadBatch(const std::vector<std::string> &filenames, bool onMemory = false,
+ LoadBatch::Progress progress = nullptr, size_t maxParallel = 0);
+
 SoundFile loadWaveFile(const std::string &filename, bool onMemory = false);
 SoundFile loadWaveStream(std::istream &inp, bool onMemory = false);
 SoundFile loadVorbisFile(const std::string &filename, bool onMemory = false);
@@ -286,10 +771,12 @@ SoundFile loadMP3File(const std::string &filename, bool onMemory = false);
 SoundFile loadMP3Stream(std::istream &inp, bool onMemory = false);
 SoundFile loadFLACFile(const std::string &filename, bool onMemory = false);
 SoundFile loadFLACStream(std::istream &inp, bool onMemory = false);
-SoundFile loadMIDIFile(const std::string &filename);
-SoundFile loadMIDIStream(std::istream &inp);
-SoundFile loadModFile(const std::string &filename);
-SoundFile loadModStream(std::istream &inp);
+SoundFile loadMIDIFile(const std::string &filename, bool preRender = false);
+SoundFile loadMIDIStream(std::istream &inp, bool preRender = false);
+SoundFile loadModFile(const std::string &filename, bool preRender = false);
+SoundFile loadModStream(std::istream &inp, bool preRender = false);
+SoundFile loadQOAFile(const std::string &filename, bool onMemory = false);
+SoundFile loadQOAStream(std::istream &inp, bool onMemory = false);
 
 }
 }
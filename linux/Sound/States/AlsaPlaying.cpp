@@ -15,10 +15,13 @@
 
 #include <iostream>
 #include <algorithm>
+#include <vector>
 
 #include "AlsaPlaying.h"
 #include "AlsaPaused.h"
 #include "AlsaStopped.h"
+#include "jukebox/Util/Gain.h"
+#include "jukebox/Util/SampleConversion.h"
 
 namespace jukebox {
 
@@ -33,10 +36,12 @@ public:
 
 	~StatusGuard() {
 		if (status != PlayingStatus::PAUSED) {
-			if (alsa.isLooping() || status == PlayingStatus::RESTARTING) {
+			// a scheduled stop ends a looping sound too
+			if ((alsa.isLooping() && status == PlayingStatus::PLAYING) || status == PlayingStatus::RESTARTING) {
 				alsa.setPosition(0);
 				alsa.setState<AlsaPlaying>();
 			} else {
+				alsa.clearSchedule(); // a stop past the end doesn't carry over to the next play()
 				while (!alsa.onStopStackEmpty()) {
 					alsa.popOnStopCallback()();
 				}
@@ -51,37 +56,73 @@ private:
 	std::atomic<PlayingStatus> &status;
 };
 
-std::unordered_map<short, decltype(AlsaPlaying::applyVolume)> AlsaPlaying::applyVolumeFunc = {
-		{ 8, &AlsaPlaying::_applyVolume<uint8_t>},
-		{16, &AlsaPlaying::_applyVolume<int16_t>},
-		{32, &AlsaPlaying::_applyVolume<int32_t>}
+std::unordered_map<SampleFormat, decltype(AlsaPlaying::applyVolume)> AlsaPlaying::applyVolumeFunc = {
+		{SampleFormat::U8,    &AlsaPlaying::_applyVolume<uint8_t>},
+		{SampleFormat::S16,   &AlsaPlaying::_applyVolume<int16_t>},
+		{SampleFormat::S24,   &AlsaPlaying::_applyVolume<Int24>},
+		{SampleFormat::S24_4, &AlsaPlaying::_applyVolume<int32_t>},
+		{SampleFormat::S32,   &AlsaPlaying::_applyVolume<int32_t>},
+		{SampleFormat::F32,   &AlsaPlaying::_applyVolume<float>}
 };
 
-_snd_pcm_format ALSA_PCM_FORMAT[5] = {
-		SND_PCM_FORMAT_UNKNOWN,
-		SND_PCM_FORMAT_U8,
-		SND_PCM_FORMAT_S16_LE,
-		SND_PCM_FORMAT_UNKNOWN,
-		SND_PCM_FORMAT_S32_LE};
+std::unordered_map<SampleFormat, _snd_pcm_format> ALSA_PCM_FORMAT = {
+		{SampleFormat::U8,    SND_PCM_FORMAT_U8},
+		{SampleFormat::S16,   SND_PCM_FORMAT_S16_LE},
+		{SampleFormat::S24,   SND_PCM_FORMAT_S24_3LE},
+		{SampleFormat::S24_4, SND_PCM_FORMAT_S24_LE},
+		{SampleFormat::S32,   SND_PCM_FORMAT_S32_LE},
+		{SampleFormat::F32,   SND_PCM_FORMAT_FLOAT_LE}};
+
+/* The decoder's format is played natively when the device takes it,
+ * otherwise the output stage converts to the first of these it does.
+ */
+std::vector<SampleFormat> fallbackFormats(SampleFormat format) {
+	if (format == SampleFormat::S24)
+		return {SampleFormat::S24_4, SampleFormat::S32, SampleFormat::S16};
+	if (format == SampleFormat::S32 || format == SampleFormat::F32)
+		return {SampleFormat::S32, SampleFormat::S24_4, SampleFormat::S16};
+	return {SampleFormat::S16};
+}
+
+/* frames queued ahead of the one being heard */
+size_t queuedFrames(snd_pcm_t *handle) {
+	snd_pcm_sframes_t delay;
+	if (snd_pcm_delay(handle, &delay) != 0 || delay < 0)
+		return 0;
+	return delay;
+}
 
 AlsaPlaying::AlsaPlaying(AlsaState &state) :
 			AlsaState(state),
 			playingStatus(PlayingStatus::STOPPED) {
 
-	applyVolume = applyVolumeFunc[alsa.getDecoder().getBitsPerSample()];
+	decoderFormat = alsa.getDecoder().getSampleFormat();
+
+	auto setParams = [this](SampleFormat format) {
+		return snd_pcm_set_params(
+			alsa.getHandle(),
+			ALSA_PCM_FORMAT[format],
+			SND_PCM_ACCESS_RW_INTERLEAVED,
+			alsa.getDecoder().getNumChannels(),
+			alsa.getDecoder().getSampleRate(),
+			1,
+			100000);
+	};
 
-	auto res = snd_pcm_set_params(
-		alsa.getHandle(),
-		ALSA_PCM_FORMAT[alsa.getDecoder().getBitsPerSample() / 8],
-		SND_PCM_ACCESS_RW_INTERLEAVED,
-		alsa.getDecoder().getNumChannels(),
-		alsa.getDecoder().getSampleRate(),
-		1,
-		100000);
+	deviceFormat = decoderFormat;
+	auto res = setParams(deviceFormat);
+	for (auto format : fallbackFormats(decoderFormat)) {
+		if (res == 0)
+			break;
+		deviceFormat = format;
+		res = setParams(deviceFormat);
+	}
 
 	if (res != 0)
 		throw std::runtime_error("snd_pcm_set_params error.");
 
+	applyVolume = applyVolumeFunc[deviceFormat];
+
 	clearBuffer = snd_pcm_drain;
 	res = snd_pcm_prepare(alsa.getHandle());
 	if (res != 0)
@@ -96,23 +137,68 @@ AlsaPlaying::AlsaPlaying(AlsaState &state) :
 
 		auto &decoder = alsa.getDecoder();
 		std::unique_ptr<uint8_t[]> volBuf(new uint8_t[bufferSize*decoder.getBlockSize()]);
+		std::unique_ptr<uint8_t[]> outBuf;
+		if (deviceFormat != decoderFormat)
+			outBuf.reset(new uint8_t[bufferSize*decoder.getNumChannels()*sampleSize(deviceFormat)]);
+
+		float gain = alsa.getVolume() / 100.0f;
+
+		if (alsa.startScheduled()) {
+			// get the device running on silence, then pad up to the start frame
+			auto silenceSamples = period*decoder.getNumChannels();
+			std::unique_ptr<uint8_t[]> silence(new uint8_t[silenceSamples*sampleSize(deviceFormat)]);
+			snd_pcm_format_set_silence(ALSA_PCM_FORMAT[deviceFormat], silence.get(), silenceSamples);
+
+			if (snd_pcm_state(alsa.getHandle()) == SND_PCM_STATE_PREPARED &&
+				snd_pcm_writei(alsa.getHandle(), silence.get(), period) > 0)
+				snd_pcm_start(alsa.getHandle());
+
+			auto padding = alsa.startPadding(queuedFrames(alsa.getHandle()));
+			while (padding > 0 && playingStatus == PlayingStatus::PLAYING) {
+				auto n = snd_pcm_writei(alsa.getHandle(), silence.get(), std::min<size_t>(padding, period));
+				if (n <= 0)
+					break;
+				padding -= n;
+			}
+		}
 
-		size_t numFrames = decoder.getDataSize() / decoder.getBlockSize();
-
-		while (numFrames > 0 && playingStatus == PlayingStatus::PLAYING) {
-			auto frames = std::min(numFrames, bufferSize);
-			alsa.processTimedEvents();
-			auto bytes = decoder.getSamples(
+		while (playingStatus == PlayingStatus::PLAYING) {
+			// the data size is re-read every block (playlists grow), loops wrap in here
+			auto bytes = alsa.readBlock(
 					reinterpret_cast<char *>(volBuf.get()),
-					alsa.getPosition(),
-					frames*decoder.getBlockSize());
+					bufferSize*decoder.getBlockSize(),
+					alsa.isLooping());
+
+			if (bytes > 0) {
+				// a scheduled stop cuts the block at its frame
+				size_t keep = alsa.framesBeforeStop(bytes / decoder.getBlockSize(), queuedFrames(alsa.getHandle()));
+				if (keep * decoder.getBlockSize() < static_cast<size_t>(bytes)) {
+					bytes = keep * decoder.getBlockSize();
+					playingStatus = PlayingStatus::STOPPED;
+				}
+			}
 
 			if (bytes > 0) {
-				applyVolume(alsa, volBuf.get(), alsa.getPosition(), bytes);
+				auto out = volBuf.get();
+				auto outBytes = bytes;
+
+				if (outBuf) {
+					auto count = bytes / sampleSize(decoderFormat);
+					convertSamples(volBuf.get(), decoderFormat, outBuf.get(), deviceFormat, count);
+					out = outBuf.get();
+					outBytes = count * sampleSize(deviceFormat);
+				}
+
+				// volume is read once per block and ramped from the previous one
+				float newGain = alsa.getVolume() / 100.0f;
+				applyVolume(out, outBytes, gain, newGain);
+				gain = newGain;
 
-				auto n = snd_pcm_writei(alsa.getHandle(), volBuf.get(), bytes / decoder.getBlockSize());
+				auto n = snd_pcm_writei(alsa.getHandle(), out, bytes / decoder.getBlockSize());
 				if (n > 0) {
-					numFrames -= n;
+					// the queue now holds these n frames after 'delay' others
+					auto delay = queuedFrames(alsa.getHandle());
+					alsa.processTimedEvents(n, delay > static_cast<size_t>(n) ? delay - n : 0);
 					alsa.setPosition(alsa.getPosition() + (n * decoder.getBlockSize()));
 				} else
 					break;
@@ -147,15 +233,8 @@ bool AlsaPlaying::playing() const {
 }
 
 template<typename T>
-void AlsaPlaying::_applyVolume(AlsaHandle &self, void *buf, int position, int len) {
-
-	int offset = self.getDecoder().silenceLevel();
-	T *beginIt = reinterpret_cast<T *>(buf);
-	T *endIt = beginIt + (len/sizeof(T));
-
-	std::for_each(beginIt, endIt, [&self, offset](T &c){
-		c = static_cast<T>((static_cast<double>(self.getVolume())/100.0*static_cast<double>(c - offset)) + offset);
-	});
+void AlsaPlaying::_applyVolume(void *buf, int len, float from, float to) {
+	gain::apply(reinterpret_cast<T *>(buf), len/sizeof(T), from, to);
 }
 
 } /* namespace jukebox */
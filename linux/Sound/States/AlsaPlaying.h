@@ -23,6 +23,7 @@
 #include <atomic>
 
 #include "AlsaState.h"
+#include "jukebox/Util/SampleConversion.h"
 
 namespace jukebox {
 
@@ -45,12 +46,13 @@ public:
 private:
 	std::thread playThread;
 	std::atomic<PlayingStatus> playingStatus;
-	std::function<void(AlsaHandle &self, void *, int , int )> applyVolume;
+	SampleFormat decoderFormat, deviceFormat;
+	std::function<void(void *, int, float, float)> applyVolume;
 	std::function<decltype(snd_pcm_drain)> clearBuffer = snd_pcm_drain;
-	static std::unordered_map<short, decltype(applyVolume)> applyVolumeFunc;
+	static std::unordered_map<SampleFormat, decltype(applyVolume)> applyVolumeFunc;
 
 	template <typename T>
-	static void _applyVolume(AlsaHandle &self, void *buf, int position, int len);
+	static void _applyVolume(void *buf, int len, float from, float to);
 };
 
 } /* namespace jukebox */
@@ -13,8 +13,10 @@
     along with libjukebox.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <cmath>
 #include <windows.h>
+#include <mmreg.h>
 
 #include "DirectSoundPlaying.h"
 #include "DirectSoundPaused.h"
@@ -63,7 +65,8 @@ DirectSoundPlaying::DirectSoundPlaying(DirectSoundState &state) :
 	wfx.wBitsPerSample = dsound.getDecoder().getBitsPerSample();
 	wfx.nChannels = dsound.getDecoder().getNumChannels();
 	wfx.nSamplesPerSec = dsound.getDecoder().getSampleRate();
-	wfx.wFormatTag = WAVE_FORMAT_PCM;
+	wfx.wFormatTag = dsound.getDecoder().getSampleFormat() == SampleFormat::F32 ?
+		WAVE_FORMAT_IEEE_FLOAT : WAVE_FORMAT_PCM;
 	wfx.nBlockAlign = (wfx.wBitsPerSample/8)*wfx.nChannels;
 	wfx.nAvgBytesPerSec = wfx.nSamplesPerSec * wfx.nBlockAlign;
 
@@ -156,7 +159,8 @@ DWORD DirectSoundPlaying::status() const {
 }
 
 bool DirectSoundPlaying::fillBuffer(int offset, size_t size) {
-	if (dsound.getPosition() >= dsound.getDecoder().getDataSize()) {
+	bool looping = dsound.isLooping();
+	if (!looping && dsound.getPosition() >= dsound.getDecoder().getDataSize()) {
 		return false;
 	}
 
@@ -176,12 +180,40 @@ bool DirectSoundPlaying::fillBuffer(int offset, size_t size) {
 	if (FAILED(hr))
 		throw std::runtime_error("failed Lock");
 
-	dsound.processTimedEvents();
-	size_t len = dsound.getDecoder().getSamples((char *)bufAddr, dsound.getPosition(), bufLen);
+	// the other half of the buffer (if any) plays before this region
+	auto blockSize = dsound.getDecoder().getBlockSize();
+	size_t delay = (dsbdesc.dwBufferBytes - size) / blockSize;
+
+	if (!started && dsound.startScheduled())
+		startPadding = dsound.startPadding(delay);
+	started = true;
+	size_t pad = std::min<size_t>(startPadding * blockSize, bufLen);
+	memset(bufAddr, dsound.getDecoder().silenceLevel(), pad);
+	startPadding -= pad / blockSize;
+	delay += pad / blockSize;
+
+	// read in blocks, a loop wraps at each block end
+	size_t len = 0;
+	while (!stopReached && pad + len < bufLen) {
+		int bytes = dsound.readBlock((char *)bufAddr + pad + len, bufLen - pad - len, looping);
+		if (bytes <= 0)
+			break;
+
+		// a scheduled stop cuts the region at its frame
+		auto keep = dsound.framesBeforeStop(bytes / blockSize, delay) * blockSize;
+		if (keep < static_cast<size_t>(bytes)) {
+			bytes = keep;
+			stopReached = true;
+		}
+
+		dsound.processTimedEvents(bytes / blockSize, delay);
+		dsound.setPosition(dsound.getPosition() + bytes);
+		delay += bytes / blockSize;
+		len += bytes;
+	}
 
-	dsound.setPosition(dsound.getPosition() + len);
-	if (len < bufLen)
-		memset((char *)bufAddr+len, dsound.getDecoder().silenceLevel(), bufLen-len);
+	if (pad + len < bufLen)
+		memset((char *)bufAddr+pad+len, dsound.getDecoder().silenceLevel(), bufLen-pad-len);
 
 	pDsb->Unlock(
 		bufAddr,	// Address of lock start.
@@ -189,7 +221,8 @@ bool DirectSoundPlaying::fillBuffer(int offset, size_t size) {
 		NULL,		// No wraparound portion.
 		0);			// No wraparound size.
 
-	return dsound.getPosition() < dsound.getDecoder().getDataSize();
+	return !stopReached && (startPadding > 0 ||
+		(looping ? len > 0 : dsound.getPosition() < dsound.getDecoder().getDataSize()));
 }
 
 class HandleGuard {
@@ -202,10 +235,12 @@ public:
 	~HandleGuard() {
 		CloseHandle(handle);
 		if (status != PlayingStatus::PAUSED) {
-			if (dsound.isLooping() || status == PlayingStatus::RESTARTING) {
+			// a scheduled stop ends a looping sound too
+			if ((dsound.isLooping() && status == PlayingStatus::PLAYING) || status == PlayingStatus::RESTARTING) {
 				dsound.setPosition(0);
 				dsound.setState<DirectSoundPlaying>();
 			} else {
+				dsound.clearSchedule(); // a stop past the end doesn't carry over to the next play()
 				while (!dsound.onStopStackEmpty()) {
 					dsound.popOnStopCallback()();
 				}
@@ -267,6 +302,8 @@ DWORD DirectSoundPlaying::startThread() {
 
 			if (playingStatus == PlayingStatus::PLAYING) {
 				WaitForSingleObject(event, INFINITE);
+				if (stopReached)
+					playingStatus = PlayingStatus::STOPPED;
 			}
 			pDsb->Stop();
 		},
@@ -53,6 +53,9 @@ private:
 	std::unique_ptr<struct IDirectSoundBuffer, decltype(&ReleaseBuffer)> pDsb;
 	std::thread loadBufferThread;
 	std::atomic<PlayingStatus> playingStatus;
+	size_t startPadding = 0; // frames of silence left before a scheduled start
+	bool stopReached = false;
+	bool started = false; // the scheduled start is only read by the first fill
 
 	bool fillBuffer(int offset, size_t size);
 	DWORD startThread();